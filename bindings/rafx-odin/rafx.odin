@@ -49,6 +49,7 @@ BufferUsageFlag :: enum u32 {
 	MicromapBuildInput = 9,
 	TransferSrc = 10,
 	TransferDst = 11,
+	PersistentMap = 12,
 }
 BufferUsageFlags :: bit_set[BufferUsageFlag; u32]
 
@@ -68,6 +69,11 @@ ResourceState :: enum u32 {
 	ScratchBuffer = 12,
 	ResolveSrc = 13,
 	ResolveDst = 14,
+	FragmentRead = 15,
+	GraphicsRead = 16,
+	ComputeRead = 17,
+	ComputeWrite = 18,
+	RaytracingRead = 19,
 }
 
 MemoryType :: enum u32 {
@@ -391,7 +397,7 @@ WindowFlag :: enum u32 {
 	Maximized = 7,
 	Hidden = 8,
 	Centered = 9,
-	ScaleToMonitor = 10,
+	NoScale = 10,
 }
 WindowFlags :: bit_set[WindowFlag; u32]
 
@@ -403,6 +409,13 @@ FeatureSupportFlag :: enum u32 {
 }
 FeatureSupportFlags :: bit_set[FeatureSupportFlag; u32]
 
+Vendor :: enum u32 {
+	Unknown = 0,
+	Nvidia = 1,
+	Amd = 2,
+	Intel = 3,
+}
+
 CursorType :: enum u32 {
 	Default = 0,
 	Arrow = 1,
@@ -410,24 +423,24 @@ CursorType :: enum u32 {
 	Crosshair = 3,
 	Hand = 4,
 	ResizeEw = 5,
-	// ResizeH = 0, // Duplicate
-	// ResizeNs = 1, // Duplicate
-	// ResizeV = 0, // Duplicate
-	// ResizeNwse = 1, // Duplicate
-	// ResizeNesw = 2, // Duplicate
-	// ResizeAll = 3, // Duplicate
-	// NotAllowed = 4, // Duplicate
-	// ResizeNw = 5, // Duplicate
-	ResizeN = 6,
-	ResizeNe = 7,
-	ResizeE = 8,
-	ResizeSe = 9,
-	ResizeS = 10,
-	ResizeSw = 11,
-	ResizeW = 12,
-	Wait = 13,
-	Progress = 14,
-	Count = 15,
+	// ResizeH = 5, // Duplicate
+	ResizeNs = 6,
+	// ResizeV = 6, // Duplicate
+	ResizeNwse = 7,
+	ResizeNesw = 8,
+	ResizeAll = 9,
+	NotAllowed = 10,
+	ResizeNw = 11,
+	ResizeN = 12,
+	ResizeNe = 13,
+	ResizeE = 14,
+	ResizeSe = 15,
+	ResizeS = 16,
+	ResizeSw = 17,
+	ResizeW = 18,
+	Wait = 19,
+	Progress = 20,
+	Count = 21,
 }
 
 Key :: enum u32 {
@@ -524,15 +537,23 @@ Key :: enum u32 {
 // Handles
 AccelerationStructure :: distinct rawptr
 Buffer :: distinct rawptr
+Bundle :: distinct rawptr
 CommandList :: distinct rawptr
+Context :: distinct rawptr
 Denoiser :: distinct rawptr
 Fence :: distinct rawptr
+FrameGraph :: distinct rawptr
+GeometryPool :: distinct rawptr
+GraphPassFunc :: distinct rawptr
 Micromap :: distinct rawptr
 Pipeline :: distinct rawptr
 QueryPool :: distinct rawptr
+RenderQueue :: distinct rawptr
 Sampler :: distinct rawptr
 Shader :: distinct rawptr
 ShaderBindingTable :: distinct rawptr
+ShaderCacheLoadCallback :: distinct rawptr
+ShaderCacheSaveCallback :: distinct rawptr
 Texture :: distinct rawptr
 Upscaler :: distinct rawptr
 
@@ -544,6 +565,23 @@ AccelerationStructureDesc :: struct {
 	geometries: ^GeometryDesc,
 }
 
+AdapterInfo :: struct {
+	name: [256]u8,
+	video_memory_size: u64,
+	shared_system_memory_size: u64,
+	device_id: u32,
+	vendor: Vendor,
+	integrated: bool,
+	features: FeatureSupportFlags,
+}
+
+Allocator :: struct {
+	allocate: ^rawptr,
+	reallocate: ^rawptr,
+	free: ^rawptr,
+	user_arg: rawptr,
+}
+
 AttachmentDesc :: struct {
 	format: Format,
 	blend: BlendState,
@@ -560,6 +598,12 @@ BlendState :: struct {
 	write_mask: ColorWriteMask,
 }
 
+BufferUpdate :: struct {
+	offset: u64,
+	data: rawptr,
+	size: u64,
+}
+
 BuildMicromapDesc :: struct {
 	dst: Micromap,
 	data: Buffer,
@@ -599,6 +643,30 @@ DenoiserSettings :: struct {
 	reset_history: bool,
 }
 
+DrawPacket :: struct {
+	pipeline: Pipeline,
+	vertex_buffer: Buffer,
+	index_buffer: Buffer,
+	index_type: IndexType,
+	vertex_offset: uint,
+	index_offset: uint,
+	count: u32,
+	instance_count: u32,
+	first: u32,
+	base_vertex: i32,
+	first_instance: u32,
+	push_constants: rawptr,
+	push_constants_size: u32,
+	depth: f32,
+	layer: u8,
+	back_to_front: bool,
+}
+
+FrameStats :: struct {
+	elided_state_calls: u32,
+	render_pass_restarts: u32,
+}
+
 GeometryAABBs :: struct {
 	aabb_buffer: Buffer,
 	offset: u64,
@@ -617,6 +685,14 @@ GeometryDesc_Data :: struct #raw_union {
 	aabbs: GeometryAABBs,
 }
 
+GeometryPoolDesc :: struct {
+	vertex_capacity: u32,
+	index_capacity: u32,
+	vertex_stride: u32,
+	index_type: IndexType,
+	max_meshes: u32,
+}
+
 GeometryTriangles :: struct {
 	vertex_buffer: Buffer,
 	vertex_offset: u64,
@@ -677,6 +753,24 @@ LatencyReport :: struct {
 	gpu_render_end_time_us: u64,
 }
 
+MeshDesc :: struct {
+	vertices: rawptr,
+	vertex_count: u32,
+	indices: rawptr,
+	index_count: u32,
+	bounds_center: [3]f32,
+	bounds_radius: f32,
+}
+
+MeshRecord :: struct {
+	vertex_offset: u32,
+	vertex_count: u32,
+	index_offset: u32,
+	index_count: u32,
+	bounds_center: [3]f32,
+	bounds_radius: f32,
+}
+
 MicromapDesc :: struct {
 	usages: ^MicromapUsage,
 	usage_count: u32,
@@ -689,6 +783,12 @@ MicromapUsage :: struct {
 	format: MicromapFormat,
 }
 
+PassResource :: struct {
+	texture: Texture,
+	buffer: Buffer,
+	state: ResourceState,
+}
+
 PipelineDesc :: struct {
 	shader: Shader,
 	color_format: Format,
@@ -766,6 +866,7 @@ TextureDesc :: struct {
 	sample_count: i32,
 	usage: TextureUsageFlags,
 	initial_data: rawptr,
+	subresource_data: rawptr,
 }
 
 TraceRaysDesc :: struct {
@@ -779,6 +880,14 @@ TraceRaysDesc :: struct {
 	callable_count: u32,
 }
 
+TransientAlloc :: struct {
+	cpu: rawptr,
+	buffer: Buffer,
+	buffer_id: u32,
+	offset: u64,
+	device_address: u64,
+}
+
 UpscaleDesc :: struct {
 	input: Texture,
 	output: Texture,
@@ -832,10 +941,24 @@ VertexLayoutElement :: struct {
 // Functions
 @(default_calling_convention="c")
 foreign lib {
+	@(link_name="rfxCreateContext")
+	create_context :: proc() -> Context ---
+	@(link_name="rfxDestroyContext")
+	destroy_context :: proc(context_: Context) ---
+	@(link_name="rfxMakeContextCurrent")
+	make_context_current :: proc(context_: Context) ---
+	@(link_name="rfxGetCurrentContext")
+	get_current_context :: proc() -> Context ---
 	@(link_name="rfxRequestBackend")
 	request_backend :: proc(backend: Backend, enable_validation: bool) ---
 	@(link_name="rfxOpenWindow")
 	open_window :: proc(title: cstring, width: i32, height: i32) -> bool ---
+	@(link_name="rfxInitHeadless")
+	init_headless :: proc(backend: Backend, width: i32, height: i32) -> bool ---
+	@(link_name="rfxEnumerateAdapters")
+	enumerate_adapters :: proc(adapters: ^AdapterInfo, capacity: u32) -> u32 ---
+	@(link_name="rfxSelectAdapter")
+	select_adapter :: proc(index: u32) ---
 	@(link_name="rfxSupportsFeatures")
 	supports_features :: proc(features: FeatureSupportFlags) -> bool ---
 	@(link_name="rfxGetSupportedFeatures")
@@ -844,6 +967,8 @@ foreign lib {
 	set_sample_count :: proc(count: i32) ---
 	@(link_name="rfxSetAnisotropy")
 	set_anisotropy :: proc(level: i32) ---
+	@(link_name="rfxSetFramesInFlight")
+	set_frames_in_flight :: proc(count: i32) ---
 	@(link_name="rfxSetWindowFlags")
 	set_window_flags :: proc(flags: WindowFlags) ---
 	@(link_name="rfxEnableWindowFlags")
@@ -864,6 +989,8 @@ foreign lib {
 	get_window_width :: proc() -> i32 ---
 	@(link_name="rfxGetWindowHeight")
 	get_window_height :: proc() -> i32 ---
+	@(link_name="rfxGetWindowScale")
+	get_window_scale :: proc() -> f32 ---
 	@(link_name="rfxGetTime")
 	get_time :: proc() -> f64 ---
 	@(link_name="rfxGetDeltaTime")
@@ -890,16 +1017,30 @@ foreign lib {
 	set_mouse_cursor_visible :: proc(visible: bool) ---
 	@(link_name="rfxSetMouseCursor")
 	set_mouse_cursor :: proc(cursor: CursorType) ---
+	@(link_name="rfxGetKeyPressed")
+	get_key_pressed :: proc() -> i32 ---
+	@(link_name="rfxGetCharPressed")
+	get_char_pressed :: proc() -> u32 ---
 	@(link_name="rfxCreateBuffer")
 	create_buffer :: proc(size: uint, stride: uint, usage: BufferUsageFlags, mem_type: MemoryType, initial_data: rawptr) -> Buffer ---
 	@(link_name="rfxDestroyBuffer")
 	destroy_buffer :: proc(buffer: Buffer) ---
 	@(link_name="rfxMapBuffer")
 	map_buffer :: proc(buffer: Buffer) -> rawptr ---
+	@(link_name="rfxMapBufferRange")
+	map_buffer_range :: proc(buffer: Buffer, offset: u64, size: u64) -> rawptr ---
 	@(link_name="rfxUnmapBuffer")
 	unmap_buffer :: proc(buffer: Buffer) ---
+	@(link_name="rfxFlushBufferRange")
+	flush_buffer_range :: proc(buffer: Buffer, offset: u64, size: u64) ---
+	@(link_name="rfxInvalidateBufferRange")
+	invalidate_buffer_range :: proc(buffer: Buffer, offset: u64, size: u64) ---
 	@(link_name="rfxGetBufferId")
 	get_buffer_id :: proc(buffer: Buffer) -> u32 ---
+	@(link_name="rfxGetBufferDeviceAddress")
+	get_buffer_device_address :: proc(buffer: Buffer) -> u64 ---
+	@(link_name="rfxAllocTransient")
+	alloc_transient :: proc(size: u64, alignment: u64) -> TransientAlloc ---
 	@(link_name="rfxCreateTexture")
 	create_texture :: proc(width: i32, height: i32, format: Format, sample_count: i32, usage: TextureUsageFlags, initial_data: rawptr) -> Texture ---
 	@(link_name="rfxCreateTextureEx")
@@ -916,6 +1057,10 @@ foreign lib {
 	get_swap_chain_format :: proc() -> Format ---
 	@(link_name="rfxGetBackbufferTexture")
 	get_backbuffer_texture :: proc() -> Texture ---
+	@(link_name="rfxLoadTexture")
+	load_texture :: proc(path: cstring, usage: TextureUsageFlags) -> Texture ---
+	@(link_name="rfxLoadTextureMem")
+	load_texture_mem :: proc(data: rawptr, size: uint, usage: TextureUsageFlags) -> Texture ---
 	@(link_name="rfxCreateSampler")
 	create_sampler :: proc(filter: Filter, address_mode: AddressMode) -> Sampler ---
 	@(link_name="rfxDestroySampler")
@@ -928,6 +1073,20 @@ foreign lib {
 	destroy_shader :: proc(shader: Shader) ---
 	@(link_name="rfxWatchShader")
 	watch_shader :: proc(shader: Shader, watch: bool) ---
+	@(link_name="rfxSetShaderCacheEnabled")
+	set_shader_cache_enabled :: proc(enabled: bool) ---
+	@(link_name="rfxSetShaderCachePath")
+	set_shader_cache_path :: proc(path: cstring) ---
+	@(link_name="rfxSetShaderCacheCallbacks")
+	set_shader_cache_callbacks :: proc(load: ShaderCacheLoadCallback, save: ShaderCacheSaveCallback, user: rawptr) ---
+	@(link_name="rfxWasShaderCached")
+	was_shader_cached :: proc(shader: Shader) -> bool ---
+	@(link_name="rfxAddVirtualShaderFile")
+	add_virtual_shader_file :: proc(filename: cstring, content: cstring) ---
+	@(link_name="rfxRemoveVirtualShaderFile")
+	remove_virtual_shader_file :: proc(filename: cstring) ---
+	@(link_name="rfxPrecompileShader")
+	precompile_shader :: proc(source_or_path: cstring, defines: cstring, num_defines: i32, include_dirs: cstring, num_include_dirs: i32, from_memory: bool) ---
 	@(link_name="rfxCreatePipeline")
 	create_pipeline :: proc(desc: ^PipelineDesc) -> Pipeline ---
 	@(link_name="rfxDestroyPipeline")
@@ -950,6 +1109,22 @@ foreign lib {
 	begin_command_list :: proc(cmd: CommandList) ---
 	@(link_name="rfxEndCommandList")
 	end_command_list :: proc(cmd: CommandList) ---
+	@(link_name="rfxSetCommandListDeferred")
+	set_command_list_deferred :: proc(cmd: CommandList, deferred: bool) ---
+	@(link_name="rfxSetCommandListBarrierHoisting")
+	set_command_list_barrier_hoisting :: proc(cmd: CommandList, enabled: bool) ---
+	@(link_name="rfxCreateBundle")
+	create_bundle :: proc() -> Bundle ---
+	@(link_name="rfxDestroyBundle")
+	destroy_bundle :: proc(bundle: Bundle) ---
+	@(link_name="rfxBeginBundle")
+	begin_bundle :: proc(bundle: Bundle) -> CommandList ---
+	@(link_name="rfxEndBundle")
+	end_bundle :: proc(bundle: Bundle) ---
+	@(link_name="rfxCmdExecuteBundle")
+	cmd_execute_bundle :: proc(cmd: CommandList, bundle: Bundle) ---
+	@(link_name="rfxQueueCommandList")
+	queue_command_list :: proc(cmd: CommandList) ---
 	@(link_name="rfxBeginFrame")
 	begin_frame :: proc() ---
 	@(link_name="rfxEndFrame")
@@ -968,6 +1143,10 @@ foreign lib {
 	cmd_begin_swapchain_render_pass :: proc(cmd: CommandList, depth_stencil_format: Format, clear_color: Color) ---
 	@(link_name="rfxCmdBeginRenderPass")
 	cmd_begin_render_pass :: proc(cmd: CommandList, colors: ^Texture, color_count: u32, depth: Texture, clear_color: Color, view_mask: u32) ---
+	@(link_name="rfxCmdBeginSwapchainRenderPassEx")
+	cmd_begin_swapchain_render_pass_ex :: proc(cmd: CommandList, depth_stencil_format: Format, clear_color: Color, resources: ^PassResource, resource_count: u32) ---
+	@(link_name="rfxCmdBeginRenderPassEx")
+	cmd_begin_render_pass_ex :: proc(cmd: CommandList, colors: ^Texture, color_count: u32, depth: Texture, clear_color: Color, view_mask: u32, resources: ^PassResource, resource_count: u32) ---
 	@(link_name="rfxCmdEndRenderPass")
 	cmd_end_render_pass :: proc(cmd: CommandList) ---
 	@(link_name="rfxCmdClear")
@@ -994,12 +1173,20 @@ foreign lib {
 	cmd_bind_vertex_buffer :: proc(cmd: CommandList, buffer: Buffer) ---
 	@(link_name="rfxCmdBindIndexBuffer")
 	cmd_bind_index_buffer :: proc(cmd: CommandList, buffer: Buffer, index_type: IndexType) ---
+	@(link_name="rfxCmdBindVertexBufferEx")
+	cmd_bind_vertex_buffer_ex :: proc(cmd: CommandList, buffer: Buffer, offset: uint) ---
+	@(link_name="rfxCmdBindIndexBufferEx")
+	cmd_bind_index_buffer_ex :: proc(cmd: CommandList, buffer: Buffer, offset: uint, index_type: IndexType) ---
 	@(link_name="rfxCmdPushConstants")
 	cmd_push_constants :: proc(cmd: CommandList, data: rawptr, size: uint) ---
 	@(link_name="rfxCmdDraw")
 	cmd_draw :: proc(cmd: CommandList, vertex_count: u32, instance_count: u32) ---
 	@(link_name="rfxCmdDrawIndexed")
 	cmd_draw_indexed :: proc(cmd: CommandList, index_count: u32, instance_count: u32) ---
+	@(link_name="rfxCmdDrawEx")
+	cmd_draw_ex :: proc(cmd: CommandList, vertex_count: u32, instance_count: u32, first_vertex: u32, first_instance: u32) ---
+	@(link_name="rfxCmdDrawIndexedEx")
+	cmd_draw_indexed_ex :: proc(cmd: CommandList, index_count: u32, instance_count: u32, first_index: u32, base_vertex: i32, first_instance: u32) ---
 	@(link_name="rfxCmdDispatch")
 	cmd_dispatch :: proc(cmd: CommandList, x: u32, y: u32, z: u32) ---
 	@(link_name="rfxCmdDrawIndirect")
@@ -1018,12 +1205,72 @@ foreign lib {
 	cmd_draw_indexed_indirect_count :: proc(cmd: CommandList, buffer: Buffer, offset: uint, count_buffer: Buffer, count_buffer_offset: uint, max_draw_count: u32, stride: u32) ---
 	@(link_name="rfxCmdDrawMeshTasksIndirectCount")
 	cmd_draw_mesh_tasks_indirect_count :: proc(cmd: CommandList, buffer: Buffer, offset: uint, count_buffer: Buffer, count_buffer_offset: uint, max_draw_count: u32, stride: u32) ---
+	@(link_name="rfxCreateRenderQueue")
+	create_render_queue :: proc() -> RenderQueue ---
+	@(link_name="rfxDestroyRenderQueue")
+	destroy_render_queue :: proc(queue: RenderQueue) ---
+	@(link_name="rfxResetRenderQueue")
+	reset_render_queue :: proc(queue: RenderQueue) ---
+	@(link_name="rfxAddDrawPacket")
+	add_draw_packet :: proc(queue: RenderQueue, packet: ^DrawPacket) ---
+	@(link_name="rfxCmdDrawRenderQueue")
+	cmd_draw_render_queue :: proc(cmd: CommandList, queue: RenderQueue) ---
+	@(link_name="rfxCreateGeometryPool")
+	create_geometry_pool :: proc(desc: ^GeometryPoolDesc) -> GeometryPool ---
+	@(link_name="rfxDestroyGeometryPool")
+	destroy_geometry_pool :: proc(pool: GeometryPool) ---
+	@(link_name="rfxAllocMesh")
+	alloc_mesh :: proc(pool: GeometryPool, desc: ^MeshDesc) -> u32 ---
+	@(link_name="rfxFreeMesh")
+	free_mesh :: proc(pool: GeometryPool, mesh: u32) ---
+	@(link_name="rfxGetMeshRecord")
+	get_mesh_record :: proc(pool: GeometryPool, mesh: u32) -> MeshRecord ---
+	@(link_name="rfxGetGeometryPoolVertexBuffer")
+	get_geometry_pool_vertex_buffer :: proc(pool: GeometryPool) -> Buffer ---
+	@(link_name="rfxGetGeometryPoolIndexBuffer")
+	get_geometry_pool_index_buffer :: proc(pool: GeometryPool) -> Buffer ---
+	@(link_name="rfxGetGeometryPoolMeshTable")
+	get_geometry_pool_mesh_table :: proc(pool: GeometryPool) -> Buffer ---
+	@(link_name="rfxCmdDrawMesh")
+	cmd_draw_mesh :: proc(cmd: CommandList, pool: GeometryPool, mesh: u32, instance_count: u32) ---
+	@(link_name="rfxCreateFrameGraph")
+	create_frame_graph :: proc() -> FrameGraph ---
+	@(link_name="rfxDestroyFrameGraph")
+	destroy_frame_graph :: proc(graph: FrameGraph) ---
+	@(link_name="rfxResetFrameGraph")
+	reset_frame_graph :: proc(graph: FrameGraph) ---
+	@(link_name="rfxGraphImportTexture")
+	graph_import_texture :: proc(graph: FrameGraph, texture: Texture) -> u32 ---
+	@(link_name="rfxGraphImportBuffer")
+	graph_import_buffer :: proc(graph: FrameGraph, buffer: Buffer) -> u32 ---
+	@(link_name="rfxGraphCreateTexture")
+	graph_create_texture :: proc(graph: FrameGraph, desc: ^TextureDesc) -> u32 ---
+	@(link_name="rfxGraphCreateBuffer")
+	graph_create_buffer :: proc(graph: FrameGraph, size: uint, stride: uint, usage: BufferUsageFlags) -> u32 ---
+	@(link_name="rfxGraphAddPass")
+	graph_add_pass :: proc(graph: FrameGraph, name: cstring, func: GraphPassFunc, user_data: rawptr) -> u32 ---
+	@(link_name="rfxGraphRead")
+	graph_read :: proc(graph: FrameGraph, pass: u32, resource: u32, state: ResourceState) ---
+	@(link_name="rfxGraphWrite")
+	graph_write :: proc(graph: FrameGraph, pass: u32, resource: u32, state: ResourceState) ---
+	@(link_name="rfxGraphGetTexture")
+	graph_get_texture :: proc(graph: FrameGraph, resource: u32) -> Texture ---
+	@(link_name="rfxGraphGetBuffer")
+	graph_get_buffer :: proc(graph: FrameGraph, resource: u32) -> Buffer ---
+	@(link_name="rfxCmdExecuteFrameGraph")
+	cmd_execute_frame_graph :: proc(cmd: CommandList, graph: FrameGraph) ---
 	@(link_name="rfxCmdCopyBuffer")
 	cmd_copy_buffer :: proc(cmd: CommandList, src: Buffer, src_offset: uint, dst: Buffer, dst_offset: uint, size: uint) ---
 	@(link_name="rfxCmdCopyTexture")
 	cmd_copy_texture :: proc(cmd: CommandList, src: Texture, dst: Texture) ---
 	@(link_name="rfxCmdUploadTexture")
 	cmd_upload_texture :: proc(cmd: CommandList, dst: Texture, data: rawptr, mip: u32, layer: u32) ---
+	@(link_name="rfxCmdGenerateMips")
+	cmd_generate_mips :: proc(cmd: CommandList, texture: Texture) ---
+	@(link_name="rfxCmdUpdateBuffer")
+	cmd_update_buffer :: proc(cmd: CommandList, buffer: Buffer, offset: u64, data: rawptr, size: u64) ---
+	@(link_name="rfxCmdUpdateBufferScatter")
+	cmd_update_buffer_scatter :: proc(cmd: CommandList, buffer: Buffer, updates: ^BufferUpdate, update_count: u32) ---
 	@(link_name="rfxCmdReadbackTextureToBuffer")
 	cmd_readback_texture_to_buffer :: proc(cmd: CommandList, src: Texture, dst: Buffer, dst_offset: u64) ---
 	@(link_name="rfxCmdZeroBuffer")
@@ -1038,6 +1285,16 @@ foreign lib {
 	cmd_copy_micromap :: proc(cmd: CommandList, dst: Micromap, src: Micromap, mode: CopyMode) ---
 	@(link_name="rfxCmdCopyAccelerationStructure")
 	cmd_copy_acceleration_structure :: proc(cmd: CommandList, dst: AccelerationStructure, src: AccelerationStructure, mode: CopyMode) ---
+	@(link_name="rfxUploadBuffer")
+	upload_buffer :: proc(dst: Buffer, dst_offset: u64, data: rawptr, size: u64) ---
+	@(link_name="rfxUploadTexture")
+	upload_texture :: proc(dst: Texture, data: rawptr, mip: u32, layer: u32) ---
+	@(link_name="rfxSubmitUploads")
+	submit_uploads :: proc() -> u64 ---
+	@(link_name="rfxIsUploadComplete")
+	is_upload_complete :: proc(value: u64) -> bool ---
+	@(link_name="rfxGetUploadFence")
+	get_upload_fence :: proc() -> Fence ---
 	@(link_name="rfxCmdTransitionBuffer")
 	cmd_transition_buffer :: proc(cmd: CommandList, buffer: Buffer, state: ResourceState) ---
 	@(link_name="rfxCmdTransitionTexture")
@@ -1060,6 +1317,8 @@ foreign lib {
 	cmd_end_profile :: proc(cmd: CommandList) ---
 	@(link_name="rfxGetGpuTimestamps")
 	get_gpu_timestamps :: proc(out_timestamps: ^GpuTimestamp, max_count: u32) -> u32 ---
+	@(link_name="rfxGetFrameStats")
+	get_frame_stats :: proc(out_stats: ^FrameStats) ---
 	@(link_name="rfxCreateQueryPool")
 	create_query_pool :: proc(type_: QueryType, capacity: u32) -> QueryPool ---
 	@(link_name="rfxDestroyQueryPool")
@@ -1134,4 +1393,6 @@ foreign lib {
 	get_upscaler_props :: proc(upscaler: Upscaler, out_props: ^UpscalerProps) ---
 	@(link_name="rfxCmdUpscale")
 	cmd_upscale :: proc(cmd: CommandList, upscaler: Upscaler, desc: ^UpscaleDesc) ---
+	@(link_name="rfxSetAllocator")
+	set_allocator :: proc(allocator: ^Allocator) ---
 }
\ No newline at end of file
@@ -53,6 +53,7 @@ pub mod sys {
     pub const RFX_USAGE_MICROMAP_BUILD_INPUT: RfxBufferUsageFlags = 512;
     pub const RFX_USAGE_TRANSFER_SRC: RfxBufferUsageFlags = 1024;
     pub const RFX_USAGE_TRANSFER_DST: RfxBufferUsageFlags = 2048;
+    pub const RFX_USAGE_PERSISTENT_MAP: RfxBufferUsageFlags = 4096;
     pub const RFX_STATE_UNDEFINED: u32 = 0;
     pub const RFX_STATE_PRESENT: u32 = 1;
     pub const RFX_STATE_COPY_SRC: u32 = 2;
@@ -68,6 +69,11 @@ pub mod sys {
     pub const RFX_STATE_SCRATCH_BUFFER: u32 = 12;
     pub const RFX_STATE_RESOLVE_SRC: u32 = 13;
     pub const RFX_STATE_RESOLVE_DST: u32 = 14;
+    pub const RFX_STATE_FRAGMENT_READ: u32 = 15;
+    pub const RFX_STATE_GRAPHICS_READ: u32 = 16;
+    pub const RFX_STATE_COMPUTE_READ: u32 = 17;
+    pub const RFX_STATE_COMPUTE_WRITE: u32 = 18;
+    pub const RFX_STATE_RAYTRACING_READ: u32 = 19;
     pub type RfxResourceState = u32;
     pub const RFX_STATE_UNDEFINED: RfxResourceState = 0;
     pub const RFX_STATE_PRESENT: RfxResourceState = 1;
@@ -84,6 +90,11 @@ pub mod sys {
     pub const RFX_STATE_SCRATCH_BUFFER: RfxResourceState = 12;
     pub const RFX_STATE_RESOLVE_SRC: RfxResourceState = 13;
     pub const RFX_STATE_RESOLVE_DST: RfxResourceState = 14;
+    pub const RFX_STATE_FRAGMENT_READ: RfxResourceState = 15;
+    pub const RFX_STATE_GRAPHICS_READ: RfxResourceState = 16;
+    pub const RFX_STATE_COMPUTE_READ: RfxResourceState = 17;
+    pub const RFX_STATE_COMPUTE_WRITE: RfxResourceState = 18;
+    pub const RFX_STATE_RAYTRACING_READ: RfxResourceState = 19;
     pub const RFX_MEM_GPU_ONLY: u32 = 0;
     pub const RFX_MEM_CPU_TO_GPU: u32 = 1;
     pub const RFX_MEM_GPU_TO_CPU: u32 = 2;
@@ -507,36 +518,45 @@ pub mod sys {
     pub const RFX_WINDOW_MAXIMIZED: RfxWindowFlags = 128;
     pub const RFX_WINDOW_HIDDEN: RfxWindowFlags = 256;
     pub const RFX_WINDOW_CENTERED: RfxWindowFlags = 512;
-    pub const RFX_WINDOW_SCALE_TO_MONITOR: RfxWindowFlags = 1024;
+    pub const RFX_WINDOW_NO_SCALE: RfxWindowFlags = 1024;
     pub type RfxFeatureSupportFlags = u32;
     pub const RFX_FEATURE_MESH_SHADER: RfxFeatureSupportFlags = 1;
     pub const RFX_FEATURE_RAY_TRACING: RfxFeatureSupportFlags = 2;
     pub const RFX_FEATURE_UPSCALE: RfxFeatureSupportFlags = 4;
     pub const RFX_FEATURE_LOW_LATENCY: RfxFeatureSupportFlags = 8;
+    pub const RFX_VENDOR_UNKNOWN: u32 = 0;
+    pub const RFX_VENDOR_NVIDIA: u32 = 1;
+    pub const RFX_VENDOR_AMD: u32 = 2;
+    pub const RFX_VENDOR_INTEL: u32 = 3;
+    pub type RfxVendor = u32;
+    pub const RFX_VENDOR_UNKNOWN: RfxVendor = 0;
+    pub const RFX_VENDOR_NVIDIA: RfxVendor = 1;
+    pub const RFX_VENDOR_AMD: RfxVendor = 2;
+    pub const RFX_VENDOR_INTEL: RfxVendor = 3;
     pub const RFX_CURSOR_DEFAULT: u32 = 0;
     pub const RFX_CURSOR_ARROW: u32 = 1;
     pub const RFX_CURSOR_IBEAM: u32 = 2;
     pub const RFX_CURSOR_CROSSHAIR: u32 = 3;
     pub const RFX_CURSOR_HAND: u32 = 4;
     pub const RFX_CURSOR_RESIZE_EW: u32 = 5;
-    pub const RFX_CURSOR_RESIZE_H: u32 = 0;
-    pub const RFX_CURSOR_RESIZE_NS: u32 = 1;
-    pub const RFX_CURSOR_RESIZE_V: u32 = 0;
-    pub const RFX_CURSOR_RESIZE_NWSE: u32 = 1;
-    pub const RFX_CURSOR_RESIZE_NESW: u32 = 2;
-    pub const RFX_CURSOR_RESIZE_ALL: u32 = 3;
-    pub const RFX_CURSOR_NOT_ALLOWED: u32 = 4;
-    pub const RFX_CURSOR_RESIZE_NW: u32 = 5;
-    pub const RFX_CURSOR_RESIZE_N: u32 = 6;
-    pub const RFX_CURSOR_RESIZE_NE: u32 = 7;
-    pub const RFX_CURSOR_RESIZE_E: u32 = 8;
-    pub const RFX_CURSOR_RESIZE_SE: u32 = 9;
-    pub const RFX_CURSOR_RESIZE_S: u32 = 10;
-    pub const RFX_CURSOR_RESIZE_SW: u32 = 11;
-    pub const RFX_CURSOR_RESIZE_W: u32 = 12;
-    pub const RFX_CURSOR_WAIT: u32 = 13;
-    pub const RFX_CURSOR_PROGRESS: u32 = 14;
-    pub const RFX_CURSOR_COUNT: u32 = 15;
+    pub const RFX_CURSOR_RESIZE_H: u32 = 5;
+    pub const RFX_CURSOR_RESIZE_NS: u32 = 6;
+    pub const RFX_CURSOR_RESIZE_V: u32 = 6;
+    pub const RFX_CURSOR_RESIZE_NWSE: u32 = 7;
+    pub const RFX_CURSOR_RESIZE_NESW: u32 = 8;
+    pub const RFX_CURSOR_RESIZE_ALL: u32 = 9;
+    pub const RFX_CURSOR_NOT_ALLOWED: u32 = 10;
+    pub const RFX_CURSOR_RESIZE_NW: u32 = 11;
+    pub const RFX_CURSOR_RESIZE_N: u32 = 12;
+    pub const RFX_CURSOR_RESIZE_NE: u32 = 13;
+    pub const RFX_CURSOR_RESIZE_E: u32 = 14;
+    pub const RFX_CURSOR_RESIZE_SE: u32 = 15;
+    pub const RFX_CURSOR_RESIZE_S: u32 = 16;
+    pub const RFX_CURSOR_RESIZE_SW: u32 = 17;
+    pub const RFX_CURSOR_RESIZE_W: u32 = 18;
+    pub const RFX_CURSOR_WAIT: u32 = 19;
+    pub const RFX_CURSOR_PROGRESS: u32 = 20;
+    pub const RFX_CURSOR_COUNT: u32 = 21;
     pub type RfxCursorType = u32;
     pub const RFX_CURSOR_DEFAULT: RfxCursorType = 0;
     pub const RFX_CURSOR_ARROW: RfxCursorType = 1;
@@ -544,24 +564,24 @@ pub mod sys {
     pub const RFX_CURSOR_CROSSHAIR: RfxCursorType = 3;
     pub const RFX_CURSOR_HAND: RfxCursorType = 4;
     pub const RFX_CURSOR_RESIZE_EW: RfxCursorType = 5;
-    pub const RFX_CURSOR_RESIZE_H: RfxCursorType = 0;
-    pub const RFX_CURSOR_RESIZE_NS: RfxCursorType = 1;
-    pub const RFX_CURSOR_RESIZE_V: RfxCursorType = 0;
-    pub const RFX_CURSOR_RESIZE_NWSE: RfxCursorType = 1;
-    pub const RFX_CURSOR_RESIZE_NESW: RfxCursorType = 2;
-    pub const RFX_CURSOR_RESIZE_ALL: RfxCursorType = 3;
-    pub const RFX_CURSOR_NOT_ALLOWED: RfxCursorType = 4;
-    pub const RFX_CURSOR_RESIZE_NW: RfxCursorType = 5;
-    pub const RFX_CURSOR_RESIZE_N: RfxCursorType = 6;
-    pub const RFX_CURSOR_RESIZE_NE: RfxCursorType = 7;
-    pub const RFX_CURSOR_RESIZE_E: RfxCursorType = 8;
-    pub const RFX_CURSOR_RESIZE_SE: RfxCursorType = 9;
-    pub const RFX_CURSOR_RESIZE_S: RfxCursorType = 10;
-    pub const RFX_CURSOR_RESIZE_SW: RfxCursorType = 11;
-    pub const RFX_CURSOR_RESIZE_W: RfxCursorType = 12;
-    pub const RFX_CURSOR_WAIT: RfxCursorType = 13;
-    pub const RFX_CURSOR_PROGRESS: RfxCursorType = 14;
-    pub const RFX_CURSOR_COUNT: RfxCursorType = 15;
+    pub const RFX_CURSOR_RESIZE_H: RfxCursorType = 5;
+    pub const RFX_CURSOR_RESIZE_NS: RfxCursorType = 6;
+    pub const RFX_CURSOR_RESIZE_V: RfxCursorType = 6;
+    pub const RFX_CURSOR_RESIZE_NWSE: RfxCursorType = 7;
+    pub const RFX_CURSOR_RESIZE_NESW: RfxCursorType = 8;
+    pub const RFX_CURSOR_RESIZE_ALL: RfxCursorType = 9;
+    pub const RFX_CURSOR_NOT_ALLOWED: RfxCursorType = 10;
+    pub const RFX_CURSOR_RESIZE_NW: RfxCursorType = 11;
+    pub const RFX_CURSOR_RESIZE_N: RfxCursorType = 12;
+    pub const RFX_CURSOR_RESIZE_NE: RfxCursorType = 13;
+    pub const RFX_CURSOR_RESIZE_E: RfxCursorType = 14;
+    pub const RFX_CURSOR_RESIZE_SE: RfxCursorType = 15;
+    pub const RFX_CURSOR_RESIZE_S: RfxCursorType = 16;
+    pub const RFX_CURSOR_RESIZE_SW: RfxCursorType = 17;
+    pub const RFX_CURSOR_RESIZE_W: RfxCursorType = 18;
+    pub const RFX_CURSOR_WAIT: RfxCursorType = 19;
+    pub const RFX_CURSOR_PROGRESS: RfxCursorType = 20;
+    pub const RFX_CURSOR_COUNT: RfxCursorType = 21;
     pub const RFX_KEY_SPACE: u32 = 32;
     pub const RFX_KEY_APOSTROPHE: u32 = 39;
     pub const RFX_KEY_COMMA: u32 = 44;
@@ -741,6 +761,14 @@ pub mod sys {
     pub const RFX_KEY_MENU: RfxKey = 348;
     #[repr(C)]
     #[derive(Debug, Copy, Clone)]
+    pub struct RfxAllocator {
+        pub allocate: *mut c_void,
+        pub reallocate: *mut c_void,
+        pub free: *mut c_void,
+        pub userArg: *mut c_void,
+    }
+    #[repr(C)]
+    #[derive(Debug, Copy, Clone)]
     pub struct RfxColor {
         pub r: f32,
         pub g: f32,
@@ -813,6 +841,31 @@ pub mod sys {
         _unused: [u8; 0],
     }
     #[repr(C)]
+    #[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
+    pub struct RfxContextImpl {
+        _unused: [u8; 0],
+    }
+    #[repr(C)]
+    #[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
+    pub struct RfxRenderQueueImpl {
+        _unused: [u8; 0],
+    }
+    #[repr(C)]
+    #[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
+    pub struct RfxGeometryPoolImpl {
+        _unused: [u8; 0],
+    }
+    #[repr(C)]
+    #[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
+    pub struct RfxBundleImpl {
+        _unused: [u8; 0],
+    }
+    #[repr(C)]
+    #[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
+    pub struct RfxFrameGraphImpl {
+        _unused: [u8; 0],
+    }
+    #[repr(C)]
     #[derive(Debug, Copy, Clone)]
     pub struct RfxBlendState {
         pub blendEnabled: bool,
@@ -917,6 +970,12 @@ pub mod sys {
     }
     #[repr(C)]
     #[derive(Debug, Copy, Clone)]
+    pub struct RfxFrameStats {
+        pub elidedStateCalls: u32,
+        pub renderPassRestarts: u32,
+    }
+    #[repr(C)]
+    #[derive(Debug, Copy, Clone)]
     pub struct RfxGeometryTriangles {
         pub vertexBuffer: RfxBuffer,
         pub vertexOffset: u64,
@@ -1018,6 +1077,7 @@ pub mod sys {
         pub sampleCount: i32,
         pub usage: RfxTextureUsageFlags,
         pub initialData: *const c_void,
+        pub subresourceData: *const c_void,
     }
     #[repr(C)]
     #[derive(Debug, Copy, Clone)]
@@ -1115,6 +1175,89 @@ pub mod sys {
     }
     #[repr(C)]
     #[derive(Debug, Copy, Clone)]
+    pub struct RfxAdapterInfo {
+        pub name: [c_char; 256],
+        pub videoMemorySize: u64,
+        pub sharedSystemMemorySize: u64,
+        pub deviceId: u32,
+        pub vendor: RfxVendor,
+        pub integrated: bool,
+        pub features: RfxFeatureSupportFlags,
+    }
+    #[repr(C)]
+    #[derive(Debug, Copy, Clone)]
+    pub struct RfxTransientAlloc {
+        pub cpu: *mut c_void,
+        pub buffer: RfxBuffer,
+        pub bufferId: u32,
+        pub offset: u64,
+        pub deviceAddress: u64,
+    }
+    #[repr(C)]
+    #[derive(Debug, Copy, Clone)]
+    pub struct RfxPassResource {
+        pub texture: RfxTexture,
+        pub buffer: RfxBuffer,
+        pub state: RfxResourceState,
+    }
+    #[repr(C)]
+    #[derive(Debug, Copy, Clone)]
+    pub struct RfxDrawPacket {
+        pub pipeline: RfxPipeline,
+        pub vertexBuffer: RfxBuffer,
+        pub indexBuffer: RfxBuffer,
+        pub indexType: RfxIndexType,
+        pub vertexOffset: usize,
+        pub indexOffset: usize,
+        pub count: u32,
+        pub instanceCount: u32,
+        pub first: u32,
+        pub baseVertex: i32,
+        pub firstInstance: u32,
+        pub pushConstants: *const c_void,
+        pub pushConstantsSize: u32,
+        pub depth: f32,
+        pub layer: u8,
+        pub backToFront: bool,
+    }
+    #[repr(C)]
+    #[derive(Debug, Copy, Clone)]
+    pub struct RfxGeometryPoolDesc {
+        pub vertexCapacity: u32,
+        pub indexCapacity: u32,
+        pub vertexStride: u32,
+        pub indexType: RfxIndexType,
+        pub maxMeshes: u32,
+    }
+    #[repr(C)]
+    #[derive(Debug, Copy, Clone)]
+    pub struct RfxMeshRecord {
+        pub vertexOffset: u32,
+        pub vertexCount: u32,
+        pub indexOffset: u32,
+        pub indexCount: u32,
+        pub boundsCenter: [f32; 3],
+        pub boundsRadius: f32,
+    }
+    #[repr(C)]
+    #[derive(Debug, Copy, Clone)]
+    pub struct RfxMeshDesc {
+        pub vertices: *const c_void,
+        pub vertexCount: u32,
+        pub indices: *const c_void,
+        pub indexCount: u32,
+        pub boundsCenter: [f32; 3],
+        pub boundsRadius: f32,
+    }
+    #[repr(C)]
+    #[derive(Debug, Copy, Clone)]
+    pub struct RfxBufferUpdate {
+        pub offset: u64,
+        pub data: *const c_void,
+        pub size: u64,
+    }
+    #[repr(C)]
+    #[derive(Debug, Copy, Clone)]
     pub struct RfxImGuiDrawData {
         pub drawLists: *const c_void,
         pub drawListCount: u32,
@@ -1125,25 +1268,8 @@ pub mod sys {
         pub hdrScale: f32,
         pub linearColor: bool,
     }
-    pub type __vcrt_bool = bool;
-    pub type int_least8_t = i8;
-    pub type int_least16_t = i16;
-    pub type int_least32_t = i32;
-    pub type int_least64_t = i64;
-    pub type uint_least8_t = u8;
-    pub type uint_least16_t = u16;
-    pub type uint_least32_t = u32;
-    pub type uint_least64_t = u64;
-    pub type int_fast8_t = i8;
-    pub type int_fast16_t = i32;
-    pub type int_fast32_t = i32;
-    pub type int_fast64_t = i64;
-    pub type uint_fast8_t = u8;
-    pub type uint_fast16_t = u32;
-    pub type uint_fast32_t = u32;
-    pub type uint_fast64_t = u64;
-    pub type intmax_t = i64;
-    pub type uintmax_t = u64;
+    pub type RfxShaderCacheLoadCallback = *mut c_void;
+    pub type RfxShaderCacheSaveCallback = *const c_void;
     pub type RfxBuffer = *mut RfxBufferImpl;
     pub type RfxTexture = *mut RfxTextureImpl;
     pub type RfxShader = *mut RfxShaderImpl;
@@ -1157,6 +1283,11 @@ pub mod sys {
     pub type RfxUpscaler = *mut RfxUpscalerImpl;
     pub type RfxFence = *mut RfxFenceImpl;
     pub type RfxQueryPool = *mut RfxQueryPoolImpl;
+    pub type RfxContext = *mut RfxContextImpl;
+    pub type RfxRenderQueue = *mut RfxRenderQueueImpl;
+    pub type RfxGeometryPool = *mut RfxGeometryPoolImpl;
+    pub type RfxBundle = *mut RfxBundleImpl;
+    pub type RfxFrameGraph = *mut RfxFrameGraphImpl;
     pub type RfxBufferUsageFlags = u32;
     pub type RfxColorWriteMask = u8;
     pub type RfxUpscaleDispatchFlags = u32;
@@ -1170,14 +1301,23 @@ pub mod sys {
     pub type RfxMouseButton = u8;
     pub type RfxWindowFlags = u32;
     pub type RfxFeatureSupportFlags = u32;
+    pub type RfxGraphPassFunc = *mut c_void;
 
     unsafe extern "C" {
+        pub fn rfxCreateContext() -> RfxContext;
+        pub fn rfxDestroyContext(context: RfxContext);
+        pub fn rfxMakeContextCurrent(context: RfxContext);
+        pub fn rfxGetCurrentContext() -> RfxContext;
         pub fn rfxRequestBackend(backend: RfxBackend, enableValidation: bool);
         pub fn rfxOpenWindow(title: *const c_char, width: i32, height: i32) -> bool;
+        pub fn rfxInitHeadless(backend: RfxBackend, width: i32, height: i32) -> bool;
+        pub fn rfxEnumerateAdapters(adapters: *mut RfxAdapterInfo, capacity: u32) -> u32;
+        pub fn rfxSelectAdapter(index: u32);
         pub fn rfxSupportsFeatures(features: RfxFeatureSupportFlags) -> bool;
         pub fn rfxGetSupportedFeatures() -> RfxFeatureSupportFlags;
         pub fn rfxSetSampleCount(count: i32);
         pub fn rfxSetAnisotropy(level: i32);
+        pub fn rfxSetFramesInFlight(count: i32);
         pub fn rfxSetWindowFlags(flags: RfxWindowFlags);
         pub fn rfxEnableWindowFlags(flags: RfxWindowFlags);
         pub fn rfxDisableWindowFlags(flags: RfxWindowFlags);
@@ -1188,6 +1328,7 @@ pub mod sys {
         pub fn rfxGetWindowSize(width: *mut i32, height: *mut i32);
         pub fn rfxGetWindowWidth() -> i32;
         pub fn rfxGetWindowHeight() -> i32;
+        pub fn rfxGetWindowScale() -> f32;
         pub fn rfxGetTime() -> f64;
         pub fn rfxGetDeltaTime() -> f32;
         pub fn rfxGetFrameIndex() -> u32;
@@ -1201,6 +1342,8 @@ pub mod sys {
         pub fn rfxGetMouseDelta(x: *mut f32, y: *mut f32);
         pub fn rfxSetMouseCursorVisible(visible: bool);
         pub fn rfxSetMouseCursor(cursor: RfxCursorType);
+        pub fn rfxGetKeyPressed() -> i32;
+        pub fn rfxGetCharPressed() -> u32;
         pub fn rfxCreateBuffer(
             size: usize,
             stride: usize,
@@ -1210,8 +1353,13 @@ pub mod sys {
         ) -> RfxBuffer;
         pub fn rfxDestroyBuffer(buffer: RfxBuffer);
         pub fn rfxMapBuffer(buffer: RfxBuffer) -> *mut c_void;
+        pub fn rfxMapBufferRange(buffer: RfxBuffer, offset: u64, size: u64) -> *mut c_void;
         pub fn rfxUnmapBuffer(buffer: RfxBuffer);
+        pub fn rfxFlushBufferRange(buffer: RfxBuffer, offset: u64, size: u64);
+        pub fn rfxInvalidateBufferRange(buffer: RfxBuffer, offset: u64, size: u64);
         pub fn rfxGetBufferId(buffer: RfxBuffer) -> u32;
+        pub fn rfxGetBufferDeviceAddress(buffer: RfxBuffer) -> u64;
+        pub fn rfxAllocTransient(size: u64, alignment: u64) -> RfxTransientAlloc;
         pub fn rfxCreateTexture(
             width: i32,
             height: i32,
@@ -1234,6 +1382,12 @@ pub mod sys {
         pub fn rfxGetTextureDescriptor(texture: RfxTexture) -> *mut c_void;
         pub fn rfxGetSwapChainFormat() -> RfxFormat;
         pub fn rfxGetBackbufferTexture() -> RfxTexture;
+        pub fn rfxLoadTexture(path: *const c_char, usage: RfxTextureUsageFlags) -> RfxTexture;
+        pub fn rfxLoadTextureMem(
+            data: *const c_void,
+            size: usize,
+            usage: RfxTextureUsageFlags,
+        ) -> RfxTexture;
         pub fn rfxCreateSampler(filter: RfxFilter, addressMode: RfxAddressMode) -> RfxSampler;
         pub fn rfxDestroySampler(sampler: RfxSampler);
         pub fn rfxCompileShader(
@@ -1252,6 +1406,24 @@ pub mod sys {
         ) -> RfxShader;
         pub fn rfxDestroyShader(shader: RfxShader);
         pub fn rfxWatchShader(shader: RfxShader, watch: bool);
+        pub fn rfxSetShaderCacheEnabled(enabled: bool);
+        pub fn rfxSetShaderCachePath(path: *const c_char);
+        pub fn rfxSetShaderCacheCallbacks(
+            load: RfxShaderCacheLoadCallback,
+            save: RfxShaderCacheSaveCallback,
+            user: *mut c_void,
+        );
+        pub fn rfxWasShaderCached(shader: RfxShader) -> bool;
+        pub fn rfxAddVirtualShaderFile(filename: *const c_char, content: *const c_char);
+        pub fn rfxRemoveVirtualShaderFile(filename: *const c_char);
+        pub fn rfxPrecompileShader(
+            sourceOrPath: *const c_char,
+            defines: *const c_char,
+            numDefines: i32,
+            includeDirs: *const c_char,
+            numIncludeDirs: i32,
+            fromMemory: bool,
+        );
         pub fn rfxCreatePipeline(desc: *const RfxPipelineDesc) -> RfxPipeline;
         pub fn rfxDestroyPipeline(pipeline: RfxPipeline);
         pub fn rfxCreateComputePipeline(desc: *const RfxComputePipelineDesc) -> RfxPipeline;
@@ -1263,6 +1435,14 @@ pub mod sys {
         pub fn rfxDestroyCommandList(cmd: RfxCommandList);
         pub fn rfxBeginCommandList(cmd: RfxCommandList);
         pub fn rfxEndCommandList(cmd: RfxCommandList);
+        pub fn rfxSetCommandListDeferred(cmd: RfxCommandList, deferred: bool);
+        pub fn rfxSetCommandListBarrierHoisting(cmd: RfxCommandList, enabled: bool);
+        pub fn rfxCreateBundle() -> RfxBundle;
+        pub fn rfxDestroyBundle(bundle: RfxBundle);
+        pub fn rfxBeginBundle(bundle: RfxBundle) -> RfxCommandList;
+        pub fn rfxEndBundle(bundle: RfxBundle);
+        pub fn rfxCmdExecuteBundle(cmd: RfxCommandList, bundle: RfxBundle);
+        pub fn rfxQueueCommandList(cmd: RfxCommandList);
         pub fn rfxBeginFrame();
         pub fn rfxEndFrame();
         pub fn rfxCreateFence(initialValue: u64) -> RfxFence;
@@ -1291,6 +1471,23 @@ pub mod sys {
             clearColor: RfxColor,
             viewMask: u32,
         );
+        pub fn rfxCmdBeginSwapchainRenderPassEx(
+            cmd: RfxCommandList,
+            depthStencilFormat: RfxFormat,
+            clearColor: RfxColor,
+            resources: *const RfxPassResource,
+            resourceCount: u32,
+        );
+        pub fn rfxCmdBeginRenderPassEx(
+            cmd: RfxCommandList,
+            colors: *mut RfxTexture,
+            colorCount: u32,
+            depth: RfxTexture,
+            clearColor: RfxColor,
+            viewMask: u32,
+            resources: *const RfxPassResource,
+            resourceCount: u32,
+        );
         pub fn rfxCmdEndRenderPass(cmd: RfxCommandList);
         pub fn rfxCmdClear(cmd: RfxCommandList, color: RfxColor);
         pub fn rfxCmdBindPipeline(cmd: RfxCommandList, pipeline: RfxPipeline);
@@ -1318,9 +1515,31 @@ pub mod sys {
             buffer: RfxBuffer,
             indexType: RfxIndexType,
         );
+        pub fn rfxCmdBindVertexBufferEx(cmd: RfxCommandList, buffer: RfxBuffer, offset: usize);
+        pub fn rfxCmdBindIndexBufferEx(
+            cmd: RfxCommandList,
+            buffer: RfxBuffer,
+            offset: usize,
+            indexType: RfxIndexType,
+        );
         pub fn rfxCmdPushConstants(cmd: RfxCommandList, data: *const c_void, size: usize);
         pub fn rfxCmdDraw(cmd: RfxCommandList, vertexCount: u32, instanceCount: u32);
         pub fn rfxCmdDrawIndexed(cmd: RfxCommandList, indexCount: u32, instanceCount: u32);
+        pub fn rfxCmdDrawEx(
+            cmd: RfxCommandList,
+            vertexCount: u32,
+            instanceCount: u32,
+            firstVertex: u32,
+            firstInstance: u32,
+        );
+        pub fn rfxCmdDrawIndexedEx(
+            cmd: RfxCommandList,
+            indexCount: u32,
+            instanceCount: u32,
+            firstIndex: u32,
+            baseVertex: i32,
+            firstInstance: u32,
+        );
         pub fn rfxCmdDispatch(cmd: RfxCommandList, x: u32, y: u32, z: u32);
         pub fn rfxCmdDrawIndirect(
             cmd: RfxCommandList,
@@ -1372,6 +1591,58 @@ pub mod sys {
             maxDrawCount: u32,
             stride: u32,
         );
+        pub fn rfxCreateRenderQueue() -> RfxRenderQueue;
+        pub fn rfxDestroyRenderQueue(queue: RfxRenderQueue);
+        pub fn rfxResetRenderQueue(queue: RfxRenderQueue);
+        pub fn rfxAddDrawPacket(queue: RfxRenderQueue, packet: *const RfxDrawPacket);
+        pub fn rfxCmdDrawRenderQueue(cmd: RfxCommandList, queue: RfxRenderQueue);
+        pub fn rfxCreateGeometryPool(desc: *const RfxGeometryPoolDesc) -> RfxGeometryPool;
+        pub fn rfxDestroyGeometryPool(pool: RfxGeometryPool);
+        pub fn rfxAllocMesh(pool: RfxGeometryPool, desc: *const RfxMeshDesc) -> u32;
+        pub fn rfxFreeMesh(pool: RfxGeometryPool, mesh: u32);
+        pub fn rfxGetMeshRecord(pool: RfxGeometryPool, mesh: u32) -> RfxMeshRecord;
+        pub fn rfxGetGeometryPoolVertexBuffer(pool: RfxGeometryPool) -> RfxBuffer;
+        pub fn rfxGetGeometryPoolIndexBuffer(pool: RfxGeometryPool) -> RfxBuffer;
+        pub fn rfxGetGeometryPoolMeshTable(pool: RfxGeometryPool) -> RfxBuffer;
+        pub fn rfxCmdDrawMesh(
+            cmd: RfxCommandList,
+            pool: RfxGeometryPool,
+            mesh: u32,
+            instanceCount: u32,
+        );
+        pub fn rfxCreateFrameGraph() -> RfxFrameGraph;
+        pub fn rfxDestroyFrameGraph(graph: RfxFrameGraph);
+        pub fn rfxResetFrameGraph(graph: RfxFrameGraph);
+        pub fn rfxGraphImportTexture(graph: RfxFrameGraph, texture: RfxTexture) -> u32;
+        pub fn rfxGraphImportBuffer(graph: RfxFrameGraph, buffer: RfxBuffer) -> u32;
+        pub fn rfxGraphCreateTexture(graph: RfxFrameGraph, desc: *const RfxTextureDesc) -> u32;
+        pub fn rfxGraphCreateBuffer(
+            graph: RfxFrameGraph,
+            size: usize,
+            stride: usize,
+            usage: RfxBufferUsageFlags,
+        ) -> u32;
+        pub fn rfxGraphAddPass(
+            graph: RfxFrameGraph,
+            name: *const c_char,
+            func: RfxGraphPassFunc,
+            userData: *mut c_void,
+        ) -> u32;
+        pub fn rfxGraphRead(
+            graph: RfxFrameGraph,
+            pass: u32,
+            resource: u32,
+            state: RfxResourceState,
+        );
+        pub fn rfxGraphWrite(
+            graph: RfxFrameGraph,
+            pass: u32,
+            resource: u32,
+            state: RfxResourceState,
+        );
+        pub fn rfxGraphGetTexture(graph: RfxFrameGraph, resource: u32) -> RfxTexture;
+        pub fn rfxGraphGetBuffer(graph: RfxFrameGraph, resource: u32) -> RfxBuffer;
+        pub fn rfxCmdExecuteFrameGraph(cmd: RfxCommandList, graph: RfxFrameGraph);
         pub fn rfxCmdCopyBuffer(
             cmd: RfxCommandList,
             src: RfxBuffer,
@@ -1388,6 +1659,20 @@ pub mod sys {
             mip: u32,
             layer: u32,
         );
+        pub fn rfxCmdGenerateMips(cmd: RfxCommandList, texture: RfxTexture);
+        pub fn rfxCmdUpdateBuffer(
+            cmd: RfxCommandList,
+            buffer: RfxBuffer,
+            offset: u64,
+            data: *const c_void,
+            size: u64,
+        );
+        pub fn rfxCmdUpdateBufferScatter(
+            cmd: RfxCommandList,
+            buffer: RfxBuffer,
+            updates: *const RfxBufferUpdate,
+            updateCount: u32,
+        );
         pub fn rfxCmdReadbackTextureToBuffer(
             cmd: RfxCommandList,
             src: RfxTexture,
@@ -1415,6 +1700,11 @@ pub mod sys {
             src: RfxAccelerationStructure,
             mode: RfxCopyMode,
         );
+        pub fn rfxUploadBuffer(dst: RfxBuffer, dstOffset: u64, data: *const c_void, size: u64);
+        pub fn rfxUploadTexture(dst: RfxTexture, data: *const c_void, mip: u32, layer: u32);
+        pub fn rfxSubmitUploads() -> u64;
+        pub fn rfxIsUploadComplete(value: u64) -> bool;
+        pub fn rfxGetUploadFence() -> RfxFence;
         pub fn rfxCmdTransitionBuffer(
             cmd: RfxCommandList,
             buffer: RfxBuffer,
@@ -1434,6 +1724,7 @@ pub mod sys {
         pub fn rfxCmdBeginProfile(cmd: RfxCommandList, name: *const c_char);
         pub fn rfxCmdEndProfile(cmd: RfxCommandList);
         pub fn rfxGetGpuTimestamps(outTimestamps: *mut RfxGpuTimestamp, maxCount: u32) -> u32;
+        pub fn rfxGetFrameStats(outStats: *mut RfxFrameStats);
         pub fn rfxCreateQueryPool(r#type: RfxQueryType, capacity: u32) -> RfxQueryPool;
         pub fn rfxDestroyQueryPool(pool: RfxQueryPool);
         pub fn rfxCmdResetQueries(cmd: RfxCommandList, pool: RfxQueryPool, offset: u32, count: u32);
@@ -1516,31 +1807,13 @@ pub mod sys {
             upscaler: RfxUpscaler,
             desc: *const RfxUpscaleDesc,
         );
+        pub fn rfxSetAllocator(allocator: *const RfxAllocator);
     }
 }
 
 //
 // Typedefs
 //
-pub type __vcrt_bool = sys::__vcrt_bool;
-pub type int_least8_t = sys::int_least8_t;
-pub type int_least16_t = sys::int_least16_t;
-pub type int_least32_t = sys::int_least32_t;
-pub type int_least64_t = sys::int_least64_t;
-pub type uint_least8_t = sys::uint_least8_t;
-pub type uint_least16_t = sys::uint_least16_t;
-pub type uint_least32_t = sys::uint_least32_t;
-pub type uint_least64_t = sys::uint_least64_t;
-pub type int_fast8_t = sys::int_fast8_t;
-pub type int_fast16_t = sys::int_fast16_t;
-pub type int_fast32_t = sys::int_fast32_t;
-pub type int_fast64_t = sys::int_fast64_t;
-pub type uint_fast8_t = sys::uint_fast8_t;
-pub type uint_fast16_t = sys::uint_fast16_t;
-pub type uint_fast32_t = sys::uint_fast32_t;
-pub type uint_fast64_t = sys::uint_fast64_t;
-pub type intmax_t = sys::intmax_t;
-pub type uintmax_t = sys::uintmax_t;
 
 //
 // Enums
@@ -1590,6 +1863,7 @@ bitflags::bitflags! {
         const MICROMAP_BUILD_INPUT = sys::RFX_USAGE_MICROMAP_BUILD_INPUT;
         const TRANSFER_SRC = sys::RFX_USAGE_TRANSFER_SRC;
         const TRANSFER_DST = sys::RFX_USAGE_TRANSFER_DST;
+        const PERSISTENT_MAP = sys::RFX_USAGE_PERSISTENT_MAP;
     }
 }
 
@@ -1611,6 +1885,11 @@ pub enum ResourceState {
     ScratchBuffer = sys::RFX_STATE_SCRATCH_BUFFER as u32,
     ResolveSrc = sys::RFX_STATE_RESOLVE_SRC as u32,
     ResolveDst = sys::RFX_STATE_RESOLVE_DST as u32,
+    FragmentRead = sys::RFX_STATE_FRAGMENT_READ as u32,
+    GraphicsRead = sys::RFX_STATE_GRAPHICS_READ as u32,
+    ComputeRead = sys::RFX_STATE_COMPUTE_READ as u32,
+    ComputeWrite = sys::RFX_STATE_COMPUTE_WRITE as u32,
+    RaytracingRead = sys::RFX_STATE_RAYTRACING_READ as u32,
 }
 
 #[repr(u32)]
@@ -2006,7 +2285,7 @@ bitflags::bitflags! {
         const MAXIMIZED = sys::RFX_WINDOW_MAXIMIZED;
         const HIDDEN = sys::RFX_WINDOW_HIDDEN;
         const CENTERED = sys::RFX_WINDOW_CENTERED;
-        const SCALE_TO_MONITOR = sys::RFX_WINDOW_SCALE_TO_MONITOR;
+        const NO_SCALE = sys::RFX_WINDOW_NO_SCALE;
     }
 }
 
@@ -2020,6 +2299,15 @@ bitflags::bitflags! {
     }
 }
 
+#[repr(u32)]
+#[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
+pub enum Vendor {
+    Unknown = sys::RFX_VENDOR_UNKNOWN as u32,
+    Nvidia = sys::RFX_VENDOR_NVIDIA as u32,
+    Amd = sys::RFX_VENDOR_AMD as u32,
+    Intel = sys::RFX_VENDOR_INTEL as u32,
+}
+
 #[repr(u32)]
 #[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
 pub enum CursorType {
@@ -2029,6 +2317,12 @@ pub enum CursorType {
     Crosshair = sys::RFX_CURSOR_CROSSHAIR as u32,
     Hand = sys::RFX_CURSOR_HAND as u32,
     ResizeEw = sys::RFX_CURSOR_RESIZE_EW as u32,
+    ResizeNs = sys::RFX_CURSOR_RESIZE_NS as u32,
+    ResizeNwse = sys::RFX_CURSOR_RESIZE_NWSE as u32,
+    ResizeNesw = sys::RFX_CURSOR_RESIZE_NESW as u32,
+    ResizeAll = sys::RFX_CURSOR_RESIZE_ALL as u32,
+    NotAllowed = sys::RFX_CURSOR_NOT_ALLOWED as u32,
+    ResizeNw = sys::RFX_CURSOR_RESIZE_NW as u32,
     ResizeN = sys::RFX_CURSOR_RESIZE_N as u32,
     ResizeNe = sys::RFX_CURSOR_RESIZE_NE as u32,
     ResizeE = sys::RFX_CURSOR_RESIZE_E as u32,
@@ -2173,6 +2467,24 @@ impl BufferImpl {
     }
 }
 
+#[repr(transparent)]
+#[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
+pub struct Bundle(pub sys::RfxBundle);
+impl Bundle {
+    pub fn as_raw(&self) -> sys::RfxBundle {
+        self.0
+    }
+}
+
+#[repr(transparent)]
+#[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
+pub struct BundleImpl(pub sys::RfxBundleImpl);
+impl BundleImpl {
+    pub fn as_raw(&self) -> sys::RfxBundleImpl {
+        self.0
+    }
+}
+
 #[repr(transparent)]
 #[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
 pub struct CommandList(pub sys::RfxCommandList);
@@ -2191,6 +2503,24 @@ impl CommandListImpl {
     }
 }
 
+#[repr(transparent)]
+#[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
+pub struct Context(pub sys::RfxContext);
+impl Context {
+    pub fn as_raw(&self) -> sys::RfxContext {
+        self.0
+    }
+}
+
+#[repr(transparent)]
+#[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
+pub struct ContextImpl(pub sys::RfxContextImpl);
+impl ContextImpl {
+    pub fn as_raw(&self) -> sys::RfxContextImpl {
+        self.0
+    }
+}
+
 #[repr(transparent)]
 #[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
 pub struct Denoiser(pub sys::RfxDenoiser);
@@ -2227,6 +2557,51 @@ impl FenceImpl {
     }
 }
 
+#[repr(transparent)]
+#[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
+pub struct FrameGraph(pub sys::RfxFrameGraph);
+impl FrameGraph {
+    pub fn as_raw(&self) -> sys::RfxFrameGraph {
+        self.0
+    }
+}
+
+#[repr(transparent)]
+#[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
+pub struct FrameGraphImpl(pub sys::RfxFrameGraphImpl);
+impl FrameGraphImpl {
+    pub fn as_raw(&self) -> sys::RfxFrameGraphImpl {
+        self.0
+    }
+}
+
+#[repr(transparent)]
+#[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
+pub struct GeometryPool(pub sys::RfxGeometryPool);
+impl GeometryPool {
+    pub fn as_raw(&self) -> sys::RfxGeometryPool {
+        self.0
+    }
+}
+
+#[repr(transparent)]
+#[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
+pub struct GeometryPoolImpl(pub sys::RfxGeometryPoolImpl);
+impl GeometryPoolImpl {
+    pub fn as_raw(&self) -> sys::RfxGeometryPoolImpl {
+        self.0
+    }
+}
+
+#[repr(transparent)]
+#[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
+pub struct GraphPassFunc(pub sys::RfxGraphPassFunc);
+impl GraphPassFunc {
+    pub fn as_raw(&self) -> sys::RfxGraphPassFunc {
+        self.0
+    }
+}
+
 #[repr(transparent)]
 #[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
 pub struct Micromap(pub sys::RfxMicromap);
@@ -2281,6 +2656,24 @@ impl QueryPoolImpl {
     }
 }
 
+#[repr(transparent)]
+#[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
+pub struct RenderQueue(pub sys::RfxRenderQueue);
+impl RenderQueue {
+    pub fn as_raw(&self) -> sys::RfxRenderQueue {
+        self.0
+    }
+}
+
+#[repr(transparent)]
+#[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
+pub struct RenderQueueImpl(pub sys::RfxRenderQueueImpl);
+impl RenderQueueImpl {
+    pub fn as_raw(&self) -> sys::RfxRenderQueueImpl {
+        self.0
+    }
+}
+
 #[repr(transparent)]
 #[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
 pub struct Sampler(pub sys::RfxSampler);
@@ -2326,6 +2719,24 @@ impl ShaderBindingTableImpl {
     }
 }
 
+#[repr(transparent)]
+#[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
+pub struct ShaderCacheLoadCallback(pub sys::RfxShaderCacheLoadCallback);
+impl ShaderCacheLoadCallback {
+    pub fn as_raw(&self) -> sys::RfxShaderCacheLoadCallback {
+        self.0
+    }
+}
+
+#[repr(transparent)]
+#[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
+pub struct ShaderCacheSaveCallback(pub sys::RfxShaderCacheSaveCallback);
+impl ShaderCacheSaveCallback {
+    pub fn as_raw(&self) -> sys::RfxShaderCacheSaveCallback {
+        self.0
+    }
+}
+
 #[repr(transparent)]
 #[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
 pub struct ShaderImpl(pub sys::RfxShaderImpl);
@@ -2371,6 +2782,20 @@ impl UpscalerImpl {
     }
 }
 
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct Allocator {
+    pub allocate: *mut c_void,
+    pub reallocate: *mut c_void,
+    pub free: *mut c_void,
+    pub user_arg: *mut c_void,
+}
+impl Default for Allocator {
+    fn default() -> Self {
+        unsafe { std::mem::zeroed() }
+    }
+}
+
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
 pub struct Color {
@@ -2542,6 +2967,18 @@ impl Default for GpuTimestamp {
     }
 }
 
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct FrameStats {
+    pub elided_state_calls: u32,
+    pub render_pass_restarts: u32,
+}
+impl Default for FrameStats {
+    fn default() -> Self {
+        unsafe { std::mem::zeroed() }
+    }
+}
+
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
 pub struct GeometryTriangles {
@@ -2699,6 +3136,7 @@ pub struct TextureDesc {
     pub sample_count: i32,
     pub usage: TextureUsageFlags,
     pub initial_data: *const c_void,
+    pub subresource_data: *const c_void,
 }
 impl Default for TextureDesc {
     fn default() -> Self {
@@ -2848,6 +3286,137 @@ impl Default for LatencyReport {
     }
 }
 
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct AdapterInfo {
+    pub name: [c_char; 256],
+    pub video_memory_size: u64,
+    pub shared_system_memory_size: u64,
+    pub device_id: u32,
+    pub vendor: Vendor,
+    pub integrated: bool,
+    pub features: FeatureSupportFlags,
+}
+impl Default for AdapterInfo {
+    fn default() -> Self {
+        unsafe { std::mem::zeroed() }
+    }
+}
+
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct TransientAlloc {
+    pub cpu: *mut c_void,
+    pub buffer: Buffer,
+    pub buffer_id: u32,
+    pub offset: u64,
+    pub device_address: u64,
+}
+impl Default for TransientAlloc {
+    fn default() -> Self {
+        unsafe { std::mem::zeroed() }
+    }
+}
+
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct PassResource {
+    pub texture: Texture,
+    pub buffer: Buffer,
+    pub state: ResourceState,
+}
+impl Default for PassResource {
+    fn default() -> Self {
+        unsafe { std::mem::zeroed() }
+    }
+}
+
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct DrawPacket {
+    pub pipeline: Pipeline,
+    pub vertex_buffer: Buffer,
+    pub index_buffer: Buffer,
+    pub index_type: IndexType,
+    pub vertex_offset: usize,
+    pub index_offset: usize,
+    pub count: u32,
+    pub instance_count: u32,
+    pub first: u32,
+    pub base_vertex: i32,
+    pub first_instance: u32,
+    pub push_constants: *const c_void,
+    pub push_constants_size: u32,
+    pub depth: f32,
+    pub layer: u8,
+    pub back_to_front: bool,
+}
+impl Default for DrawPacket {
+    fn default() -> Self {
+        unsafe { std::mem::zeroed() }
+    }
+}
+
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct GeometryPoolDesc {
+    pub vertex_capacity: u32,
+    pub index_capacity: u32,
+    pub vertex_stride: u32,
+    pub index_type: IndexType,
+    pub max_meshes: u32,
+}
+impl Default for GeometryPoolDesc {
+    fn default() -> Self {
+        unsafe { std::mem::zeroed() }
+    }
+}
+
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct MeshRecord {
+    pub vertex_offset: u32,
+    pub vertex_count: u32,
+    pub index_offset: u32,
+    pub index_count: u32,
+    pub bounds_center: [f32; 3],
+    pub bounds_radius: f32,
+}
+impl Default for MeshRecord {
+    fn default() -> Self {
+        unsafe { std::mem::zeroed() }
+    }
+}
+
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct MeshDesc {
+    pub vertices: *const c_void,
+    pub vertex_count: u32,
+    pub indices: *const c_void,
+    pub index_count: u32,
+    pub bounds_center: [f32; 3],
+    pub bounds_radius: f32,
+}
+impl Default for MeshDesc {
+    fn default() -> Self {
+        unsafe { std::mem::zeroed() }
+    }
+}
+
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct BufferUpdate {
+    pub offset: u64,
+    pub data: *const c_void,
+    pub size: u64,
+}
+impl Default for BufferUpdate {
+    fn default() -> Self {
+        unsafe { std::mem::zeroed() }
+    }
+}
+
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
 pub struct ImGuiDrawData {
@@ -2887,15 +3456,41 @@ impl Buffer {
     pub fn map(&self) -> *mut c_void {
         unsafe { sys::rfxMapBuffer(self.0) }
     }
+    pub fn map_range(&self, offset: u64, size: u64) -> *mut c_void {
+        unsafe { sys::rfxMapBufferRange(self.0, offset, size) }
+    }
     pub fn unmap(&self) {
         unsafe { sys::rfxUnmapBuffer(self.0) }
     }
+    pub fn flush_range(&self, offset: u64, size: u64) {
+        unsafe { sys::rfxFlushBufferRange(self.0, offset, size) }
+    }
+    pub fn invalidate_range(&self, offset: u64, size: u64) {
+        unsafe { sys::rfxInvalidateBufferRange(self.0, offset, size) }
+    }
     pub fn get_id(&self) -> u32 {
         unsafe { sys::rfxGetBufferId(self.0) }
     }
+    pub fn get_device_address(&self) -> u64 {
+        unsafe { sys::rfxGetBufferDeviceAddress(self.0) }
+    }
     pub fn set_name(&self, name: &str) {
         unsafe { sys::rfxSetBufferName(self.0, std::ffi::CString::new(name).unwrap().as_ptr()) }
     }
+    pub fn upload(&self, dst_offset: u64, data: *mut c_void, size: u64) {
+        unsafe { sys::rfxUploadBuffer(self.0, dst_offset, data as *mut c_void, size) }
+    }
+}
+impl Bundle {
+    pub fn destroy(&self) {
+        unsafe { sys::rfxDestroyBundle(self.0) }
+    }
+    pub fn begin(&self) -> CommandList {
+        CommandList(unsafe { sys::rfxBeginBundle(self.0) })
+    }
+    pub fn end(&self) {
+        unsafe { sys::rfxEndBundle(self.0) }
+    }
 }
 impl CommandList {
     pub fn destroy(&self) {
@@ -2907,6 +3502,18 @@ impl CommandList {
     pub fn end(&self) {
         unsafe { sys::rfxEndCommandList(self.0) }
     }
+    pub fn set_deferred(&self, deferred: bool) {
+        unsafe { sys::rfxSetCommandListDeferred(self.0, deferred) }
+    }
+    pub fn set_barrier_hoisting(&self, enabled: bool) {
+        unsafe { sys::rfxSetCommandListBarrierHoisting(self.0, enabled) }
+    }
+    pub fn execute_bundle(&self, bundle: Bundle) {
+        unsafe { sys::rfxCmdExecuteBundle(self.0, bundle.0) }
+    }
+    pub fn queue(&self) {
+        unsafe { sys::rfxQueueCommandList(self.0) }
+    }
     pub fn submit_async(
         &self,
         wait_fences: *mut Fence,
@@ -2954,6 +3561,46 @@ impl CommandList {
             )
         }
     }
+    pub fn begin_swapchain_render_pass_ex(
+        &self,
+        depth_stencil_format: Format,
+        clear_color: Color,
+        resources: *mut PassResource,
+        resource_count: u32,
+    ) {
+        unsafe {
+            sys::rfxCmdBeginSwapchainRenderPassEx(
+                self.0,
+                depth_stencil_format as u32,
+                unsafe { std::mem::transmute(clear_color) },
+                resources as *mut sys::RfxPassResource,
+                resource_count,
+            )
+        }
+    }
+    pub fn begin_render_pass_ex(
+        &self,
+        colors: *mut Texture,
+        color_count: u32,
+        depth: Texture,
+        clear_color: Color,
+        view_mask: u32,
+        resources: *mut PassResource,
+        resource_count: u32,
+    ) {
+        unsafe {
+            sys::rfxCmdBeginRenderPassEx(
+                self.0,
+                colors as *mut sys::RfxTexture,
+                color_count,
+                depth.0,
+                unsafe { std::mem::transmute(clear_color) },
+                view_mask,
+                resources as *mut sys::RfxPassResource,
+                resource_count,
+            )
+        }
+    }
     pub fn end_render_pass(&self) {
         unsafe { sys::rfxCmdEndRenderPass(self.0) }
     }
@@ -3017,6 +3664,12 @@ impl CommandList {
     pub fn bind_index_buffer(&self, buffer: Buffer, index_type: IndexType) {
         unsafe { sys::rfxCmdBindIndexBuffer(self.0, buffer.0, index_type as u32) }
     }
+    pub fn bind_vertex_buffer_ex(&self, buffer: Buffer, offset: usize) {
+        unsafe { sys::rfxCmdBindVertexBufferEx(self.0, buffer.0, offset) }
+    }
+    pub fn bind_index_buffer_ex(&self, buffer: Buffer, offset: usize, index_type: IndexType) {
+        unsafe { sys::rfxCmdBindIndexBufferEx(self.0, buffer.0, offset, index_type as u32) }
+    }
     pub fn push_constants(&self, data: *mut c_void, size: usize) {
         unsafe { sys::rfxCmdPushConstants(self.0, data as *mut c_void, size) }
     }
@@ -3026,6 +3679,42 @@ impl CommandList {
     pub fn draw_indexed(&self, index_count: u32, instance_count: u32) {
         unsafe { sys::rfxCmdDrawIndexed(self.0, index_count, instance_count) }
     }
+    pub fn draw_ex(
+        &self,
+        vertex_count: u32,
+        instance_count: u32,
+        first_vertex: u32,
+        first_instance: u32,
+    ) {
+        unsafe {
+            sys::rfxCmdDrawEx(
+                self.0,
+                vertex_count,
+                instance_count,
+                first_vertex,
+                first_instance,
+            )
+        }
+    }
+    pub fn draw_indexed_ex(
+        &self,
+        index_count: u32,
+        instance_count: u32,
+        first_index: u32,
+        base_vertex: i32,
+        first_instance: u32,
+    ) {
+        unsafe {
+            sys::rfxCmdDrawIndexedEx(
+                self.0,
+                index_count,
+                instance_count,
+                first_index,
+                base_vertex,
+                first_instance,
+            )
+        }
+    }
     pub fn dispatch(&self, x: u32, y: u32, z: u32) {
         unsafe { sys::rfxCmdDispatch(self.0, x, y, z) }
     }
@@ -3119,6 +3808,15 @@ impl CommandList {
             )
         }
     }
+    pub fn draw_render_queue(&self, queue: RenderQueue) {
+        unsafe { sys::rfxCmdDrawRenderQueue(self.0, queue.0) }
+    }
+    pub fn draw_mesh(&self, pool: GeometryPool, mesh: u32, instance_count: u32) {
+        unsafe { sys::rfxCmdDrawMesh(self.0, pool.0, mesh, instance_count) }
+    }
+    pub fn execute_frame_graph(&self, graph: FrameGraph) {
+        unsafe { sys::rfxCmdExecuteFrameGraph(self.0, graph.0) }
+    }
     pub fn copy_buffer(
         &self,
         src: Buffer,
@@ -3135,6 +3833,27 @@ impl CommandList {
     pub fn upload_texture(&self, dst: Texture, data: *mut c_void, mip: u32, layer: u32) {
         unsafe { sys::rfxCmdUploadTexture(self.0, dst.0, data as *mut c_void, mip, layer) }
     }
+    pub fn generate_mips(&self, texture: Texture) {
+        unsafe { sys::rfxCmdGenerateMips(self.0, texture.0) }
+    }
+    pub fn update_buffer(&self, buffer: Buffer, offset: u64, data: *mut c_void, size: u64) {
+        unsafe { sys::rfxCmdUpdateBuffer(self.0, buffer.0, offset, data as *mut c_void, size) }
+    }
+    pub fn update_buffer_scatter(
+        &self,
+        buffer: Buffer,
+        updates: *mut BufferUpdate,
+        update_count: u32,
+    ) {
+        unsafe {
+            sys::rfxCmdUpdateBufferScatter(
+                self.0,
+                buffer.0,
+                updates as *mut sys::RfxBufferUpdate,
+                update_count,
+            )
+        }
+    }
     pub fn readback_texture_to_buffer(&self, src: Texture, dst: Buffer, dst_offset: u64) {
         unsafe { sys::rfxCmdReadbackTextureToBuffer(self.0, src.0, dst.0, dst_offset) }
     }
@@ -3286,6 +4005,14 @@ impl CommandList {
         unsafe { sys::rfxCmdUpscale(self.0, upscaler.0, desc as *mut sys::RfxUpscaleDesc) }
     }
 }
+impl Context {
+    pub fn destroy(&self) {
+        unsafe { sys::rfxDestroyContext(self.0) }
+    }
+    pub fn make_current(&self) {
+        unsafe { sys::rfxMakeContextCurrent(self.0) }
+    }
+}
 impl Denoiser {
     pub fn destroy(&self) {
         unsafe { sys::rfxDestroyDenoiser(self.0) }
@@ -3302,6 +4029,71 @@ impl Fence {
         unsafe { sys::rfxGetFenceValue(self.0) }
     }
 }
+impl FrameGraph {
+    pub fn destroy(&self) {
+        unsafe { sys::rfxDestroyFrameGraph(self.0) }
+    }
+    pub fn reset(&self) {
+        unsafe { sys::rfxResetFrameGraph(self.0) }
+    }
+    pub fn graph_import_texture(&self, texture: Texture) -> u32 {
+        unsafe { sys::rfxGraphImportTexture(self.0, texture.0) }
+    }
+    pub fn graph_import_buffer(&self, buffer: Buffer) -> u32 {
+        unsafe { sys::rfxGraphImportBuffer(self.0, buffer.0) }
+    }
+    pub fn graph_create_texture(&self, desc: *mut TextureDesc) -> u32 {
+        unsafe { sys::rfxGraphCreateTexture(self.0, desc as *mut sys::RfxTextureDesc) }
+    }
+    pub fn graph_create_buffer(&self, size: usize, stride: usize, usage: BufferUsageFlags) -> u32 {
+        unsafe { sys::rfxGraphCreateBuffer(self.0, size, stride, usage.bits()) }
+    }
+    pub fn graph_add_pass(&self, name: &str, func: GraphPassFunc, user_data: *mut c_void) -> u32 {
+        unsafe {
+            sys::rfxGraphAddPass(
+                self.0,
+                std::ffi::CString::new(name).unwrap().as_ptr(),
+                func.0,
+                user_data as *mut c_void,
+            )
+        }
+    }
+    pub fn graph_read(&self, pass: u32, resource: u32, state: ResourceState) {
+        unsafe { sys::rfxGraphRead(self.0, pass, resource, state as u32) }
+    }
+    pub fn graph_write(&self, pass: u32, resource: u32, state: ResourceState) {
+        unsafe { sys::rfxGraphWrite(self.0, pass, resource, state as u32) }
+    }
+    pub fn graph_get_texture(&self, resource: u32) -> Texture {
+        Texture(unsafe { sys::rfxGraphGetTexture(self.0, resource) })
+    }
+    pub fn graph_get_buffer(&self, resource: u32) -> Buffer {
+        Buffer(unsafe { sys::rfxGraphGetBuffer(self.0, resource) })
+    }
+}
+impl GeometryPool {
+    pub fn destroy(&self) {
+        unsafe { sys::rfxDestroyGeometryPool(self.0) }
+    }
+    pub fn alloc_mesh(&self, desc: *mut MeshDesc) -> u32 {
+        unsafe { sys::rfxAllocMesh(self.0, desc as *mut sys::RfxMeshDesc) }
+    }
+    pub fn free_mesh(&self, mesh: u32) {
+        unsafe { sys::rfxFreeMesh(self.0, mesh) }
+    }
+    pub fn get_mesh_record(&self, mesh: u32) -> MeshRecord {
+        unsafe { std::mem::transmute(unsafe { sys::rfxGetMeshRecord(self.0, mesh) }) }
+    }
+    pub fn get_vertex_buffer(&self) -> Buffer {
+        Buffer(unsafe { sys::rfxGetGeometryPoolVertexBuffer(self.0) })
+    }
+    pub fn get_index_buffer(&self) -> Buffer {
+        Buffer(unsafe { sys::rfxGetGeometryPoolIndexBuffer(self.0) })
+    }
+    pub fn get_mesh_table(&self) -> Buffer {
+        Buffer(unsafe { sys::rfxGetGeometryPoolMeshTable(self.0) })
+    }
+}
 impl Micromap {
     pub fn destroy(&self) {
         unsafe { sys::rfxDestroyMicromap(self.0) }
@@ -3326,6 +4118,17 @@ impl QueryPool {
         unsafe { sys::rfxDestroyQueryPool(self.0) }
     }
 }
+impl RenderQueue {
+    pub fn destroy(&self) {
+        unsafe { sys::rfxDestroyRenderQueue(self.0) }
+    }
+    pub fn reset(&self) {
+        unsafe { sys::rfxResetRenderQueue(self.0) }
+    }
+    pub fn add_draw_packet(&self, packet: *mut DrawPacket) {
+        unsafe { sys::rfxAddDrawPacket(self.0, packet as *mut sys::RfxDrawPacket) }
+    }
+}
 impl Sampler {
     pub fn destroy(&self) {
         unsafe { sys::rfxDestroySampler(self.0) }
@@ -3338,12 +4141,20 @@ impl Shader {
     pub fn watch(&self, watch: bool) {
         unsafe { sys::rfxWatchShader(self.0, watch) }
     }
+    pub fn was_cached(&self) -> bool {
+        unsafe { sys::rfxWasShaderCached(self.0) }
+    }
 }
 impl ShaderBindingTable {
     pub fn destroy(&self) {
         unsafe { sys::rfxDestroyShaderBindingTable(self.0) }
     }
 }
+impl ShaderCacheLoadCallback {
+    pub fn set_shader_cache_callbacks(&self, save: ShaderCacheSaveCallback, user: *mut c_void) {
+        unsafe { sys::rfxSetShaderCacheCallbacks(self.0, save.0, user as *mut c_void) }
+    }
+}
 impl Texture {
     pub fn create_view(
         &self,
@@ -3369,6 +4180,9 @@ impl Texture {
     pub fn set_name(&self, name: &str) {
         unsafe { sys::rfxSetTextureName(self.0, std::ffi::CString::new(name).unwrap().as_ptr()) }
     }
+    pub fn upload(&self, data: *mut c_void, mip: u32, layer: u32) {
+        unsafe { sys::rfxUploadTexture(self.0, data as *mut c_void, mip, layer) }
+    }
 }
 impl Upscaler {
     pub fn destroy(&self) {
@@ -3378,6 +4192,12 @@ impl Upscaler {
         unsafe { sys::rfxGetUpscalerProps(self.0, out_props as *mut sys::RfxUpscalerProps) }
     }
 }
+pub fn create_context() -> Context {
+    Context(unsafe { sys::rfxCreateContext() })
+}
+pub fn get_current_context() -> Context {
+    Context(unsafe { sys::rfxGetCurrentContext() })
+}
 pub fn request_backend(backend: Backend, enable_validation: bool) {
     unsafe { sys::rfxRequestBackend(backend as u32, enable_validation) }
 }
@@ -3390,6 +4210,15 @@ pub fn open_window(title: &str, width: i32, height: i32) -> bool {
         )
     }
 }
+pub fn init_headless(backend: Backend, width: i32, height: i32) -> bool {
+    unsafe { sys::rfxInitHeadless(backend as u32, width, height) }
+}
+pub fn enumerate_adapters(adapters: *mut AdapterInfo, capacity: u32) -> u32 {
+    unsafe { sys::rfxEnumerateAdapters(adapters as *mut sys::RfxAdapterInfo, capacity) }
+}
+pub fn select_adapter(index: u32) {
+    unsafe { sys::rfxSelectAdapter(index) }
+}
 pub fn supports_features(features: FeatureSupportFlags) -> bool {
     unsafe { sys::rfxSupportsFeatures(features.bits()) }
 }
@@ -3402,6 +4231,9 @@ pub fn set_sample_count(count: i32) {
 pub fn set_anisotropy(level: i32) {
     unsafe { sys::rfxSetAnisotropy(level) }
 }
+pub fn set_frames_in_flight(count: i32) {
+    unsafe { sys::rfxSetFramesInFlight(count) }
+}
 pub fn set_window_flags(flags: WindowFlags) {
     unsafe { sys::rfxSetWindowFlags(flags.bits()) }
 }
@@ -3432,6 +4264,9 @@ pub fn get_window_width() -> i32 {
 pub fn get_window_height() -> i32 {
     unsafe { sys::rfxGetWindowHeight() }
 }
+pub fn get_window_scale() -> f32 {
+    unsafe { sys::rfxGetWindowScale() }
+}
 pub fn get_time() -> f64 {
     unsafe { sys::rfxGetTime() }
 }
@@ -3471,6 +4306,12 @@ pub fn set_mouse_cursor_visible(visible: bool) {
 pub fn set_mouse_cursor(cursor: CursorType) {
     unsafe { sys::rfxSetMouseCursor(cursor as u32) }
 }
+pub fn get_key_pressed() -> i32 {
+    unsafe { sys::rfxGetKeyPressed() }
+}
+pub fn get_char_pressed() -> u32 {
+    unsafe { sys::rfxGetCharPressed() }
+}
 pub fn create_buffer(
     size: usize,
     stride: usize,
@@ -3488,6 +4329,9 @@ pub fn create_buffer(
         )
     })
 }
+pub fn alloc_transient(size: u64, alignment: u64) -> TransientAlloc {
+    unsafe { std::mem::transmute(unsafe { sys::rfxAllocTransient(size, alignment) }) }
+}
 pub fn create_texture(
     width: i32,
     height: i32,
@@ -3516,6 +4360,14 @@ pub fn get_swap_chain_format() -> Format {
 pub fn get_backbuffer_texture() -> Texture {
     Texture(unsafe { sys::rfxGetBackbufferTexture() })
 }
+pub fn load_texture(path: &str, usage: TextureUsageFlags) -> Texture {
+    Texture(unsafe {
+        sys::rfxLoadTexture(std::ffi::CString::new(path).unwrap().as_ptr(), usage.bits())
+    })
+}
+pub fn load_texture_mem(data: *mut c_void, size: usize, usage: TextureUsageFlags) -> Texture {
+    Texture(unsafe { sys::rfxLoadTextureMem(data as *mut c_void, size, usage.bits()) })
+}
 pub fn create_sampler(filter: Filter, address_mode: AddressMode) -> Sampler {
     Sampler(unsafe { sys::rfxCreateSampler(filter as u32, address_mode as u32) })
 }
@@ -3553,6 +4405,42 @@ pub fn compile_shader_mem(
         )
     })
 }
+pub fn set_shader_cache_enabled(enabled: bool) {
+    unsafe { sys::rfxSetShaderCacheEnabled(enabled) }
+}
+pub fn set_shader_cache_path(path: &str) {
+    unsafe { sys::rfxSetShaderCachePath(std::ffi::CString::new(path).unwrap().as_ptr()) }
+}
+pub fn add_virtual_shader_file(filename: &str, content: &str) {
+    unsafe {
+        sys::rfxAddVirtualShaderFile(
+            std::ffi::CString::new(filename).unwrap().as_ptr(),
+            std::ffi::CString::new(content).unwrap().as_ptr(),
+        )
+    }
+}
+pub fn remove_virtual_shader_file(filename: &str) {
+    unsafe { sys::rfxRemoveVirtualShaderFile(std::ffi::CString::new(filename).unwrap().as_ptr()) }
+}
+pub fn precompile_shader(
+    source_or_path: &str,
+    defines: &str,
+    num_defines: i32,
+    include_dirs: &str,
+    num_include_dirs: i32,
+    from_memory: bool,
+) {
+    unsafe {
+        sys::rfxPrecompileShader(
+            std::ffi::CString::new(source_or_path).unwrap().as_ptr(),
+            std::ffi::CString::new(defines).unwrap().as_ptr(),
+            num_defines,
+            std::ffi::CString::new(include_dirs).unwrap().as_ptr(),
+            num_include_dirs,
+            from_memory,
+        )
+    }
+}
 pub fn create_pipeline(desc: *mut PipelineDesc) -> Pipeline {
     Pipeline(unsafe { sys::rfxCreatePipeline(desc as *mut sys::RfxPipelineDesc) })
 }
@@ -3565,6 +4453,9 @@ pub fn get_command_list() -> CommandList {
 pub fn create_command_list(queue_type: QueueType) -> CommandList {
     CommandList(unsafe { sys::rfxCreateCommandList(queue_type as u32) })
 }
+pub fn create_bundle() -> Bundle {
+    Bundle(unsafe { sys::rfxCreateBundle() })
+}
 pub fn begin_frame() {
     unsafe { sys::rfxBeginFrame() }
 }
@@ -3574,6 +4465,24 @@ pub fn end_frame() {
 pub fn create_fence(initial_value: u64) -> Fence {
     Fence(unsafe { sys::rfxCreateFence(initial_value) })
 }
+pub fn create_render_queue() -> RenderQueue {
+    RenderQueue(unsafe { sys::rfxCreateRenderQueue() })
+}
+pub fn create_geometry_pool(desc: *mut GeometryPoolDesc) -> GeometryPool {
+    GeometryPool(unsafe { sys::rfxCreateGeometryPool(desc as *mut sys::RfxGeometryPoolDesc) })
+}
+pub fn create_frame_graph() -> FrameGraph {
+    FrameGraph(unsafe { sys::rfxCreateFrameGraph() })
+}
+pub fn submit_uploads() -> u64 {
+    unsafe { sys::rfxSubmitUploads() }
+}
+pub fn is_upload_complete(value: u64) -> bool {
+    unsafe { sys::rfxIsUploadComplete(value) }
+}
+pub fn get_upload_fence() -> Fence {
+    Fence(unsafe { sys::rfxGetUploadFence() })
+}
 pub fn begin_marker(name: &str) {
     unsafe { sys::rfxBeginMarker(std::ffi::CString::new(name).unwrap().as_ptr()) }
 }
@@ -3586,6 +4495,9 @@ pub fn marker(name: &str) {
 pub fn get_gpu_timestamps(out_timestamps: *mut GpuTimestamp, max_count: u32) -> u32 {
     unsafe { sys::rfxGetGpuTimestamps(out_timestamps as *mut sys::RfxGpuTimestamp, max_count) }
 }
+pub fn get_frame_stats(out_stats: *mut FrameStats) {
+    unsafe { sys::rfxGetFrameStats(out_stats as *mut sys::RfxFrameStats) }
+}
 pub fn create_query_pool(r#type: QueryType, capacity: u32) -> QueryPool {
     QueryPool(unsafe { sys::rfxCreateQueryPool(r#type as u32, capacity) })
 }
@@ -3631,3 +4543,6 @@ pub fn is_upscaler_supported(r#type: UpscalerType) -> bool {
 pub fn create_upscaler(desc: *mut UpscalerDesc) -> Upscaler {
     Upscaler(unsafe { sys::rfxCreateUpscaler(desc as *mut sys::RfxUpscalerDesc) })
 }
+pub fn set_allocator(allocator: *mut Allocator) {
+    unsafe { sys::rfxSetAllocator(allocator as *mut sys::RfxAllocator) }
+}
@@ -94,7 +94,7 @@ int main() {
         // async commandlist
         rfxBeginCommandList(computeCmd);
 
-        rfxCmdTransitionTexture(computeCmd, currentTexture, RFX_STATE_SHADER_WRITE);
+        rfxCmdTransitionTexture(computeCmd, currentTexture, RFX_STATE_COMPUTE_WRITE);
         rfxCmdBindPipeline(computeCmd, computePipeline);
 
         Uniforms u = { (float)rfxGetTime(), 1280, 720, rfxGetTextureId(currentTexture) };
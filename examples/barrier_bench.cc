@@ -0,0 +1,89 @@
+#include "rafx.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#define FRAME_COUNT 64
+
+// usage: barrier_bench [--gpu]
+// Measures the CPU cost of batching resource transitions, from 100 up to 10k per flush. Half of them hit buffers, half hit
+// 4-mip, 6-layer textures. Runs on the NONE backend unless --gpu is passed, so only the batching itself is timed.
+int main(int argc, char** argv) {
+    bool gpu = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--gpu"))
+            gpu = true;
+    }
+
+    if (!rfxInitHeadless(gpu ? RFX_BACKEND_DEFAULT : RFX_BACKEND_NONE, 64, 64)) {
+        fprintf(stderr, "Failed to initialize\n");
+        return 1;
+    }
+
+    const int counts[] = { 100, 1000, 10000 };
+    for (int count : counts) {
+        std::vector<RfxBuffer> buffers;
+        std::vector<RfxTexture> textures;
+        for (int i = 0; i < count / 2; i++)
+            buffers.push_back(rfxCreateBuffer(256, 0, RFX_USAGE_SHADER_RESOURCE_STORAGE, RFX_MEM_GPU_ONLY, NULL));
+
+        RfxTextureDesc td = {};
+        td.width = 16;
+        td.height = 16;
+        td.depth = 1;
+        td.mipLevels = 4;
+        td.arrayLayers = 6;
+        td.format = RFX_FORMAT_RGBA8_UNORM;
+        td.sampleCount = 1;
+        td.usage = RFX_TEXTURE_USAGE_SHADER_RESOURCE | RFX_TEXTURE_USAGE_STORAGE;
+        for (int i = 0; i < count - count / 2; i++)
+            textures.push_back(rfxCreateTextureEx(&td));
+
+        double best = 1e30;
+        double total = 0.0;
+        for (int frame = 0; frame < FRAME_COUNT; frame++) {
+            rfxBeginFrame();
+            RfxCommandList cmd = rfxGetCommandList();
+
+            // the first use in a list only records the state (it's patched in at submit), so go through a second state to
+            // make every timed call a real transition
+            RfxResourceState first = (frame & 1) ? RFX_STATE_SHADER_WRITE : RFX_STATE_SHADER_READ;
+            RfxResourceState state = (frame & 1) ? RFX_STATE_SHADER_READ : RFX_STATE_SHADER_WRITE;
+            for (RfxBuffer b : buffers)
+                rfxCmdTransitionBuffer(cmd, b, first);
+            for (RfxTexture t : textures)
+                rfxCmdTransitionTexture(cmd, t, first);
+
+            auto start = std::chrono::high_resolution_clock::now();
+            for (RfxBuffer b : buffers)
+                rfxCmdTransitionBuffer(cmd, b, state);
+            for (RfxTexture t : textures)
+                rfxCmdTransitionTexture(cmd, t, state);
+            // beginning a pass flushes everything gathered above in one batch
+            rfxCmdBeginSwapchainRenderPass(cmd, RFX_FORMAT_UNKNOWN, RFX_COLOR(0, 0, 0, 255));
+            auto end = std::chrono::high_resolution_clock::now();
+
+            rfxCmdEndRenderPass(cmd);
+            rfxEndFrame();
+
+            double us = std::chrono::duration<double, std::micro>(end - start).count();
+            total += us;
+            if (us < best)
+                best = us;
+        }
+
+        printf(
+            "%6d transitions/flush: best %9.1f us, avg %9.1f us, %6.1f ns per transition\n", count, best, total / FRAME_COUNT,
+            best * 1000.0 / count
+        );
+
+        for (RfxBuffer b : buffers)
+            rfxDestroyBuffer(b);
+        for (RfxTexture t : textures)
+            rfxDestroyTexture(t);
+    }
+
+    return 0;
+}
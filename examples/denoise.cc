@@ -507,7 +507,8 @@ struct App {
 
     void CreateCameraBuffers() {
         for (int i = 0; i < kFrameCount; i++) {
-            camBuffers[i] = rfxCreateBuffer(sizeof(CameraData), 0, RFX_USAGE_SHADER_RESOURCE, RFX_MEM_CPU_TO_GPU, nullptr);
+            camBuffers[i] =
+                rfxCreateBuffer(sizeof(CameraData), 0, RFX_USAGE_SHADER_RESOURCE | RFX_USAGE_PERSISTENT_MAP, RFX_MEM_CPU_TO_GPU, nullptr);
         }
     }
 
@@ -1,6 +1,7 @@
 #include "rafx.h"
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 const char* shaderSource = R"(
@@ -61,7 +62,21 @@ typedef struct {
     float pad[2];
 } PushConsts;
 
-int main(void) {
+// usage: low_latency [--frames 1..4] [--bench seconds] [--ll]
+int main(int argc, char** argv) {
+    int framesInFlight = 3;
+    double benchSeconds = 0.0;
+    bool lowLatencyMode = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--frames") && i + 1 < argc)
+            framesInFlight = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--bench") && i + 1 < argc)
+            benchSeconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--ll"))
+            lowLatencyMode = true;
+    }
+
+    rfxSetFramesInFlight(framesInFlight);
     if (!rfxOpenWindow("Rafx Low Latency Demo", 1280, 720))
         return 1;
 
@@ -91,10 +106,16 @@ int main(void) {
 
     RfxPipeline pipeline = rfxCreatePipeline(&pipelineDesc);
 
-    bool lowLatencyMode = false;
     bool boostMode = false;
     double lastReportTime = rfxGetTime();
 
+    // benchmark
+    double benchStart = 0.0;
+    double frameTimeSum = 0.0, frameTimeMax = 0.0;
+    double latencySum = 0.0;
+    uint32_t frameCount = 0, latencyCount = 0;
+    uint64_t lastLatencySample = 0;
+
     printf("Controls: [SPACE] Toggle Low Latency\n");
     rfxSetLowLatencyMode(lowLatencyMode, boostMode);
 
@@ -102,6 +123,29 @@ int main(void) {
         rfxLatencySleep();
         rfxPollInputEvents();
 
+        if (benchSeconds > 0.0) {
+            double now = rfxGetTime();
+            if (benchStart == 0.0) {
+                benchStart = now; // first frame is warmup
+            } else {
+                double dt = rfxGetDeltaTime() * 1000.0;
+                frameTimeSum += dt;
+                if (dt > frameTimeMax)
+                    frameTimeMax = dt;
+                frameCount++;
+
+                RfxLatencyReport report;
+                if (rfxGetLatencyReport(&report) && report.inputSampleTimeUs > 0 && report.presentEndTimeUs > report.inputSampleTimeUs &&
+                    report.inputSampleTimeUs != lastLatencySample) {
+                    latencySum += (double)(report.presentEndTimeUs - report.inputSampleTimeUs) / 1000.0;
+                    latencyCount++;
+                    lastLatencySample = report.inputSampleTimeUs;
+                }
+            }
+            if (now - benchStart > benchSeconds)
+                break;
+        }
+
         if (rfxIsKeyPressed(RFX_KEY_SPACE)) {
             lowLatencyMode = !lowLatencyMode;
             rfxSetLowLatencyMode(lowLatencyMode, boostMode);
@@ -118,7 +162,7 @@ int main(void) {
         float aspect = (float)winW / (float)winH;
 
         double currentTime = rfxGetTime();
-        if (currentTime - lastReportTime > 1.0) {
+        if (benchSeconds <= 0.0 && currentTime - lastReportTime > 1.0) {
             float fps = 1.0f / rfxGetDeltaTime();
             printf("[Stats] FPS: %4.0f | LL: %-3s", fps, lowLatencyMode ? "ON" : "OFF");
 
@@ -157,6 +201,17 @@ int main(void) {
         rfxEndFrame();
     }
 
+    if (benchSeconds > 0.0 && frameCount > 0) {
+        printf(
+            "[Bench] frames in flight: %d | LL: %-3s | frames: %u | avg: %6.3f ms | max: %6.3f ms", framesInFlight,
+            lowLatencyMode ? "ON" : "OFF", frameCount, frameTimeSum / frameCount, frameTimeMax
+        );
+        if (latencyCount > 0)
+            printf(" | input->present: %6.3f ms\n", latencySum / latencyCount);
+        else
+            printf(" | input->present: n/a (needs low latency support, try --ll)\n");
+    }
+
     rfxDestroyPipeline(pipeline);
     rfxDestroyShader(shader);
     rfxDestroyBuffer(vertexBuffer);
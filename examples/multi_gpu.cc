@@ -0,0 +1,85 @@
+#include "rafx.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_CONTEXTS 16
+#define WIDTH 256
+#define HEIGHT 256
+#define FRAME_COUNT 8
+
+// usage: multi_gpu [--none count]
+// Renders headlessly on every adapter in the box, one context each. With --none, spawns `count` contexts on the NONE backend
+// instead, which is handy on machines without a GPU.
+int main(int argc, char** argv) {
+    int noneCount = 0;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--none") && i + 1 < argc)
+            noneCount = atoi(argv[++i]);
+    }
+
+    RfxAdapterInfo adapters[MAX_CONTEXTS] = {};
+    uint32_t adapterCount = rfxEnumerateAdapters(adapters, MAX_CONTEXTS);
+    printf("Found %u adapter(s)\n", adapterCount);
+    for (uint32_t i = 0; i < adapterCount && i < MAX_CONTEXTS; i++) {
+        const RfxAdapterInfo* a = &adapters[i];
+        printf(
+            "  [%u] %s | %s | VRAM: %llu MB | shared: %llu MB | mesh: %s | rt: %s\n", i, a->name, a->integrated ? "integrated" : "discrete",
+            (unsigned long long)(a->videoMemorySize >> 20), (unsigned long long)(a->sharedSystemMemorySize >> 20),
+            (a->features & RFX_FEATURE_MESH_SHADER) ? "yes" : "no", (a->features & RFX_FEATURE_RAY_TRACING) ? "yes" : "no"
+        );
+    }
+
+    int contextCount = noneCount > 0 ? noneCount : (int)adapterCount;
+    if (contextCount > MAX_CONTEXTS)
+        contextCount = MAX_CONTEXTS;
+    if (contextCount == 0)
+        return 1;
+
+    RfxContext contexts[MAX_CONTEXTS] = {};
+    RfxBuffer readback[MAX_CONTEXTS] = {};
+
+    for (int i = 0; i < contextCount; i++) {
+        contexts[i] = rfxCreateContext();
+        rfxMakeContextCurrent(contexts[i]);
+
+        if (noneCount == 0)
+            rfxSelectAdapter((uint32_t)i);
+        if (!rfxInitHeadless(noneCount > 0 ? RFX_BACKEND_NONE : RFX_BACKEND_DEFAULT, WIDTH, HEIGHT)) {
+            fprintf(stderr, "Context %d: failed to initialize\n", i);
+            return 1;
+        }
+
+        readback[i] = rfxCreateBuffer(WIDTH * HEIGHT * 4, 0, RFX_USAGE_TRANSFER_DST, RFX_MEM_GPU_TO_CPU, NULL);
+    }
+
+    // interleave frames across contexts, each one clears to its own color
+    for (int frame = 0; frame < FRAME_COUNT; frame++) {
+        for (int i = 0; i < contextCount; i++) {
+            rfxMakeContextCurrent(contexts[i]);
+
+            rfxBeginFrame();
+            RfxCommandList cmd = rfxGetCommandList();
+            rfxCmdBeginSwapchainRenderPass(cmd, RFX_FORMAT_UNKNOWN, RFX_COLOR(i * 40 % 256, 128, 255 - i * 40 % 256, 255));
+            rfxCmdEndRenderPass(cmd);
+            if (frame == 0)
+                rfxCmdReadbackTextureToBuffer(cmd, rfxGetBackbufferTexture(), readback[i], 0);
+            rfxEndFrame();
+        }
+    }
+
+    // frame 0 has retired by now, every later rfxBeginFrame waited on it
+    for (int i = 0; i < contextCount; i++) {
+        rfxMakeContextCurrent(contexts[i]);
+
+        const unsigned char* px = (const unsigned char*)rfxMapBuffer(readback[i]);
+        if (px)
+            printf("Context %d: first pixel = (%u, %u, %u, %u)\n", i, px[0], px[1], px[2], px[3]);
+        rfxUnmapBuffer(readback[i]);
+
+        rfxDestroyBuffer(readback[i]);
+        rfxDestroyContext(contexts[i]);
+    }
+
+    return 0;
+}
@@ -71,6 +71,11 @@ typedef struct RfxMicromapImpl* RfxMicromap;
 typedef struct RfxUpscalerImpl* RfxUpscaler;
 typedef struct RfxFenceImpl* RfxFence;
 typedef struct RfxQueryPoolImpl* RfxQueryPool;
+typedef struct RfxContextImpl* RfxContext;
+typedef struct RfxRenderQueueImpl* RfxRenderQueue;
+typedef struct RfxGeometryPoolImpl* RfxGeometryPool;
+typedef struct RfxBundleImpl* RfxBundle;
+typedef struct RfxFrameGraphImpl* RfxFrameGraph;
 
 typedef enum {
     RFX_FILTER_NEAREST,
@@ -109,6 +114,7 @@ typedef RFX_ENUM(uint32_t, RfxBufferUsageFlags){
     RFX_USAGE_MICROMAP_BUILD_INPUT = RFX_BIT(9),               // Micromap Build Input
     RFX_USAGE_TRANSFER_SRC = RFX_BIT(10),                      // Allow buffer to be source of copy
     RFX_USAGE_TRANSFER_DST = RFX_BIT(11),                      // Allow buffer to be destination of copy
+    RFX_USAGE_PERSISTENT_MAP = RFX_BIT(12),                    // Keep CPU-visible memory mapped for the buffer's lifetime
 };
 
 typedef enum {
@@ -127,6 +133,14 @@ typedef enum {
     RFX_STATE_SCRATCH_BUFFER, // AS scratch buffer
     RFX_STATE_RESOLVE_SRC,
     RFX_STATE_RESOLVE_DST,
+    // Stage-qualified variants of SHADER_READ/SHADER_WRITE. Barriers into and out of these only wait on the named stages, which
+    // lets unrelated work (e.g. async compute next to graphics) overlap. Moving between two of them still emits a barrier.
+    // The named stages must exist on the queue recording the transition.
+    RFX_STATE_FRAGMENT_READ,   // SRV, read by fragment shaders only
+    RFX_STATE_GRAPHICS_READ,   // SRV, read by graphics shaders only
+    RFX_STATE_COMPUTE_READ,    // SRV, read by compute shaders only
+    RFX_STATE_COMPUTE_WRITE,   // UAV, accessed by compute shaders only
+    RFX_STATE_RAYTRACING_READ, // SRV, read by ray tracing shaders only
 } RfxResourceState;
 
 typedef enum {
@@ -419,6 +433,11 @@ typedef struct {
     float microseconds;
 } RfxGpuTimestamp;
 
+typedef struct {
+    uint32_t elidedStateCalls;   // NRI state calls dropped because the command list already had that state bound
+    uint32_t renderPassRestarts; // Render passes ended and reopened to flush a barrier recorded inside them
+} RfxFrameStats;
+
 typedef enum {
     RFX_INDEX_UINT16, // 16-bit index buffer
     RFX_INDEX_UINT32, // 32-bit index buffer
@@ -558,6 +577,9 @@ typedef struct {
     int sampleCount;
     RfxTextureUsageFlags usage;
     const void* initialData; // Initial data for mip 0, layer 0, (slice 0 if 3D)
+    // Optional, replaces initialData: tightly packed data for every subresource at [layer * mipLevels + mip] (NULL skips
+    // one). Streamed as a single batch behind one pair of barriers
+    const void* const* subresourceData;
 } RfxTextureDesc;
 
 typedef enum {
@@ -756,6 +778,23 @@ typedef RFX_ENUM(uint32_t, RfxFeatureSupportFlags){
     RFX_FEATURE_LOW_LATENCY = RFX_BIT(3),
 };
 
+typedef enum {
+    RFX_VENDOR_UNKNOWN,
+    RFX_VENDOR_NVIDIA,
+    RFX_VENDOR_AMD,
+    RFX_VENDOR_INTEL,
+} RfxVendor;
+
+typedef struct {
+    char name[256];
+    uint64_t videoMemorySize;        // bytes
+    uint64_t sharedSystemMemorySize; // bytes
+    uint32_t deviceId;
+    RfxVendor vendor;
+    bool integrated;
+    RfxFeatureSupportFlags features; // probed with the requested backend
+} RfxAdapterInfo;
+
 typedef enum {
     RFX_CURSOR_DEFAULT,
     RFX_CURSOR_ARROW,
@@ -874,16 +913,36 @@ typedef enum {
     RFX_KEY_MENU = 348
 } RfxKey;
 
+//
+// Context
+//
+
+// All rfx* calls operate on the calling thread's current context. A default context is current until another one is made
+// current, so single-device applications never have to touch this.
+RAFX_API RfxContext rfxCreateContext(void);
+RAFX_API void rfxDestroyContext(RfxContext context); // waits for the device to go idle
+RAFX_API void rfxMakeContextCurrent(RfxContext context); // NULL restores the default context
+RAFX_API RfxContext rfxGetCurrentContext(void);
+
 //
 // Window
 //
 
 RAFX_API void rfxRequestBackend(RfxBackend backend, bool enableValidation); // Do this *before* opening the window
 RAFX_API bool rfxOpenWindow(const char* title, int width, int height);
+// Create a device without a window or swapchain. rfxBeginFrame/rfxEndFrame cycle through offscreen backbuffers of the given size,
+// the current one is returned by rfxGetBackbufferTexture and is left in RFX_STATE_COPY_SRC at the end of the frame.
+RAFX_API bool rfxInitHeadless(RfxBackend backend, int width, int height);
+// Returns the total adapter count and fills up to `capacity` entries (pass NULL to only query the count).
+// Adapters are ordered by preference, index 0 is what gets picked by default.
+RAFX_API uint32_t rfxEnumerateAdapters(RfxAdapterInfo* adapters, uint32_t capacity);
+// Do this *before* opening the window. Window/headless init fails if the index is not below the rfxEnumerateAdapters count.
+RAFX_API void rfxSelectAdapter(uint32_t index);
 RAFX_API bool rfxSupportsFeatures(RfxFeatureSupportFlags features);
 RAFX_API RfxFeatureSupportFlags rfxGetSupportedFeatures(void);
 RAFX_API void rfxSetSampleCount(int count);
 RAFX_API void rfxSetAnisotropy(int level);
+RAFX_API void rfxSetFramesInFlight(int count); // 1..4, default is 3. Do this *before* opening the window
 RAFX_API void rfxSetWindowFlags(RfxWindowFlags flags);
 RAFX_API void rfxEnableWindowFlags(RfxWindowFlags flags);
 RAFX_API void rfxDisableWindowFlags(RfxWindowFlags flags);
@@ -920,14 +979,38 @@ RAFX_API uint32_t rfxGetCharPressed(void);
 // Resources
 //
 
+// Creating and destroying buffers, textures, samplers and acceleration structures is safe from any thread (make the context current
+// there first). Initial data is streamed right away and copied on the GPU at the start of the next frame.
+
 // Buffers
 RAFX_API RfxBuffer rfxCreateBuffer(size_t size, size_t stride, RfxBufferUsageFlags usage, RfxMemoryType memType, const void* initialData);
 RAFX_API void rfxDestroyBuffer(RfxBuffer buffer);
+// With `RFX_USAGE_PERSISTENT_MAP` these return the lifetime mapping and unmapping does nothing
 RAFX_API void* rfxMapBuffer(RfxBuffer buffer);
+RAFX_API void* rfxMapBufferRange(RfxBuffer buffer, uint64_t offset, uint64_t size);
 RAFX_API void rfxUnmapBuffer(RfxBuffer buffer);
+// Make CPU writes visible to the GPU / GPU writes visible to the CPU. Needed around persistent mappings, between writing
+// and submitting (flush) or between the GPU work finishing and reading (invalidate)
+RAFX_API void rfxFlushBufferRange(RfxBuffer buffer, uint64_t offset, uint64_t size);
+RAFX_API void rfxInvalidateBufferRange(RfxBuffer buffer, uint64_t offset, uint64_t size);
 RAFX_API uint32_t rfxGetBufferId(RfxBuffer buffer);
 RAFX_API uint64_t rfxGetBufferDeviceAddress(RfxBuffer buffer);
 
+// Transient per-frame data (uniforms, instance data, skinning palettes...), bump-allocated from a persistently mapped ring.
+// Each queued frame owns a slice of it that is recycled once the frame retires, so the memory is only valid for the frame
+// it was allocated in. The ring grows when a frame runs out. Safe to call from any thread between rfxBeginFrame and
+// rfxEndFrame
+typedef struct {
+    void* cpu;              // Write-only
+    RfxBuffer buffer;       // For rfxCmdBindVertexBufferEx/rfxCmdBindIndexBufferEx at `offset`
+    uint32_t bufferId;      // rfxGetBufferId(buffer), for bindless reads at `offset`
+    uint64_t offset;        // Into `buffer`
+    uint64_t deviceAddress; // Includes `offset`, 0 if not supported
+} RfxTransientAlloc;
+
+// `alignment` must be a power of two (0 = 16). Use 256 for constant buffer data
+RAFX_API RfxTransientAlloc rfxAllocTransient(uint64_t size, uint64_t alignment);
+
 // Textures
 RAFX_API RfxTexture
 rfxCreateTexture(int width, int height, RfxFormat format, int sampleCount, RfxTextureUsageFlags usage, const void* initialData);
@@ -941,6 +1024,10 @@ RAFX_API uint32_t rfxGetTextureId(RfxTexture texture);
 RAFX_API void* rfxGetTextureDescriptor(RfxTexture texture);
 RAFX_API RfxFormat rfxGetSwapChainFormat(void);
 RAFX_API RfxTexture rfxGetBackbufferTexture(void);
+// DDS & KTX2 (without supercompression) with every mip & layer, each subresource streamed straight out of a mapping of
+// the file in one batch. Cube maps come in as 6-layer arrays. `usage` 0 = shader resource. Returns NULL on failure
+RAFX_API RfxTexture rfxLoadTexture(const char* path, RfxTextureUsageFlags usage);
+RAFX_API RfxTexture rfxLoadTextureMem(const void* data, size_t size, RfxTextureUsageFlags usage);
 
 // Samplers
 RAFX_API RfxSampler rfxCreateSampler(RfxFilter filter, RfxAddressMode addressMode);
@@ -985,6 +1072,27 @@ RAFX_API RfxCommandList rfxCreateCommandList(RfxQueueType queueType);
 RAFX_API void rfxDestroyCommandList(RfxCommandList cmd);
 RAFX_API void rfxBeginCommandList(RfxCommandList cmd);
 RAFX_API void rfxEndCommandList(RfxCommandList cmd);
+// In deferred mode pipeline binds, dynamic state, push constants and draws/dispatches are encoded into a compact byte stream and
+// translated to NRI when the list is ended (or when a non-deferrable command needs the real command buffer). Off by default.
+RAFX_API void rfxSetCommandListDeferred(RfxCommandList cmd, bool deferred);
+// Lets a deferred list move a transition needed mid-pass in front of the pass instead of splitting it, when nothing earlier
+// in the pass required a state of that resource. Only enable it if every resource the pass's draws use is either listed in
+// RfxPassResource or transitioned through the list, resources only reached through bindless are invisible to the check.
+// Off by default.
+RAFX_API void rfxSetCommandListBarrierHoisting(RfxCommandList cmd, bool enabled);
+// Bundles record pipeline binds, dynamic state, push constants, buffer binds and draws once, for replay inside later render passes
+// with rfxCmdExecuteBundle. Vertex/index buffer states are captured at record time and transitioned by the executing list.
+// Everything the bundle references must outlive it. Recording anything else into a bundle list asserts.
+RAFX_API RfxBundle rfxCreateBundle(void);
+RAFX_API void rfxDestroyBundle(RfxBundle bundle);
+RAFX_API RfxCommandList rfxBeginBundle(RfxBundle bundle);
+RAFX_API void rfxEndBundle(RfxBundle bundle);
+RAFX_API void rfxCmdExecuteBundle(RfxCommandList cmd, RfxBundle bundle);
+// Run an ended graphics list as part of this frame. Queued lists execute after the main list, in queue order, within the single
+// submit done by rfxEndFrame. Safe to call from worker threads (with the right context current) before rfxEndFrame.
+// Every list tracks resource states on its own, so lists can be recorded in parallel and in any order: the states a list
+// expects on entry are transitioned to when it's submitted, against what the lists submitted before it left behind.
+RAFX_API void rfxQueueCommandList(RfxCommandList cmd);
 
 RAFX_API void rfxBeginFrame(void);
 RAFX_API void rfxEndFrame(void);
@@ -994,6 +1102,7 @@ RAFX_API void rfxDestroyFence(RfxFence fence);
 RAFX_API void rfxWaitFence(RfxFence fence, uint64_t value); // CPU wait
 RAFX_API uint64_t rfxGetFenceValue(RfxFence fence);
 
+// Transitions resources into the states the list expects first, then submits it. Submission order is the order of these calls.
 RAFX_API void rfxSubmitCommandListAsync(
     RfxCommandList cmd, RfxFence* waitFences, uint64_t* waitValues, uint32_t waitCount, RfxFence* signalFences, uint64_t* signalValues,
     uint32_t signalCount
@@ -1007,6 +1116,22 @@ RAFX_API void rfxCmdBeginSwapchainRenderPass(RfxCommandList cmd, RfxFormat depth
 RAFX_API void rfxCmdBeginRenderPass(
     RfxCommandList cmd, RfxTexture* colors, uint32_t colorCount, RfxTexture depth, RfxColor clearColor, uint32_t viewMask
 );
+// Resources that draws inside a pass will use, transitioned together with the attachments before the pass opens. Without them,
+// a transition needed mid-pass forces the pass to be split (counted in RfxFrameStats), unless the list hoists it, see
+// rfxSetCommandListBarrierHoisting.
+typedef struct {
+    RfxTexture texture; // One of texture / buffer
+    RfxBuffer buffer;
+    RfxResourceState state;
+} RfxPassResource;
+
+RAFX_API void rfxCmdBeginSwapchainRenderPassEx(
+    RfxCommandList cmd, RfxFormat depthStencilFormat, RfxColor clearColor, const RfxPassResource* resources, uint32_t resourceCount
+);
+RAFX_API void rfxCmdBeginRenderPassEx(
+    RfxCommandList cmd, RfxTexture* colors, uint32_t colorCount, RfxTexture depth, RfxColor clearColor, uint32_t viewMask,
+    const RfxPassResource* resources, uint32_t resourceCount
+);
 RAFX_API void rfxCmdEndRenderPass(RfxCommandList cmd);
 
 // Clear currently bound render targets (must be called inside a render pass)
@@ -1031,6 +1156,9 @@ rfxCmdSetSampleLocations(RfxCommandList cmd, const RfxSampleLocation* locations,
 
 RAFX_API void rfxCmdBindVertexBuffer(RfxCommandList cmd, RfxBuffer buffer);
 RAFX_API void rfxCmdBindIndexBuffer(RfxCommandList cmd, RfxBuffer buffer, RfxIndexType indexType);
+// Bind at a byte offset, for many meshes sharing one large buffer
+RAFX_API void rfxCmdBindVertexBufferEx(RfxCommandList cmd, RfxBuffer buffer, size_t offset);
+RAFX_API void rfxCmdBindIndexBufferEx(RfxCommandList cmd, RfxBuffer buffer, size_t offset, RfxIndexType indexType);
 RAFX_API void rfxCmdPushConstants(RfxCommandList cmd, const void* data, size_t size);
 
 //
@@ -1039,6 +1167,11 @@ RAFX_API void rfxCmdPushConstants(RfxCommandList cmd, const void* data, size_t s
 
 RAFX_API void rfxCmdDraw(RfxCommandList cmd, uint32_t vertexCount, uint32_t instanceCount);
 RAFX_API void rfxCmdDrawIndexed(RfxCommandList cmd, uint32_t indexCount, uint32_t instanceCount);
+RAFX_API void rfxCmdDrawEx(RfxCommandList cmd, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance);
+// `baseVertex` is added to every index before fetching the vertex
+RAFX_API void rfxCmdDrawIndexedEx(
+    RfxCommandList cmd, uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t baseVertex, uint32_t firstInstance
+);
 RAFX_API void rfxCmdDispatch(RfxCommandList cmd, uint32_t x, uint32_t y, uint32_t z);
 
 // Indirect
@@ -1064,6 +1197,115 @@ RAFX_API void rfxCmdDrawMeshTasksIndirectCount(
     uint32_t stride
 );
 
+//
+// Render queue
+//
+
+typedef struct {
+    RfxPipeline pipeline;
+    RfxBuffer vertexBuffer; // Optional
+    RfxBuffer indexBuffer;  // Optional; drawn with rfxCmdDrawIndexed when set
+    RfxIndexType indexType;
+    size_t vertexOffset;       // Byte offset the vertex buffer is bound at
+    size_t indexOffset;        // Byte offset the index buffer is bound at
+    uint32_t count;            // Vertex count, or index count when `indexBuffer` is set
+    uint32_t instanceCount;    // 0 is treated as 1
+    uint32_t first;            // First vertex, or first index when `indexBuffer` is set
+    int32_t baseVertex;        // Added to every index, indexed only
+    uint32_t firstInstance;    // Added to the instance index
+    const void* pushConstants; // Optional; copied on add
+    uint32_t pushConstantsSize;
+    float depth;      // View-space distance, >= 0
+    uint8_t layer;    // 0..15, most significant part of the key (e.g. 0 = opaque, 1 = transparent)
+    bool backToFront; // Sort by descending depth before state (transparent), instead of by state then ascending depth
+} RfxDrawPacket;
+
+// Collects draw packets and emits them sorted by a 64-bit key (layer, then state and depth) to minimize pipeline and buffer switches.
+RAFX_API RfxRenderQueue rfxCreateRenderQueue(void);
+RAFX_API void rfxDestroyRenderQueue(RfxRenderQueue queue);
+RAFX_API void rfxResetRenderQueue(RfxRenderQueue queue);
+RAFX_API void rfxAddDrawPacket(RfxRenderQueue queue, const RfxDrawPacket* packet);
+// Sorts the queue and records every packet into `cmd`, which must be inside a render pass. The queue is left intact.
+RAFX_API void rfxCmdDrawRenderQueue(RfxCommandList cmd, RfxRenderQueue queue);
+
+//
+// Geometry pool
+//
+
+typedef struct {
+    uint32_t vertexCapacity; // In vertices
+    uint32_t indexCapacity;  // In indices
+    uint32_t vertexStride;
+    RfxIndexType indexType;
+    uint32_t maxMeshes;
+} RfxGeometryPoolDesc;
+
+// GPU layout of a mesh table entry, see `GetMeshRecord` in rafx.slang
+typedef struct {
+    uint32_t vertexOffset; // In vertices; pass as baseVertex
+    uint32_t vertexCount;
+    uint32_t indexOffset; // In indices; pass as firstIndex
+    uint32_t indexCount;
+    float boundsCenter[3];
+    float boundsRadius;
+} RfxMeshRecord;
+
+typedef struct {
+    const void* vertices;
+    uint32_t vertexCount;
+    const void* indices; // Optional
+    uint32_t indexCount;
+    float boundsCenter[3];
+    float boundsRadius;
+} RfxMeshDesc;
+
+// One vertex buffer, one index buffer and a mesh record table, with meshes suballocated out of them. Uploads go through the
+// copy queue like rfxUploadBuffer and land with the next rfxSubmitUploads, freed ranges are reused once the frames that could
+// read them have retired.
+RAFX_API RfxGeometryPool rfxCreateGeometryPool(const RfxGeometryPoolDesc* desc);
+RAFX_API void rfxDestroyGeometryPool(RfxGeometryPool pool);
+// Returns the mesh index into the record table, or UINT32_MAX if the pool is out of space
+RAFX_API uint32_t rfxAllocMesh(RfxGeometryPool pool, const RfxMeshDesc* desc);
+RAFX_API void rfxFreeMesh(RfxGeometryPool pool, uint32_t mesh);
+RAFX_API RfxMeshRecord rfxGetMeshRecord(RfxGeometryPool pool, uint32_t mesh);
+RAFX_API RfxBuffer rfxGetGeometryPoolVertexBuffer(RfxGeometryPool pool);
+RAFX_API RfxBuffer rfxGetGeometryPoolIndexBuffer(RfxGeometryPool pool);
+// Pass rfxGetBufferId of this to shaders for vertex pulling. Transition it and the pool buffers to a shader read state in
+// the list first, that's how the list knows to wait for their uploads
+RAFX_API RfxBuffer rfxGetGeometryPoolMeshTable(RfxGeometryPool pool);
+// Binds the pool buffers and draws the mesh with its offsets
+RAFX_API void rfxCmdDrawMesh(RfxCommandList cmd, RfxGeometryPool pool, uint32_t mesh, uint32_t instanceCount);
+
+//
+// Frame graph
+//
+
+// Passes declare what they read and write up front. rfxCmdExecuteFrameGraph then culls passes whose results are never used,
+// places transient resources with disjoint lifetimes in shared memory and transitions everything once per pass boundary, so
+// draws inside a pass never have to restart it for a barrier.
+// Declarations are kept until rfxResetFrameGraph; an identical graph reuses the previous placement.
+typedef void (*RfxGraphPassFunc)(RfxCommandList cmd, void* userData);
+
+RAFX_API RfxFrameGraph rfxCreateFrameGraph(void);
+RAFX_API void rfxDestroyFrameGraph(RfxFrameGraph graph);
+RAFX_API void rfxResetFrameGraph(RfxFrameGraph graph);
+// Resource handles are indices local to the graph
+RAFX_API uint32_t rfxGraphImportTexture(RfxFrameGraph graph, RfxTexture texture);
+RAFX_API uint32_t rfxGraphImportBuffer(RfxFrameGraph graph, RfxBuffer buffer);
+// Transients are owned by the graph and their contents are undefined when their first pass runs. `initialData` is ignored.
+RAFX_API uint32_t rfxGraphCreateTexture(RfxFrameGraph graph, const RfxTextureDesc* desc);
+RAFX_API uint32_t rfxGraphCreateBuffer(RfxFrameGraph graph, size_t size, size_t stride, RfxBufferUsageFlags usage);
+// Passes run in the order they are added, outside of any render pass. Passes that write an imported resource or declare
+// no writes at all are never culled.
+RAFX_API uint32_t rfxGraphAddPass(RfxFrameGraph graph, const char* name, RfxGraphPassFunc func, void* userData);
+RAFX_API void rfxGraphRead(RfxFrameGraph graph, uint32_t pass, uint32_t resource, RfxResourceState state);
+RAFX_API void rfxGraphWrite(RfxFrameGraph graph, uint32_t pass, uint32_t resource, RfxResourceState state);
+// Only valid inside pass callbacks for transients
+RAFX_API RfxTexture rfxGraphGetTexture(RfxFrameGraph graph, uint32_t resource);
+RAFX_API RfxBuffer rfxGraphGetBuffer(RfxFrameGraph graph, uint32_t resource);
+// Must be called outside of a render pass
+RAFX_API void rfxCmdExecuteFrameGraph(RfxCommandList cmd, RfxFrameGraph graph);
+
 //
 // Transfer, Copy, Blit
 //
@@ -1071,6 +1313,22 @@ RAFX_API void rfxCmdDrawMeshTasksIndirectCount(
 RAFX_API void rfxCmdCopyBuffer(RfxCommandList cmd, RfxBuffer src, size_t srcOffset, RfxBuffer dst, size_t dstOffset, size_t size);
 RAFX_API void rfxCmdCopyTexture(RfxCommandList cmd, RfxTexture src, RfxTexture dst);
 RAFX_API void rfxCmdUploadTexture(RfxCommandList cmd, RfxTexture dst, const void* data, uint32_t mip, uint32_t layer);
+// Fills mips 1.. of every layer of a 2D texture from mip 0 with a box filter. The texture needs shader resource & storage
+// usage and a storage-capable format (no sRGB), and can't be a view or 3D. Rebinds the caller's pipeline afterwards, push
+// constants have to be set again
+RAFX_API void rfxCmdGenerateMips(RfxCommandList cmd, RfxTexture texture);
+
+typedef struct {
+    uint64_t offset;
+    const void* data;
+    uint64_t size;
+} RfxBufferUpdate;
+
+// Partial updates of any buffer, GPU_ONLY included. Data is streamed right away and copied at this point in the list,
+// the buffer goes back to the state the list left it in (shader read if it hadn't used it yet)
+RAFX_API void rfxCmdUpdateBuffer(RfxCommandList cmd, RfxBuffer buffer, uint64_t offset, const void* data, uint64_t size);
+// Many updates behind a single pair of barriers. Updates that continue where the previous one ended share a copy
+RAFX_API void rfxCmdUpdateBufferScatter(RfxCommandList cmd, RfxBuffer buffer, const RfxBufferUpdate* updates, uint32_t updateCount);
 // Buffer must be `RFX_USAGE_TRANSFER_DST` and `RFX_MEM_GPU_TO_CPU`
 RAFX_API void rfxCmdReadbackTextureToBuffer(RfxCommandList cmd, RfxTexture src, RfxBuffer dst, uint64_t dstOffset);
 
@@ -1084,6 +1342,23 @@ RAFX_API void rfxCmdCopyMicromap(RfxCommandList cmd, RfxMicromap dst, RfxMicroma
 RAFX_API void
 rfxCmdCopyAccelerationStructure(RfxCommandList cmd, RfxAccelerationStructure dst, RfxAccelerationStructure src, RfxCopyMode mode);
 
+//
+// Copy-queue uploads
+//
+
+// Data is copied into staging memory right away and goes out with the next rfxSubmitUploads on the copy queue. Safe to
+// call from any thread
+RAFX_API void rfxUploadBuffer(RfxBuffer dst, uint64_t dstOffset, const void* data, uint64_t size);
+// `data` holds tightly packed rows of a single subresource
+RAFX_API void rfxUploadTexture(RfxTexture dst, const void* data, uint32_t mip, uint32_t layer);
+// Submits everything uploaded so far, after the frames submitted so far are done with the resources. Returns the upload
+// fence value signaled on completion, or 0 if there was nothing to submit. Command lists submitted afterwards wait for
+// it on their own if they use the uploaded resources, no barriers needed. Call from the thread that ends frames
+RAFX_API uint64_t rfxSubmitUploads(void);
+RAFX_API bool rfxIsUploadComplete(uint64_t value);
+// For waiting on an upload from another queue or the CPU (rfxWaitFence)
+RAFX_API RfxFence rfxGetUploadFence(void);
+
 //
 // Explicit barriers
 //
@@ -1107,6 +1382,7 @@ RAFX_API void rfxCmdMarker(RfxCommandList cmd, const char* name);
 RAFX_API void rfxCmdBeginProfile(RfxCommandList cmd, const char* name);
 RAFX_API void rfxCmdEndProfile(RfxCommandList cmd);
 RAFX_API uint32_t rfxGetGpuTimestamps(RfxGpuTimestamp* outTimestamps, uint32_t maxCount);
+RAFX_API void rfxGetFrameStats(RfxFrameStats* outStats); // CPU-side counters of the last ended frame
 
 // Occlusion queries
 RAFX_API RfxQueryPool rfxCreateQueryPool(RfxQueryType type, uint32_t capacity);
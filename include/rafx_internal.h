@@ -33,10 +33,16 @@
 #    pragma GCC diagnostic pop
 #endif
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
 #include <functional>
+#include <mutex>
 #include <vector>
 #include <string>
 #include <set>
+#include <unordered_map>
 #include <variant>
 
 // platform definitions
@@ -164,6 +170,8 @@ template <typename T>
 using RfxVector = std::vector<T, RfxStlAllocator<T>>;
 template <typename T>
 using RfxSet = std::set<T, std::less<T>, RfxStlAllocator<T>>;
+template <typename K, typename V>
+using RfxHashMap = std::unordered_map<K, V, std::hash<K>, std::equal_to<K>, RfxStlAllocator<std::pair<const K, V>>>;
 
 void* NRI_CALL InternalNriAlloc(void* userArg, size_t size, size_t alignment);
 void* NRI_CALL InternalNriRealloc(void* userArg, void* memory, size_t size, size_t alignment);
@@ -173,10 +181,15 @@ void NRI_CALL InternalNriFree(void* userArg, void* memory);
 // Resource impls
 //
 
+// subresource states after everything submitted so far, command lists track their own until BarrierBatcher::Resolve.
+// All subresources share `uniformState` until one of them is transitioned on its own
 struct RfxTextureSharedState {
-    RfxVector<RfxResourceState> subresourceStates; // size() = mipLevels * arrayLayers
+    RfxResourceState uniformState = RFX_STATE_UNDEFINED;
+    bool uniform = true;
+    RfxVector<RfxResourceState> subresourceStates; // size() = mipLevels * arrayLayers, only used while !uniform
     uint32_t totalMips;
     uint32_t totalLayers;
+    uint64_t uploadValue = 0; // UploadFence value of the last copy-queue upload into it
     int refCount = 1;
 
     void AddRef() {
@@ -190,13 +203,47 @@ struct RfxTextureSharedState {
 
     // Get gets the state of specific subresource
     RfxResourceState Get(uint32_t mip, uint32_t layer) {
-        return subresourceStates[layer * totalMips + mip];
+        return uniform ? uniformState : subresourceStates[layer * totalMips + mip];
     }
 
     // Set sets the state of specific subresource
     void Set(uint32_t mip, uint32_t layer, RfxResourceState state) {
+        if (uniform) {
+            if (state == uniformState)
+                return;
+            if (totalMips * totalLayers == 1) {
+                uniformState = state;
+                return;
+            }
+            Expand();
+        }
         subresourceStates[layer * totalMips + mip] = state;
     }
+
+    // SetAll sets the state of every subresource
+    void SetAll(RfxResourceState state) {
+        uniformState = state;
+        uniform = true;
+    }
+
+    // Expand switches to per-subresource states
+    void Expand() {
+        if (!uniform)
+            return;
+        subresourceStates.assign(totalMips * totalLayers, uniformState);
+        uniform = false;
+    }
+
+    // Compact switches back to a single state if all subresources agree
+    void Compact() {
+        if (uniform)
+            return;
+        for (RfxResourceState state : subresourceStates) {
+            if (state != subresourceStates[0])
+                return;
+        }
+        SetAll(subresourceStates[0]);
+    }
 };
 
 struct RfxTextureImpl {
@@ -221,6 +268,7 @@ struct RfxTextureImpl {
     bool isView = false;
 
     RfxTextureSharedState* state = nullptr;
+    RfxVector<RfxTexture> mipViews; // single mip & layer views for rfxCmdGenerateMips, [layer * mipNum + mip]
 };
 
 struct RfxSamplerImpl {
@@ -236,9 +284,13 @@ struct RfxBufferImpl {
     uint32_t stride;
     uint32_t bindlessIndex;
 
+    // state after everything submitted so far, command lists track their own until BarrierBatcher::Resolve
     RfxResourceState currentState = RFX_STATE_UNDEFINED;
     nri::AccessBits currentAccess = nri::AccessBits::NONE;
     nri::StageBits currentStage = nri::StageBits::NONE;
+    uint64_t uploadValue = 0; // UploadFence value of the last copy-queue upload into it
+
+    uint8_t* persistentData = nullptr; // lifetime mapping of RFX_USAGE_PERSISTENT_MAP buffers
 };
 
 struct RfxShaderImpl {
@@ -347,45 +399,401 @@ struct RfxFenceImpl {
     uint64_t value; // expected next value
 };
 
+// first-fit free list over [0, capacity), neighbours are merged back on free
+struct RfxRangeAllocator {
+    static constexpr uint32_t INVALID = (uint32_t)-1;
+
+    struct Range {
+        uint32_t offset;
+        uint32_t size;
+    };
+    RfxVector<Range> freeRanges; // sorted by offset
+
+    void Init(uint32_t capacity) {
+        freeRanges.clear();
+        if (capacity > 0)
+            freeRanges.push_back({ 0, capacity });
+    }
+
+    uint32_t Alloc(uint32_t size) {
+        for (size_t i = 0; i < freeRanges.size(); ++i) {
+            Range& r = freeRanges[i];
+            if (r.size < size)
+                continue;
+            uint32_t offset = r.offset;
+            r.offset += size;
+            r.size -= size;
+            if (r.size == 0)
+                freeRanges.erase(freeRanges.begin() + i);
+            return offset;
+        }
+        return INVALID;
+    }
+
+    void Free(uint32_t offset, uint32_t size) {
+        if (size == 0)
+            return;
+        auto next = std::lower_bound(freeRanges.begin(), freeRanges.end(), offset, [](const Range& r, uint32_t o) { return r.offset < o; });
+        auto it = freeRanges.insert(next, { offset, size });
+
+        if (it + 1 != freeRanges.end() && it->offset + it->size == (it + 1)->offset) {
+            it->size += (it + 1)->size;
+            freeRanges.erase(it + 1);
+        }
+        if (it != freeRanges.begin() && (it - 1)->offset + (it - 1)->size == it->offset) {
+            (it - 1)->size += it->size;
+            freeRanges.erase(it);
+        }
+    }
+};
+
+struct RfxGeometryPoolImpl {
+    RfxBuffer vertexBuffer;
+    RfxBuffer indexBuffer;
+    RfxBuffer meshTable; // RfxMeshRecord[maxMeshes]
+    uint32_t vertexStride;
+    uint32_t indexSize;
+    RfxIndexType indexType;
+
+    std::mutex mutex;
+    RfxRangeAllocator vertexRanges; // in vertices
+    RfxRangeAllocator indexRanges;  // in indices
+    RfxVector<RfxMeshRecord> records;
+    RfxVector<uint8_t> live;
+    RfxVector<uint32_t> freeMeshes;
+};
+
+struct RfxRenderQueueImpl {
+    struct Packet {
+        RfxPipeline pipeline;
+        RfxBuffer vertexBuffer;
+        RfxBuffer indexBuffer;
+        RfxIndexType indexType;
+        uint64_t vertexOffset;
+        uint64_t indexOffset;
+        uint32_t count;
+        uint32_t instanceCount;
+        uint32_t first;
+        int32_t baseVertex;
+        uint32_t firstInstance;
+        uint32_t pushOffset; // into pushData
+        uint32_t pushSize;
+    };
+
+    RfxVector<Packet> packets;
+    RfxVector<uint8_t> pushData;
+
+    // (key, packet index) pairs, plus scratch for the radix passes
+    RfxVector<uint64_t> keys;
+    RfxVector<uint64_t> keysTmp;
+    RfxVector<uint32_t> order;
+    RfxVector<uint32_t> orderTmp;
+};
+
+struct RfxFrameGraphImpl {
+    struct Access {
+        uint32_t resource;
+        RfxResourceState state;
+        bool write;
+    };
+
+    struct Pass {
+        const char* name;
+        RfxGraphPassFunc func;
+        void* userData;
+        RfxVector<Access> accesses;
+        bool culled;
+    };
+
+    // everything a transient's placement depends on, compared across executions to reuse the previous placement
+    struct TransientKey {
+        bool isBuffer;
+        uint32_t width, height, depth, mipLevels, arrayLayers;
+        RfxFormat format;
+        int sampleCount;
+        uint32_t usage;
+        uint64_t size;
+        uint32_t stride;
+        uint32_t firstPass, lastPass;
+
+        bool operator==(const TransientKey&) const = default;
+    };
+
+    struct Resource {
+        RfxTexture texture; // imported, or placed by the last execution
+        RfxBuffer buffer;
+        bool imported;
+        TransientKey key;
+        bool needed;
+        uint32_t transient; // index into `transients`, or -1 if unused
+    };
+
+    struct Transient {
+        TransientKey key;
+        RfxTexture texture;
+        RfxBuffer buffer;
+
+        // transients placed over the same memory that ran before it, and whether one runs after it (so its last use in
+        // the previous execution comes before this one's first)
+        RfxVector<uint32_t> aliasedBefore;
+        bool aliasedAfter;
+        RfxResourceState lastState; // of the latest pass in this execution that accessed it
+    };
+
+    RfxVector<Pass> passes;
+    RfxVector<Resource> resources;
+
+    RfxVector<Transient> transients;
+    RfxVector<nri::Memory*> heaps; // shared by all transients of one memory type
+};
+
 //
 // Command list and barrier batching
 //
 
+// tracks states per command list, so lists can be recorded in parallel and in any order. First uses emit no barrier,
+// Resolve patches the globally known states into them when the list is submitted
 struct BarrierBatcher {
+    // a subresource this list hasn't touched yet, one past the last real state
+    static constexpr RfxResourceState UNTRACKED = (RfxResourceState)(RFX_STATE_RAYTRACING_READ + 1);
+
     RfxVector<nri::BufferBarrierDesc> bufferBarriers;
     RfxVector<nri::TextureBarrierDesc> textureBarriers;
     RfxVector<nri::GlobalBarrierDesc> globalBarriers;
 
+    struct TrackedBuffer {
+        RfxBuffer buffer;
+        RfxResourceState first; // expected on entry, UNDEFINED if the list discards the contents
+        RfxResourceState current;
+        nri::AccessBits access;
+        nri::StageBits stage;
+
+        // bufferBarriers[pendingSlot] of the batch `pendingBatch` transitions this buffer
+        uint64_t pendingBatch;
+        uint32_t pendingSlot;
+
+        // last batch that required a state of it, and the last one before the requirement that opened the pending
+        // transition. See PendingUsedSince
+        uint64_t useBatch;
+        uint64_t pendingUseBatch;
+    };
+
+    // while `uniform` all subresources share the states below. After a partial transition first, current and batch start
+    // states move to `states`, `subresourceNum` each, laid out like RfxTextureSharedState
+    struct TrackedTexture {
+        nri::Texture* texture;
+        RfxTextureSharedState* shared;
+        uint32_t states;
+        uint32_t subresourceNum;
+        uint64_t pendingBatch; // batch whose start states were saved
+
+        bool uniform;
+        RfxResourceState first;
+        RfxResourceState current;
+        RfxResourceState batchStart;
+
+        uint64_t useBatch; // see TrackedBuffer
+        uint64_t pendingUseBatch;
+    };
+
+    RfxVector<TrackedBuffer> buffers;
+    RfxVector<TrackedTexture> textures;
+    RfxVector<RfxResourceState> states; // capacity is kept across frames
+    RfxHashMap<RfxBufferImpl*, uint32_t> bufferIndices;
+    RfxHashMap<RfxTextureSharedState*, uint32_t> textureIndices;
+
+    RfxVector<uint32_t> pendingTextures; // indices into `textures` touched by this batch, turned into textureBarriers by Flush
+
+    // textures placed over memory another resource used, their barriers out of UNDEFINED in this batch wait for that use
+    struct TextureAlias {
+        nri::Texture* texture;
+        nri::AccessBits access;
+        nri::StageBits stage;
+    };
+    RfxVector<TextureAlias> textureAliases;
+
+    // a mip run of the layer before, which the current layer may extend
+    struct LayerRun {
+        uint32_t barrier;
+        uint32_t mipOffset;
+        uint32_t mipNum;
+        RfxResourceState before;
+        RfxResourceState after;
+    };
+    RfxVector<LayerRun> openRuns;
+    RfxVector<LayerRun> nextRuns;
+
+    uint64_t batch = 1; // bumped by every Flush
+
     void RequireState(RfxBuffer buffer, RfxResourceState state);
     void RequireState(RfxTexture texture, RfxResourceState state);
+    void RequireState(
+        RfxTexture texture, RfxResourceState state, uint32_t mipOffset, uint32_t mipNum, uint32_t layerOffset, uint32_t layerNum
+    ); // absolute subresources
+
+    // the list already moved the resource to `state` by other means (UNDEFINED drops its contents). Flush first
+    void Assume(RfxBuffer buffer, RfxResourceState state);
+    void Assume(RfxTexture texture, RfxResourceState state);
+    // after Assume(UNDEFINED) of a resource whose memory was last accessed with `access` / `stage` by another one
+    void AliasMemory(RfxBuffer buffer, nri::AccessBits access, nri::StageBits stage);
+    void AliasMemory(RfxTexture texture, nri::AccessBits access, nri::StageBits stage);
+
+    TrackedBuffer* Find(RfxBuffer buffer);
+    // true if a resource the pending batch transitions was required since `sinceBatch` before that transition was, in this
+    // batch or an earlier one, or if a global barrier is pending. Commands recorded in between may still expect the old states
+    bool PendingUsedSince(uint64_t sinceBatch) const;
+    RfxResourceState GetState(RfxTexture texture, uint32_t mip, uint32_t layer); // UNTRACKED if this list hasn't touched it
 
     void Flush(nri::CommandBuffer& cmd);
+    // patches global states into the first uses of this list, then publishes its final states. Call in submission order.
+    // Returns the highest UploadFence value among the resources it touched, the submit has to wait for it
+    uint64_t Resolve(nri::CommandBuffer& cmd);
+    void Reset();
     bool HasPending() const {
-        return !bufferBarriers.empty() || !textureBarriers.empty() || !globalBarriers.empty();
+        return !bufferBarriers.empty() || !textureBarriers.empty() || !globalBarriers.empty() || !pendingTextures.empty();
     }
+
+    uint32_t TrackTexture(RfxTexture texture);
+    void Expand(TrackedTexture& tracked);
+    void AddTextureBarrier(
+        nri::Texture* texture, RfxResourceState before, RfxResourceState after, uint32_t mipOffset, uint32_t mipNum, uint32_t layerOffset,
+        uint32_t layerNum
+    );
+    void EmitTextureBarriers(
+        nri::Texture* texture, const RfxTextureSharedState* shared, const RfxResourceState* before, const RfxResourceState* after
+    );
+    void Submit(nri::CommandBuffer& cmd);
 };
 
+#define RFX_MAX_STREAM_VIEWPORTS 16
+#define RFX_MAX_SHADOWED_PUSH_CONSTANTS 256
+
+// opcodes of the deferred command stream, each followed by its packed payload
+enum class RfxStreamOp : uint8_t {
+    SET_PIPELINE_LAYOUT, // RfxPipelineImpl* (layout + bindless set)
+    SET_PIPELINE,        // RfxPipelineImpl* (read late, bundles outlive hot reloads)
+    SET_VIEWPORTS,       // uint8_t count, nri::Viewport[count]
+    SET_SCISSOR,         // nri::Rect
+    SET_BLEND_CONSTANTS, // nri::Color32f
+    SET_STENCIL_REF,     // uint8_t front, uint8_t back
+    SET_DEPTH_BIAS,      // nri::DepthBiasDesc
+    PUSH_CONSTANTS,      // nri::BindPoint, uint16_t size, bytes[size]
+    SET_VERTEX_BUFFER,   // nri::VertexBufferDesc
+    SET_INDEX_BUFFER,    // nri::Buffer*, uint64_t offset, nri::IndexType
+    DRAW,                // nri::DrawDesc
+    DRAW_INDEXED,        // nri::DrawIndexedDesc
+    DISPATCH,            // nri::DispatchDesc
+    DRAW_MESH_TASKS,     // nri::DrawMeshTasksDesc
+};
+
+// compact byte encoding of hot recording commands, translated to NRI by RfxCommandListImpl::ReplayStream
+struct RfxCommandStream {
+    RfxVector<uint8_t> bytes; // capacity is kept across frames
+    uint32_t commandNum = 0;
+
+    void Write(const void* data, size_t size) {
+        const uint8_t* p = (const uint8_t*)data;
+        bytes.insert(bytes.end(), p, p + size);
+    }
+
+    template <typename T>
+    void Push(RfxStreamOp op, const T& payload) {
+        Write(&op, sizeof(op));
+        Write(&payload, sizeof(T));
+        commandNum++;
+    }
+
+    bool Empty() const {
+        return bytes.empty();
+    }
+
+    void Reset() {
+        bytes.clear();
+        commandNum = 0;
+    }
+};
+
+// last state emitted into a command list, identical state is never emitted twice
+struct RfxStateShadow {
+    nri::Pipeline* pipeline = nullptr; // not RfxPipelineImpl*, hot reload swaps the NRI object in place
+    nri::PipelineLayout* layout = nullptr;
+    nri::BindPoint layoutBindPoint = {};
+    nri::DescriptorPool* descriptorPool = nullptr;
+
+    uint8_t pushConstants[RFX_MAX_SHADOWED_PUSH_CONSTANTS];
+    uint32_t pushConstantsSize = 0; // 0 = unknown
+
+    nri::Viewport viewports[RFX_MAX_STREAM_VIEWPORTS];
+    uint32_t viewportNum = 0; // 0 = unknown
+    nri::Rect scissor = {};
+    nri::Color32f blendConstants = {};
+    nri::DepthBiasDesc depthBias = {};
+    uint8_t stencilFront = 0;
+    uint8_t stencilBack = 0;
+    bool scissorValid = false;
+    bool blendConstantsValid = false;
+    bool depthBiasValid = false;
+    bool stencilRefValid = false;
+
+    // dynamic state doesn't survive a render pass begin on every backend
+    void InvalidateDynamic() {
+        viewportNum = 0;
+        scissorValid = false;
+        blendConstantsValid = false;
+        depthBiasValid = false;
+        stencilRefValid = false;
+    }
+
+    void Invalidate() {
+        pipeline = nullptr;
+        layout = nullptr;
+        descriptorPool = nullptr;
+        pushConstantsSize = 0;
+        InvalidateDynamic();
+    }
+};
+
+struct RfxBundleImpl;
+
 struct RfxCommandListImpl {
     nri::CommandBuffer* nriCmd;
+    nri::CommandBuffer* patchCmd = nullptr; // this frame's entry of `patchBuffers`
 
     // ring buffer
     RfxVector<nri::CommandAllocator*> allocators;
     RfxVector<nri::CommandBuffer*> buffers;
+    RfxVector<nri::CommandBuffer*> patchBuffers; // patch-up barriers submitted right before the list, see BarrierBatcher::Resolve
 
     RfxQueueType queueType;
     bool isSecondary;
 
+    // deferred mode encodes the hot path into `stream` instead of calling NRI
+    bool deferred = false;
+    bool hoistBarriers = false; // see rfxSetCommandListBarrierHoisting
+    RfxCommandStream stream;
+    RfxBundleImpl* recordingBundle = nullptr; // set while this is a bundle recorder (no nriCmd)
+
     BarrierBatcher barriers;
     RfxPipelineImpl* currentPipeline = nullptr;
 
+    RfxStateShadow shadow;
+    uint32_t elidedCalls = 0; // moved into CORE.ElidedStateCalls when the list ends
+    uint32_t passRestarts = 0; // moved into CORE.RenderPassRestarts when the list ends
+
     // cached states
     RfxBuffer lastBoundVertexBuffer = nullptr;
     RfxBuffer lastBoundIndexBuffer = nullptr;
+    uint64_t lastBoundVertexOffset = 0;
+    uint64_t lastBoundIndexOffset = 0;
     RfxBuffer currentVertexBuffer = nullptr;
     RfxBuffer currentIndexBuffer = nullptr;
+    uint64_t currentVertexOffset = 0;
+    uint64_t currentIndexOffset = 0;
 
     nri::IndexType currentIndexType = nri::IndexType::UINT32;
     bool isRendering = false;
+    bool renderingPending = false; // deferred lists open passes lazily, so barriers recorded inside can still go before them
+    uint64_t passBatch = 0;        // barrier batch of the open pass's attachments and pass resources, see FlushBarriers
     nri::Rect currentScissor = { 0, 0, 0, 0 };
     bool scissorSet = false;
 
@@ -398,17 +806,111 @@ struct RfxCommandListImpl {
     RfxVector<nri::Descriptor*> tempDescriptors;
 
     void ResetCache() {
-        lastBoundVertexBuffer = nullptr;
-        lastBoundIndexBuffer = nullptr;
         currentVertexBuffer = nullptr;
         currentIndexBuffer = nullptr;
+        currentVertexOffset = 0;
+        currentIndexOffset = 0;
         currentPipeline = nullptr;
         isRendering = false;
+        renderingPending = false;
+        stream.Reset();
+        barriers.Reset();
+        InvalidateState();
+    }
+
+    // forget everything bound so far, e.g. after an extension recorded its own state
+    void InvalidateState() {
+        lastBoundVertexBuffer = nullptr;
+        lastBoundIndexBuffer = nullptr;
+        lastBoundVertexOffset = 0;
+        lastBoundIndexOffset = 0;
+        shadow.Invalidate();
     }
 
+    // the NRI command buffer, with everything deferred so far already translated into it
+    nri::CommandBuffer& Direct() {
+        RFX_ASSERT(nriCmd && "this command can't be recorded into a bundle");
+        if (renderingPending)
+            OpenPendingPass();
+        if (!stream.Empty())
+            ReplayStream();
+        return *nriCmd;
+    }
+
+    void ReplayStream();
     void PrepareForDraw();
+
+    // state emission, filtered against the shadow
+    void SetPipeline(RfxPipelineImpl* pipeline);
+    void SetRootConstants(nri::BindPoint bindPoint, const void* data, uint32_t size);
+    void SetDescriptorPool(nri::DescriptorPool* pool);
+    void SetViewports(const nri::Viewport* viewports, uint32_t count);
+    void SetScissor(const nri::Rect& rect);
+    void SetBlendConstants(const nri::Color32f& color);
+    void SetStencilReference(uint8_t front, uint8_t back);
+    void SetDepthBias(const nri::DepthBiasDesc& desc);
+
     void BindDrawBuffers();
     void FlushBarriers();
+    void BeginRendering();
+    void OpenPendingPass();
+};
+
+// a CPU-side command stream recorded once, replayed into other lists by rfxCmdExecuteBundle
+struct RfxBundleImpl {
+    struct BufferRequirement {
+        RfxBuffer buffer;
+        RfxResourceState state;
+    };
+
+    RfxCommandListImpl recorder;
+    RfxCommandStream stream;
+    RfxVector<BufferRequirement> bufferRequirements;
+
+    void Require(RfxBuffer buffer, RfxResourceState state) {
+        for (BufferRequirement& r : bufferRequirements) {
+            if (r.buffer == buffer) {
+                r.state = state;
+                return;
+            }
+        }
+        bufferRequirements.push_back({ buffer, state });
+    }
+};
+
+// lock-free slot allocator, one bit per slot
+template <uint32_t N>
+struct RfxSlotAllocator {
+    static constexpr uint32_t WORD_NUM = (N + 63) / 64;
+    static constexpr uint32_t INVALID = (uint32_t)-1;
+
+    std::atomic<uint64_t> words[WORD_NUM];
+    std::atomic<uint32_t> hint = 0; // word to start searching from
+
+    uint32_t Alloc() {
+        uint32_t start = hint.load(std::memory_order_relaxed);
+        for (uint32_t i = 0; i < WORD_NUM; ++i) {
+            uint32_t w = (start + i) % WORD_NUM;
+            uint64_t bits = words[w].load(std::memory_order_relaxed);
+            while (~bits) {
+                uint32_t bit = (uint32_t)std::countr_one(bits);
+                if (w * 64 + bit >= N)
+                    break;
+                if (words[w].compare_exchange_weak(bits, bits | (1ull << bit), std::memory_order_acquire, std::memory_order_relaxed)) {
+                    hint.store(w, std::memory_order_relaxed);
+                    return w * 64 + bit;
+                }
+            }
+        }
+        return INVALID;
+    }
+
+    void Free(uint32_t id) {
+        if (id >= N)
+            return;
+        words[id / 64].fetch_and(~(1ull << (id % 64)), std::memory_order_release);
+        hint.store(id / 64, std::memory_order_relaxed);
+    }
 };
 
 struct BindlessData {
@@ -417,15 +919,12 @@ struct BindlessData {
     nri::DescriptorSet* globalDescriptorSet = nullptr;
     nri::Descriptor* staticSamplers[4];
 
-    // stacks
-    RfxVector<uint32_t> freeTextureSlots;
-    uint32_t textureHighWaterMark = 0;
-
-    RfxVector<uint32_t> freeBufferSlots;
-    uint32_t bufferHighWaterMark = 0;
+    // slots, safe to alloc/free from any thread
+    RfxSlotAllocator<RFX_MAX_BINDLESS_TEXTURES> textureSlots;
+    RfxSlotAllocator<RFX_MAX_BINDLESS_TEXTURES> bufferSlots;
+    RfxSlotAllocator<2048> asSlots;
 
-    RfxVector<uint32_t> freeASSlots;
-    uint32_t asHighWaterMark = 0;
+    std::mutex updateMutex; // descriptor set writes must be externally synchronized
 };
 
 //
@@ -460,11 +959,24 @@ struct ProfileRegion {
     int parentIndex;
 };
 
+// mapped buffer that rfxAllocTransient bump-allocates from
+struct TransientPage {
+    RfxBuffer buffer;
+    uint8_t* data;
+    uint64_t deviceAddress;
+    uint64_t size;
+};
+
 struct QueuedFrame {
     nri::CommandAllocator* commandAllocator;
     nri::CommandBuffer* commandBuffer;
+    nri::CommandBuffer* prologueBuffer; // streamed copies, query reset & the main list's patch-up barriers
+    nri::CommandBuffer* epilogueBuffer; // present barrier & timestamp copy, only used after queued lists
     nri::DescriptorPool* dynamicDescriptorPool;
     RfxCommandListImpl wrapper;
+    RfxVector<RfxCommandList> queuedLists;      // see rfxQueueCommandList
+    RfxVector<TransientPage> transientOverflow; // pages for allocations that didn't fit the ring, freed on reuse
+    uint64_t transientOverflowUsed = 0;         // in transientOverflow.back()
 
     // Profiler state
     RfxVector<ProfileRegion> profileRegions;
@@ -472,6 +984,40 @@ struct QueuedFrame {
     uint32_t queryCount;
 };
 
+// one rfxSubmitUploads worth of copies, recorded & submitted on the copy queue
+struct UploadBatch {
+    struct StagingChunk {
+        nri::Buffer* buffer; // plain NRI buffer, no views or bindless slot
+        nri::Memory* memory;
+        uint8_t* data; // mapped for the buffer's whole lifetime
+        uint64_t size;
+    };
+    struct BufferCopy {
+        RfxBuffer dst;
+        uint64_t dstOffset;
+        uint32_t chunk;
+        uint64_t srcOffset;
+        uint64_t size;
+    };
+    struct TextureCopy {
+        RfxTexture dst;
+        nri::TextureRegionDesc region; // absolute mip & layer
+        nri::TextureDataLayoutDesc layout;
+        uint32_t chunk;
+    };
+
+    nri::CommandAllocator* allocator;
+    nri::CommandBuffer* commandBuffer;
+    nri::CommandAllocator* transitionAllocator = nullptr; // graphics queue, created on first use
+    nri::CommandBuffer* transitionBuffer = nullptr;       // moves textures the frames left in other layouts to copy dst
+    RfxVector<StagingChunk> staging; // kept across reuses, the batch fills them front to back
+    uint32_t chunk = 0;
+    uint64_t chunkUsed = 0;
+    RfxVector<BufferCopy> bufferCopies;
+    RfxVector<TextureCopy> textureCopies;
+    uint64_t value = 0; // UploadFence value signaled on completion, 0 while recording
+};
+
 struct RfxDenoiserImpl;
 
 #define RFX_MAX_KEYS 350
@@ -498,6 +1044,7 @@ struct CoreData {
 
     bool EnableValidation = true;
     nri::GraphicsAPI RequestedBackend = nri::GraphicsAPI::VK;
+    uint32_t AdapterIndex = 0;
     RfxFeatureSupportFlags FeatureSupportFlags = 0;
     void* WindowHandle = nullptr;
     nri::Window NRIWindow;
@@ -508,6 +1055,7 @@ struct CoreData {
     int FramebufferHeight = 0;
     int SampleCount = 1;
     int Anisotropy = 1;
+    uint8_t QueuedFrameNum = 3; // frames in flight, fixed once the device exists
 
     bool AllowLowLatency = false;   // low latency supported by device?
     bool LowLatencyEnabled = false; // low latency enabled by user?
@@ -515,6 +1063,8 @@ struct CoreData {
 
     bool IsFocused = true;
     bool IsMinimized = false;
+    bool Headless = false; // no window or swapchain, see rfxInitHeadless
+    std::chrono::steady_clock::time_point HeadlessStartTime; // rfxGetTime origin while headless
     int SavedWindowPos[2] = { 100, 100 };
     int SavedWindowSize[2] = { 1280, 720 };
 
@@ -527,17 +1077,18 @@ struct CoreData {
     nri::Fence* NRIFrameFence = nullptr;
     nri::SwapChain* NRISwapChain = nullptr;
     nri::Streamer* NRIStreamer = nullptr;
+    nri::Streamer* NRIListStreamer = nullptr; // uploads copied straight into a command list, apart from the prologue's
     nri::Imgui* ImguiRenderer = nullptr;
     BindlessData Bindless;
 
     // Frames
     RfxVector<QueuedFrame> QueuedFrames;
     RfxVector<SwapChainTexture> SwapChainTextures;
-    uint32_t FrameIndex = 0;
+    std::atomic<uint32_t> FrameIndex = 0; // read by rfxDeferDestruction on any thread
     uint32_t CurrentSwapChainTextureIndex = 0;
     uint32_t SwapChainWidth = 0;
     uint32_t SwapChainHeight = 0;
-    bool FrameStarted = false;
+    std::atomic<bool> FrameStarted = false;
     double LastTime = 0.0;
     float DeltaTime = 0.0f;
 
@@ -546,6 +1097,9 @@ struct CoreData {
     nri::Buffer* TimestampBuffer = nullptr;
     nri::Memory* TimestampBufferMemory = nullptr;
     RfxVector<RfxGpuTimestamp> LastFrameTimestamps;
+    std::atomic<uint32_t> ElidedStateCalls = 0; // accumulated by command lists during the frame
+    std::atomic<uint32_t> RenderPassRestarts = 0;
+    RfxFrameStats LastFrameStats = {};
 
     // Implicit resources
     struct {
@@ -561,6 +1115,7 @@ struct CoreData {
     } MSAAColorBuffer;
 
     RfxTextureImpl SwapChainWrapper = {};
+    RfxVector<RfxTexture> HeadlessBackbuffers; // offscreen stand-ins for swapchain textures
 
     // Slang
     Slang::ComPtr<slang::IGlobalSession> SlangSession;
@@ -569,9 +1124,61 @@ struct CoreData {
         RfxVector<std::function<void()>> tasks;
     };
     RfxVector<DeletionQueue> Graveyard; // indexed by FrameIndex % QueuedFrameNum
-    RfxVector<std::function<void(nri::CommandBuffer&)>> PendingPreBarriers;
-    RfxVector<std::function<void(nri::CommandBuffer&)>> PendingPostBarriers;
+    std::mutex GraveyardMutex;
+
+    // the streamer isn't thread safe, StreamerMutex guards it together with the uploads queued on it
+    struct PendingBarriers {
+        RfxVector<nri::BufferBarrierDesc> buffers;
+        RfxVector<nri::TextureBarrierDesc> textures;
+
+        bool Empty() const {
+            return buffers.empty() && textures.empty();
+        }
+        void Clear() {
+            buffers.clear();
+            textures.clear();
+        }
+    };
+    // an upload waiting for the next prologue. Its barriers are built from the global states when the copy is recorded,
+    // after the previous frame's Resolve. One of buffer / texture
+    struct PendingUpload {
+        RfxBuffer buffer;
+        RfxTexture texture;
+        uint32_t mipOffset;
+        uint32_t mipNum;
+        uint32_t layerOffset;
+        uint32_t layerNum;
+        RfxResourceState finalState;
+    };
+    RfxVector<PendingUpload> PendingUploads;
+    PendingBarriers PendingPreBarriers; // each side goes out as a single CmdBarrier around CmdCopyStreamedData
+    PendingBarriers PendingPostBarriers;
+    std::mutex StreamerMutex;
+
+    // per-frame transient ring, see rfxAllocTransient. Each queued frame bump-allocates from its own slice of the page
+    struct TransientRing {
+        TransientPage page = {};
+        uint64_t frameSize = 0;
+        uint64_t sliceOffset = 0;           // start of the current frame's slice
+        std::atomic<uint64_t> used = 0;     // within the current frame's slice
+        std::atomic<uint64_t> overflow = 0; // bytes that didn't fit this frame, the ring grows by them at the next one
+        std::mutex overflowMutex;
+    };
+    TransientRing Transient;
 
+    // rfxCmdGenerateMips, compiled on first use
+    RfxShader MipGenShader = nullptr;
+    RfxPipeline MipGenPipeline = nullptr;
+    std::mutex MipGenMutex;
+
+    // copy-queue uploads, see rfxSubmitUploads
+    RfxFence UploadFence = nullptr;
+    RfxFence UploadTransitionFence = nullptr; // graphics queue -> copy queue, see UploadBatch::transitionBuffer
+    RfxVector<UploadBatch*> UploadBatches; // in flight or retired, reused once UploadFence passes their value
+    UploadBatch* UploadRecording = nullptr;
+    std::mutex UploadMutex;
+
+    std::mutex QueuedListsMutex;
     std::mutex HotReloadMutex;
     RfxSet<RfxShader> ShadersToReload;
 
@@ -584,13 +1191,16 @@ struct CoreData {
 
     std::mutex ShaderCacheMutex;
     std::mutex ShaderCompileMutex;
-    std::mutex VirtualFSMutex;
 };
 
-extern CoreData CORE;
+// every rfx* call resolves its state through the calling thread's current context
+struct RfxContextImpl : CoreData {};
+
+extern thread_local CoreData* g_CurrentContext;
+#define CORE (*g_CurrentContext)
 
 inline uint8_t GetQueuedFrameNum() {
-    return 3;
+    return CORE.QueuedFrameNum;
 }
 void rfxDeferDestruction(std::function<void()>&& task);
 void rfxEventSleep();
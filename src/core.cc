@@ -1,13 +1,16 @@
 #include "rafx.h"
 #include "rafx_internal.h"
 #include <cassert>
+#include <chrono>
+#include <cstdio>
 #include <cstring>
 
 #if (RAFX_PLATFORM == RAFX_WINDOWS)
 #    include <windows.h>
 #endif
 
-CoreData CORE = {};
+static RfxContextImpl g_DefaultContext;
+thread_local CoreData* g_CurrentContext = &g_DefaultContext;
 
 #if (RAFX_PLATFORM == RAFX_WINDOWS)
 
@@ -119,6 +122,8 @@ void rfxDeferDestruction(std::function<void()>&& task) {
     }
     uint32_t numFrames = GetQueuedFrameNum();
 
+    // rfxEndFrame advances FrameIndex and clears FrameStarted together under this lock, so both are read as one snapshot
+    std::lock_guard<std::mutex> lock(CORE.GraveyardMutex);
     uint32_t currentFrame = CORE.FrameIndex;
     if (!CORE.FrameStarted && currentFrame > 0) {
         currentFrame--;
@@ -129,9 +134,52 @@ void rfxDeferDestruction(std::function<void()>&& task) {
 }
 
 CoreData::~CoreData() {
+    g_CurrentContext = this; // helpers below go through CORE
+
     if (NRIDevice) {
         NRI.DeviceWaitIdle(NRIDevice);
 
+        // headless backbuffers go through the graveyard like any other texture
+        for (RfxTexture tex : HeadlessBackbuffers)
+            rfxDestroyTexture(tex);
+        HeadlessBackbuffers.clear();
+
+        rfxDestroyPipeline(MipGenPipeline);
+        rfxDestroyShader(MipGenShader);
+
+        // transient pages
+        for (QueuedFrame& qf : QueuedFrames) {
+            for (TransientPage& page : qf.transientOverflow)
+                rfxDestroyBuffer(page.buffer);
+            qf.transientOverflow.clear();
+        }
+        rfxDestroyBuffer(Transient.page.buffer);
+        Transient.page = {};
+
+        // upload batches, the device is idle so their staging buffers can go right away. The fences use the graveyard
+        if (UploadRecording)
+            UploadBatches.push_back(UploadRecording);
+        for (UploadBatch* batch : UploadBatches) {
+            for (UploadBatch::StagingChunk& chunk : batch->staging) {
+                NRI.UnmapBuffer(*chunk.buffer);
+                NRI.DestroyBuffer(chunk.buffer);
+                NRI.FreeMemory(chunk.memory);
+            }
+            NRI.DestroyCommandBuffer(batch->commandBuffer);
+            NRI.DestroyCommandAllocator(batch->allocator);
+            if (batch->transitionAllocator) {
+                NRI.DestroyCommandBuffer(batch->transitionBuffer);
+                NRI.DestroyCommandAllocator(batch->transitionAllocator);
+            }
+            RfxDelete(batch);
+        }
+        UploadBatches.clear();
+        UploadRecording = nullptr;
+        rfxDestroyFence(UploadFence);
+        UploadFence = nullptr;
+        rfxDestroyFence(UploadTransitionFence);
+        UploadTransitionFence = nullptr;
+
         // process graveyard
         for (auto& queue : Graveyard) {
             for (auto& task : queue.tasks) {
@@ -169,6 +217,10 @@ CoreData::~CoreData() {
         for (QueuedFrame& qf : QueuedFrames) {
             if (qf.commandBuffer)
                 NRI.DestroyCommandBuffer(qf.commandBuffer);
+            if (qf.prologueBuffer)
+                NRI.DestroyCommandBuffer(qf.prologueBuffer);
+            if (qf.epilogueBuffer)
+                NRI.DestroyCommandBuffer(qf.epilogueBuffer);
             if (qf.commandAllocator)
                 NRI.DestroyCommandAllocator(qf.commandAllocator);
             if (qf.dynamicDescriptorPool)
@@ -188,6 +240,8 @@ CoreData::~CoreData() {
 
         // destroy swapchain texturess and semaphores
         for (auto& s : SwapChainTextures) {
+            if (Headless)
+                continue; // owned by HeadlessBackbuffers
             NRI.DestroyFence(s.acquireSemaphore);
             NRI.DestroyFence(s.releaseSemaphore);
             NRI.DestroyDescriptor(s.colorAttachment);
@@ -201,6 +255,8 @@ CoreData::~CoreData() {
             NRI.DestroyFence(NRIFrameFence);
         if (NRIStreamer)
             NRI.DestroyStreamer(NRIStreamer);
+        if (NRIListStreamer)
+            NRI.DestroyStreamer(NRIListStreamer);
         if (ImguiRenderer)
             NRI.DestroyImgui(ImguiRenderer);
         if (TimestampPool)
@@ -216,7 +272,34 @@ CoreData::~CoreData() {
         nri::nriDestroyDevice(NRIDevice);
     }
 
-    Backend_DestroyWindow();
+    // headless and never opened contexts don't hold the window backend
+    if (WindowHandle)
+        Backend_DestroyWindow();
+}
+
+//
+// Context
+//
+
+RfxContext rfxCreateContext() {
+    return RfxNew<RfxContextImpl>();
+}
+
+void rfxDestroyContext(RfxContext context) {
+    if (!context || context == &g_DefaultContext)
+        return;
+
+    CoreData* prev = g_CurrentContext;
+    RfxDelete(context);
+    g_CurrentContext = (prev == context) ? &g_DefaultContext : prev;
+}
+
+void rfxMakeContextCurrent(RfxContext context) {
+    g_CurrentContext = context ? context : &g_DefaultContext;
+}
+
+RfxContext rfxGetCurrentContext() {
+    return (RfxContext)g_CurrentContext;
 }
 
 static void CreateStaticSamplers() {
@@ -321,50 +404,78 @@ static void InitBindless() {
     CORE.NRI.UpdateDescriptorRanges(&update, 1);
 }
 
-static void NRIInitialize(nri::GraphicsAPI graphicsAPI) {
-    nri::AdapterDesc adapterDesc[2] = {};
-    uint32_t adapterCnt = 2;
-    nri::nriEnumerateAdapters(adapterDesc, adapterCnt);
+// gets the mandatory interfaces and reports which optional ones the device supports
+static RfxFeatureSupportFlags GetNRIInterfaces(nri::Device& device, NRIInterface& iface, bool& allowLowLatency) {
+    NRI_CHECK(nri::nriGetInterface(device, NRI_INTERFACE(nri::CoreInterface), (nri::CoreInterface*)&iface));
+    NRI_CHECK(nri::nriGetInterface(device, NRI_INTERFACE(nri::HelperInterface), (nri::HelperInterface*)&iface));
+    NRI_CHECK(nri::nriGetInterface(device, NRI_INTERFACE(nri::StreamerInterface), (nri::StreamerInterface*)&iface));
+    NRI_CHECK(nri::nriGetInterface(device, NRI_INTERFACE(nri::SwapChainInterface), (nri::SwapChainInterface*)&iface));
+    NRI_CHECK(nri::nriGetInterface(device, NRI_INTERFACE(nri::ImguiInterface), (nri::ImguiInterface*)&iface));
 
+    // these may not be supported:
+    RfxFeatureSupportFlags flags = 0;
+    allowLowLatency = false;
+    if (nri::nriGetInterface(device, NRI_INTERFACE(nri::MeshShaderInterface), (nri::MeshShaderInterface*)&iface) == nri::Result::SUCCESS) {
+        flags |= RFX_FEATURE_MESH_SHADER;
+    }
+    if (nri::nriGetInterface(device, NRI_INTERFACE(nri::RayTracingInterface), (nri::RayTracingInterface*)&iface) == nri::Result::SUCCESS) {
+        flags |= RFX_FEATURE_RAY_TRACING;
+    }
+    if (nri::nriGetInterface(device, NRI_INTERFACE(nri::UpscalerInterface), (nri::UpscalerInterface*)&iface) == nri::Result::SUCCESS) {
+        flags |= RFX_FEATURE_UPSCALE;
+    }
+    if (nri::nriGetInterface(device, NRI_INTERFACE(nri::LowLatencyInterface), (nri::LowLatencyInterface*)&iface) == nri::Result::SUCCESS) {
+        flags |= RFX_FEATURE_LOW_LATENCY;
+        const nri::DeviceDesc& desc = iface.GetDeviceDesc(device);
+        if (desc.features.lowLatency) {
+            allowLowLatency = true;
+        }
+    }
+    return flags;
+}
+
+static RfxVector<nri::AdapterDesc> GetNRIAdapters() {
+    uint32_t adapterCnt = 0;
+    nri::nriEnumerateAdapters(nullptr, adapterCnt);
+
+    RfxVector<nri::AdapterDesc> adapters(adapterCnt);
+    if (adapterCnt)
+        nri::nriEnumerateAdapters(adapters.data(), adapterCnt);
+    adapters.resize(adapterCnt);
+    return adapters;
+}
+
+static nri::DeviceCreationDesc GetDeviceCreationDesc(nri::GraphicsAPI graphicsAPI, const nri::AdapterDesc* adapterDesc, bool validation) {
     nri::DeviceCreationDesc dcd = {};
     dcd.graphicsAPI = graphicsAPI;
-    dcd.enableGraphicsAPIValidation = CORE.EnableValidation;
-    dcd.enableNRIValidation = CORE.EnableValidation;
+    dcd.enableGraphicsAPIValidation = validation;
+    dcd.enableNRIValidation = validation;
     dcd.vkBindingOffsets = { 0, 128, 32, 64 };
-    dcd.adapterDesc = &adapterDesc[0];
+    dcd.adapterDesc = adapterDesc;
     dcd.allocationCallbacks.Allocate = InternalNriAlloc;
     dcd.allocationCallbacks.Reallocate = InternalNriRealloc;
     dcd.allocationCallbacks.Free = InternalNriFree;
     dcd.allocationCallbacks.userArg = &g_Allocator;
-    NRI_CHECK(nri::nriCreateDevice(dcd, CORE.NRIDevice));
-
-    NRI_CHECK(nri::nriGetInterface(*CORE.NRIDevice, NRI_INTERFACE(nri::CoreInterface), (nri::CoreInterface*)&CORE.NRI));
-    NRI_CHECK(nri::nriGetInterface(*CORE.NRIDevice, NRI_INTERFACE(nri::HelperInterface), (nri::HelperInterface*)&CORE.NRI));
-    NRI_CHECK(nri::nriGetInterface(*CORE.NRIDevice, NRI_INTERFACE(nri::StreamerInterface), (nri::StreamerInterface*)&CORE.NRI));
-    NRI_CHECK(nri::nriGetInterface(*CORE.NRIDevice, NRI_INTERFACE(nri::SwapChainInterface), (nri::SwapChainInterface*)&CORE.NRI));
-    NRI_CHECK(nri::nriGetInterface(*CORE.NRIDevice, NRI_INTERFACE(nri::ImguiInterface), (nri::ImguiInterface*)&CORE.NRI));
+    return dcd;
+}
 
-    // these may not be supported:
-    if (nri::nriGetInterface(*CORE.NRIDevice, NRI_INTERFACE(nri::MeshShaderInterface), (nri::MeshShaderInterface*)&CORE.NRI) ==
-        nri::Result::SUCCESS) {
-        CORE.FeatureSupportFlags |= RFX_FEATURE_MESH_SHADER;
-    }
-    if (nri::nriGetInterface(*CORE.NRIDevice, NRI_INTERFACE(nri::RayTracingInterface), (nri::RayTracingInterface*)&CORE.NRI) ==
-        nri::Result::SUCCESS) {
-        CORE.FeatureSupportFlags |= RFX_FEATURE_RAY_TRACING;
-    }
-    if (nri::nriGetInterface(*CORE.NRIDevice, NRI_INTERFACE(nri::UpscalerInterface), (nri::UpscalerInterface*)&CORE.NRI) ==
-        nri::Result::SUCCESS) {
-        CORE.FeatureSupportFlags |= RFX_FEATURE_UPSCALE;
-    }
-    if (nri::nriGetInterface(*CORE.NRIDevice, NRI_INTERFACE(nri::LowLatencyInterface), (nri::LowLatencyInterface*)&CORE.NRI) ==
-        nri::Result::SUCCESS) {
-        CORE.FeatureSupportFlags |= RFX_FEATURE_LOW_LATENCY;
-        const nri::DeviceDesc& desc = CORE.NRI.GetDeviceDesc(*CORE.NRIDevice);
-        if (desc.features.lowLatency) {
-            CORE.AllowLowLatency = true;
-        }
+static bool NRIInitialize(nri::GraphicsAPI graphicsAPI) {
+    RfxVector<nri::AdapterDesc> adapters = GetNRIAdapters();
+    const nri::AdapterDesc* adapterDesc = nullptr;
+    if (CORE.AdapterIndex != 0 && CORE.AdapterIndex >= adapters.size()) {
+        fprintf(stderr, "[Rafx] Adapter index %u is out of range (%u adapters available)\n", CORE.AdapterIndex, (uint32_t)adapters.size());
+        return false;
     }
+    if (!adapters.empty())
+        adapterDesc = &adapters[CORE.AdapterIndex];
+
+    nri::DeviceCreationDesc dcd = GetDeviceCreationDesc(graphicsAPI, adapterDesc, CORE.EnableValidation);
+    NRI_CHECK(nri::nriCreateDevice(dcd, CORE.NRIDevice));
+
+    bool allowLowLatency = false;
+    CORE.FeatureSupportFlags |= GetNRIInterfaces(*CORE.NRIDevice, CORE.NRI, allowLowLatency);
+    if (allowLowLatency)
+        CORE.AllowLowLatency = true;
 
     InitBindless();
 
@@ -376,6 +487,7 @@ static void NRIInitialize(nri::GraphicsAPI graphicsAPI) {
     sd.constantBufferMemoryLocation = nri::MemoryLocation::HOST_UPLOAD;
     sd.queuedFrameNum = GetQueuedFrameNum();
     NRI_CHECK(CORE.NRI.CreateStreamer(*CORE.NRIDevice, sd, CORE.NRIStreamer));
+    NRI_CHECK(CORE.NRI.CreateStreamer(*CORE.NRIDevice, sd, CORE.NRIListStreamer));
 
     CORE.NRI.GetQueue(*CORE.NRIDevice, nri::QueueType::GRAPHICS, 0, CORE.NRIGraphicsQueue);
     if (CORE.NRI.GetQueue(*CORE.NRIDevice, nri::QueueType::COMPUTE, 0, CORE.NRIComputeQueue) != nri::Result::SUCCESS) {
@@ -386,6 +498,8 @@ static void NRIInitialize(nri::GraphicsAPI graphicsAPI) {
     }
 
     NRI_CHECK(CORE.NRI.CreateFence(*CORE.NRIDevice, 0, CORE.NRIFrameFence));
+    CORE.UploadFence = rfxCreateFence(0);
+    CORE.UploadTransitionFence = rfxCreateFence(0);
 
     // Profiler
     {
@@ -418,6 +532,8 @@ static void NRIInitialize(nri::GraphicsAPI graphicsAPI) {
     for (QueuedFrame& qf : CORE.QueuedFrames) {
         NRI_CHECK(CORE.NRI.CreateCommandAllocator(*CORE.NRIGraphicsQueue, qf.commandAllocator));
         NRI_CHECK(CORE.NRI.CreateCommandBuffer(*qf.commandAllocator, qf.commandBuffer));
+        NRI_CHECK(CORE.NRI.CreateCommandBuffer(*qf.commandAllocator, qf.prologueBuffer));
+        NRI_CHECK(CORE.NRI.CreateCommandBuffer(*qf.commandAllocator, qf.epilogueBuffer));
 
         nri::DescriptorPoolDesc poolDesc = {};
         poolDesc.descriptorSetMaxNum = 4096;
@@ -433,6 +549,8 @@ static void NRIInitialize(nri::GraphicsAPI graphicsAPI) {
         NRI_CHECK(CORE.NRI.CreateDescriptorPool(*CORE.NRIDevice, poolDesc, qf.dynamicDescriptorPool));
         qf.wrapper.nriCmd = qf.commandBuffer;
     }
+
+    return true;
 }
 
 void rfxRequestBackend(RfxBackend backend, bool enableValidation) {
@@ -461,10 +579,89 @@ bool rfxOpenWindow(const char* title, int width, int height) {
     if (SLANG_FAILED(slang::createGlobalSession(CORE.SlangSession.writeRef())))
         return false;
 
-    NRIInitialize(CORE.RequestedBackend);
+    return NRIInitialize(CORE.RequestedBackend);
+}
+
+bool rfxInitHeadless(RfxBackend backend, int width, int height) {
+    RFX_ASSERT(!CORE.NRIDevice && "rfxInitHeadless called after device creation");
+    if (width <= 0 || height <= 0)
+        return false;
+
+    CORE.HeadlessStartTime = std::chrono::steady_clock::now();
+
+    rfxRequestBackend(backend, CORE.EnableValidation);
+    CORE.Headless = true;
+    CORE.FramebufferWidth = width;
+    CORE.FramebufferHeight = height;
+
+    if (SLANG_FAILED(slang::createGlobalSession(CORE.SlangSession.writeRef())))
+        return false;
+
+    if (!NRIInitialize(CORE.RequestedBackend))
+        return false;
+
+    // one offscreen backbuffer per queued frame, so a finished frame can be read back while the next ones are recorded
+    for (uint32_t i = 0; i < GetQueuedFrameNum(); ++i) {
+        RfxTexture tex = rfxCreateTexture(
+            width, height, RFX_FORMAT_RGBA8_UNORM, 1, RFX_TEXTURE_USAGE_RENDER_TARGET | RFX_TEXTURE_USAGE_SHADER_RESOURCE, nullptr
+        );
+        if (!tex)
+            return false;
+        CORE.HeadlessBackbuffers.push_back(tex);
+
+        SwapChainTexture& s = CORE.SwapChainTextures.emplace_back();
+        s.acquireSemaphore = nullptr;
+        s.releaseSemaphore = nullptr;
+        s.texture = tex->texture;
+        s.colorAttachment = tex->descriptorAttachment;
+        s.attachmentFormat = tex->format;
+    }
+    CORE.SwapChainWidth = (uint32_t)width;
+    CORE.SwapChainHeight = (uint32_t)height;
+
     return true;
 }
 
+uint32_t rfxEnumerateAdapters(RfxAdapterInfo* adapters, uint32_t capacity) {
+    RfxVector<nri::AdapterDesc> nriAdapters = GetNRIAdapters();
+    if (!adapters)
+        return (uint32_t)nriAdapters.size();
+
+    for (uint32_t i = 0; i < capacity && i < (uint32_t)nriAdapters.size(); ++i) {
+        const nri::AdapterDesc& src = nriAdapters[i];
+        RfxAdapterInfo& dst = adapters[i];
+        dst = {};
+        snprintf(dst.name, sizeof(dst.name), "%s", src.name);
+        dst.videoMemorySize = src.videoMemorySize;
+        dst.sharedSystemMemorySize = src.sharedSystemMemorySize;
+        dst.deviceId = src.deviceId;
+        dst.integrated = src.architecture == nri::Architecture::INTEGRATED;
+
+        switch (src.vendor) {
+        case nri::Vendor::NVIDIA: dst.vendor = RFX_VENDOR_NVIDIA; break;
+        case nri::Vendor::AMD: dst.vendor = RFX_VENDOR_AMD; break;
+        case nri::Vendor::INTEL: dst.vendor = RFX_VENDOR_INTEL; break;
+        default: dst.vendor = RFX_VENDOR_UNKNOWN; break;
+        }
+
+        // optional features are only known once a device exists, so probe with a throwaway one
+        nri::Device* device = nullptr;
+        nri::DeviceCreationDesc dcd = GetDeviceCreationDesc(CORE.RequestedBackend, &src, false);
+        if (nri::nriCreateDevice(dcd, device) == nri::Result::SUCCESS) {
+            NRIInterface iface = {};
+            bool allowLowLatency = false;
+            dst.features = GetNRIInterfaces(*device, iface, allowLowLatency);
+            nri::nriDestroyDevice(device);
+        }
+    }
+    return (uint32_t)nriAdapters.size();
+}
+
+void rfxSelectAdapter(uint32_t index) {
+    RFX_ASSERT(!CORE.NRIDevice && "rfxSelectAdapter called after device creation");
+    CORE.AdapterIndex = index;
+}
+
 bool rfxSupportsFeatures(RfxFeatureSupportFlags features) {
     return (CORE.FeatureSupportFlags & features) == features;
 }
@@ -498,6 +695,8 @@ bool rfxHasWindowFlags(RfxWindowFlags flags) {
 }
 
 bool rfxWindowShouldClose() {
+    if (CORE.Headless)
+        return false;
     return Backend_WindowShouldClose();
 }
 
@@ -521,18 +720,29 @@ void rfxPollInputEvents() {
 }
 
 void rfxGetWindowSize(int* width, int* height) {
+    if (CORE.Headless) {
+        if (width)
+            *width = CORE.FramebufferWidth;
+        if (height)
+            *height = CORE.FramebufferHeight;
+        return;
+    }
     Backend_GetWindowSize(width, height);
 }
 
 int rfxGetWindowWidth() {
-    return Backend_GetWindowWidth();
+    return CORE.Headless ? CORE.FramebufferWidth : Backend_GetWindowWidth();
 }
 
 int rfxGetWindowHeight() {
-    return Backend_GetWindowHeight();
+    return CORE.Headless ? CORE.FramebufferHeight : Backend_GetWindowHeight();
 }
 
 double rfxGetTime() {
+    if (CORE.Headless) {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - CORE.HeadlessStartTime;
+        return elapsed.count();
+    }
     return Backend_GetTime();
 }
 float rfxGetDeltaTime() {
@@ -643,6 +853,15 @@ void rfxSetSampleCount(int count) {
     CORE.MSAAColorBuffer.width = 0;
 }
 
+void rfxSetFramesInFlight(int count) {
+    RFX_ASSERT(!CORE.NRIDevice && "rfxSetFramesInFlight called after device creation");
+    if (count < 1)
+        count = 1;
+    if (count > 4)
+        count = 4;
+    CORE.QueuedFrameNum = (uint8_t)count;
+}
+
 void rfxSetAnisotropy(int level) {
     if (level < 1)
         level = 1;
@@ -664,6 +883,7 @@ void rfxSetAnisotropy(int level) {
 
         CreateStaticSamplers();
 
+        std::lock_guard<std::mutex> lock(CORE.Bindless.updateMutex);
         nri::UpdateDescriptorRangeDesc update = {};
         update.descriptorSet = CORE.Bindless.globalDescriptorSet;
         update.rangeIndex = 1;
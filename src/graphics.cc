@@ -9,6 +9,18 @@
 #include <source_location>
 #include <fstream>
 
+#if RAFX_PLATFORM == RAFX_WINDOWS
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
 #include <NRD.h>
 #include <NRDIntegration.h>
 
@@ -173,19 +185,13 @@ static nri::MicromapBits ToNRIMicromapBits(RfxBuildMicromapFlags flags) {
 }
 
 static uint32_t AllocASSlot() {
-    uint32_t id;
-    if (!CORE.Bindless.freeASSlots.empty()) {
-        id = CORE.Bindless.freeASSlots.back();
-        CORE.Bindless.freeASSlots.pop_back();
-    } else {
-        RFX_ASSERT(CORE.Bindless.asHighWaterMark < 2048);
-        id = CORE.Bindless.asHighWaterMark++;
-    }
+    uint32_t id = CORE.Bindless.asSlots.Alloc();
+    RFX_ASSERT(id != CORE.Bindless.asSlots.INVALID);
     return id;
 }
 
 static void FreeASSlot(uint32_t id) {
-    CORE.Bindless.freeASSlots.push_back(id);
+    CORE.Bindless.asSlots.Free(id);
 }
 
 static uint64_t Align(uint64_t size, uint64_t alignment) {
@@ -205,7 +211,7 @@ static inline void MustTransition(
     );
 #else
     if (cmd->isRendering) {
-        CORE.NRI.CmdEndRendering(*cmd->nriCmd);
+        CORE.NRI.CmdEndRendering(cmd->Direct());
         cmd->isRendering = false;
     }
 #endif
@@ -292,6 +298,31 @@ static void GetNRIState(RfxResourceState state, nri::AccessBits& access, nri::La
         layout = nri::Layout::RESOLVE_DESTINATION;
         stage = nri::StageBits::RESOLVE;
         break;
+    case RFX_STATE_FRAGMENT_READ:
+        access = nri::AccessBits::SHADER_RESOURCE;
+        layout = nri::Layout::SHADER_RESOURCE;
+        stage = nri::StageBits::FRAGMENT_SHADER;
+        break;
+    case RFX_STATE_GRAPHICS_READ:
+        access = nri::AccessBits::SHADER_RESOURCE;
+        layout = nri::Layout::SHADER_RESOURCE;
+        stage = nri::StageBits::GRAPHICS_SHADERS;
+        break;
+    case RFX_STATE_COMPUTE_READ:
+        access = nri::AccessBits::SHADER_RESOURCE;
+        layout = nri::Layout::SHADER_RESOURCE;
+        stage = nri::StageBits::COMPUTE_SHADER;
+        break;
+    case RFX_STATE_COMPUTE_WRITE:
+        access = nri::AccessBits::SHADER_RESOURCE_STORAGE;
+        layout = nri::Layout::SHADER_RESOURCE_STORAGE;
+        stage = nri::StageBits::COMPUTE_SHADER;
+        break;
+    case RFX_STATE_RAYTRACING_READ:
+        access = nri::AccessBits::SHADER_RESOURCE;
+        layout = nri::Layout::SHADER_RESOURCE;
+        stage = nri::StageBits::RAY_TRACING_SHADERS;
+        break;
     default:
         access = nri::AccessBits::NONE;
         layout = nri::Layout::UNDEFINED;
@@ -300,11 +331,123 @@ static void GetNRIState(RfxResourceState state, nri::AccessBits& access, nri::La
     }
 }
 
+static void SubmitPendingBarriers(nri::CommandBuffer& cb, CoreData::PendingBarriers& pending) {
+    if (pending.Empty())
+        return;
+
+    nri::BarrierDesc bd = {};
+    bd.buffers = pending.buffers.data();
+    bd.bufferNum = (uint32_t)pending.buffers.size();
+    bd.textures = pending.textures.data();
+    bd.textureNum = (uint32_t)pending.textures.size();
+    CORE.NRI.CmdBarrier(cb, bd);
+
+    pending.Clear();
+}
+
+// fills in a wait for copy-queue uploads up to value, unless they're already done
+static bool GetUploadWait(uint64_t value, nri::FenceSubmitDesc& wait) {
+    if (value == 0 || CORE.NRI.GetFenceValue(*CORE.UploadFence->fence) >= value)
+        return false;
+    wait = { CORE.UploadFence->fence, value, nri::StageBits::ALL };
+    return true;
+}
+
+// moves an upload's region to `after` in the global states, skipping what is already there. With fromCopyOnly only the
+// subresources still in COPY_DST move, so a region uploaded twice gets one post barrier
+static void TransitionUploadRegion(
+    const CoreData::PendingUpload& upload, RfxResourceState after, bool fromCopyOnly, CoreData::PendingBarriers& barriers
+) {
+    nri::AccessBits access;
+    nri::Layout layout;
+    nri::StageBits stage;
+    GetNRIState(after, access, layout, stage);
+
+    if (upload.buffer) {
+        RfxBufferImpl* buffer = upload.buffer;
+        if (buffer->currentState == after || (fromCopyOnly && buffer->currentState != RFX_STATE_COPY_DST))
+            return;
+
+        nri::BufferBarrierDesc& desc = barriers.buffers.emplace_back();
+        desc.buffer = buffer->buffer;
+        desc.before = { buffer->currentAccess, buffer->currentStage };
+        desc.after = { access, stage };
+
+        buffer->currentState = after;
+        buffer->currentAccess = access;
+        buffer->currentStage = stage;
+        return;
+    }
+
+    RfxTextureSharedState* shared = upload.texture->state;
+    if (!shared)
+        return;
+
+    // the whole region at once while all subresources agree, one subresource at a time otherwise
+    uint32_t mStep = shared->uniform ? upload.mipNum : 1;
+    uint32_t lStep = shared->uniform ? upload.layerNum : 1;
+    for (uint32_t l = 0; l < upload.layerNum; l += lStep) {
+        for (uint32_t m = 0; m < upload.mipNum; m += mStep) {
+            uint32_t mip = upload.mipOffset + m;
+            uint32_t layer = upload.layerOffset + l;
+            RfxResourceState before = shared->Get(mip, layer);
+            if (before == after || (fromCopyOnly && before != RFX_STATE_COPY_DST))
+                continue;
+
+            nri::AccessBits beforeAccess;
+            nri::Layout beforeLayout;
+            nri::StageBits beforeStage;
+            GetNRIState(before, beforeAccess, beforeLayout, beforeStage);
+
+            nri::TextureBarrierDesc& desc = barriers.textures.emplace_back();
+            desc.texture = upload.texture->texture;
+            desc.before = { beforeAccess, beforeLayout, beforeStage };
+            desc.after = { access, layout, stage };
+            desc.mipOffset = (nri::Dim_t)mip;
+            desc.mipNum = (nri::Dim_t)mStep;
+            desc.layerOffset = (nri::Dim_t)layer;
+            desc.layerNum = (nri::Dim_t)lStep;
+            desc.planes = nri::PlaneBits::ALL;
+
+            if (mip == 0 && layer == 0 && mStep == shared->totalMips && lStep == shared->totalLayers) {
+                shared->SetAll(after);
+                continue;
+            }
+            for (uint32_t sl = 0; sl < lStep; ++sl) {
+                for (uint32_t sm = 0; sm < mStep; ++sm)
+                    shared->Set(mip + sm, layer + sl, after);
+            }
+        }
+    }
+}
+
+// copies every pending streamer request, wrapped in barriers from and back to the global states. StreamerMutex must be held
+static void CopyStreamedDataLocked(nri::CommandBuffer& cb) {
+    for (const CoreData::PendingUpload& upload : CORE.PendingUploads)
+        TransitionUploadRegion(upload, RFX_STATE_COPY_DST, false, CORE.PendingPreBarriers);
+    for (const CoreData::PendingUpload& upload : CORE.PendingUploads)
+        TransitionUploadRegion(upload, upload.finalState, true, CORE.PendingPostBarriers);
+    CORE.PendingUploads.clear();
+
+    SubmitPendingBarriers(cb, CORE.PendingPreBarriers);
+    CORE.NRI.CmdCopyStreamedData(cb, *CORE.NRIStreamer);
+    SubmitPendingBarriers(cb, CORE.PendingPostBarriers);
+}
+
+// copies the requests streamed for a command list. They go through their own streamer and StreamerMutex is held from
+// streaming to copying, so only the caller's request lands on cb and the prologue's requests/barriers stay put
+static void CopyListStreamedDataLocked(nri::CommandBuffer& cb) {
+    CORE.NRI.CmdCopyStreamedData(cb, *CORE.NRIListStreamer);
+}
+
 static void UploadToResource(
     RfxCommandList cmd, nri::Buffer* dstBuffer, uint64_t dstOffset, nri::Texture* dstTexture, const nri::TextureRegionDesc* dstRegion,
     const void* data, uint64_t size, uint32_t rowPitch, uint32_t slicePitch, RfxResourceState finalState, RfxBuffer bufferHandle,
     RfxTexture textureHandle
 ) {
+    std::lock_guard<std::mutex> lock(CORE.StreamerMutex);
+    nri::Streamer& streamer = cmd ? *CORE.NRIListStreamer : *CORE.NRIStreamer;
+
     // stream data
     if (dstBuffer) {
         nri::DataSize chunk = { data, size };
@@ -314,7 +457,7 @@ static void UploadToResource(
         sbd.dstBuffer = dstBuffer;
         sbd.dstOffset = dstOffset;
         sbd.placementAlignment = 1;
-        CORE.NRI.StreamBufferData(*CORE.NRIStreamer, sbd);
+        CORE.NRI.StreamBufferData(streamer, sbd);
     } else {
         nri::StreamTextureDataDesc std = {};
         std.data = data;
@@ -323,182 +466,58 @@ static void UploadToResource(
         std.dstTexture = dstTexture;
         if (dstRegion)
             std.dstRegion = *dstRegion;
-        CORE.NRI.StreamTextureData(*CORE.NRIStreamer, std);
-    }
-
-    // sync
-    if (bufferHandle) {
-        nri::AccessBits finalAccess;
-        nri::Layout finalLayout;
-        nri::StageBits finalStage;
-        GetNRIState(finalState, finalAccess, finalLayout, finalStage);
-
-        auto preBarrier = [=](nri::CommandBuffer& cb) {
-            nri::BufferBarrierDesc bbd = {};
-            bbd.buffer = dstBuffer;
-            bbd.before = { bufferHandle->currentAccess, bufferHandle->currentStage };
-            bbd.after = { nri::AccessBits::COPY_DESTINATION, nri::StageBits::COPY };
-            nri::BarrierDesc bd = {};
-            bd.buffers = &bbd;
-            bd.bufferNum = 1;
-            CORE.NRI.CmdBarrier(cb, bd);
-        };
-
-        auto postBarrier = [=](nri::CommandBuffer& cb) {
-            nri::BufferBarrierDesc bbd = {};
-            bbd.buffer = dstBuffer;
-            bbd.before = { nri::AccessBits::COPY_DESTINATION, nri::StageBits::COPY };
-            bbd.after = { finalAccess, finalStage };
-            nri::BarrierDesc bd = {};
-            bd.buffers = &bbd;
-            bd.bufferNum = 1;
-            CORE.NRI.CmdBarrier(cb, bd);
-        };
-
-        bufferHandle->currentState = finalState;
-        bufferHandle->currentAccess = finalAccess;
-        bufferHandle->currentStage = finalStage;
-
-        if (cmd) {
-            preBarrier(*cmd->nriCmd);
-            CORE.NRI.CmdCopyStreamedData(*cmd->nriCmd, *CORE.NRIStreamer);
-            postBarrier(*cmd->nriCmd);
-        } else {
-            CORE.PendingPreBarriers.push_back(preBarrier);
-            CORE.PendingPostBarriers.push_back(postBarrier);
-        }
+        CORE.NRI.StreamTextureData(streamer, std);
     }
 
-    // texture sync
-    if (textureHandle && textureHandle->state) {
-        uint32_t mStart = dstRegion ? dstRegion->mipOffset : 0;
-        uint32_t mNum = dstRegion ? 1 : textureHandle->mipNum;
-        uint32_t lStart = dstRegion ? dstRegion->layerOffset : 0;
-        uint32_t lNum = dstRegion ? 1 : textureHandle->layerNum;
-
-        // capture states of the relevant region of the texture
-        RfxVector<RfxResourceState> capturedStates;
-        capturedStates.reserve(lNum * mNum);
-        for (uint32_t l = 0; l < lNum; ++l) {
-            for (uint32_t m = 0; m < mNum; ++m) {
-                capturedStates.push_back(textureHandle->state->Get(mStart + m, lStart + l));
-            }
-        }
-
-        auto preBarrier = [=](nri::CommandBuffer& cb) {
-            nri::BarrierDesc bd = {};
-            RfxVector<nri::TextureBarrierDesc> tbds;
-
-            size_t idx = 0;
-            for (uint32_t l = 0; l < lNum; ++l) {
-                for (uint32_t m = 0; m < mNum; ++m) {
-                    uint32_t absLayer = lStart + l;
-                    uint32_t absMip = mStart + m;
-
-                    RfxResourceState oldSt = capturedStates[idx++];
-
-                    if (oldSt == RFX_STATE_COPY_DST)
-                        continue;
-
-                    nri::AccessBits acc;
-                    nri::Layout lay;
-                    nri::StageBits stg;
-                    GetNRIState(oldSt, acc, lay, stg);
-
-                    nri::TextureBarrierDesc& d = tbds.emplace_back();
-                    d.texture = dstTexture;
-                    d.before = { acc, lay, stg };
-                    d.after = { nri::AccessBits::COPY_DESTINATION, nri::Layout::COPY_DESTINATION, nri::StageBits::COPY };
-                    d.mipOffset = (nri::Dim_t)absMip;
-                    d.mipNum = 1;
-                    d.layerOffset = (nri::Dim_t)absLayer;
-                    d.layerNum = 1;
-                    d.planes = nri::PlaneBits::ALL;
-                }
-            }
-            if (!tbds.empty()) {
-                bd.textures = tbds.data();
-                bd.textureNum = (uint32_t)tbds.size();
-                CORE.NRI.CmdBarrier(cb, bd);
-            }
-        };
+    uint32_t mStart = 0, mNum = 0, lStart = 0, lNum = 0;
+    if (textureHandle) {
+        mStart = dstRegion ? dstRegion->mipOffset : 0;
+        mNum = dstRegion ? 1 : textureHandle->mipNum;
+        lStart = dstRegion ? dstRegion->layerOffset : 0;
+        lNum = dstRegion ? 1 : textureHandle->layerNum;
+    }
 
-        auto postBarrier = [=](nri::CommandBuffer& cb) {
-            nri::BarrierDesc bd = {};
-            RfxVector<nri::TextureBarrierDesc> tbds;
-            nri::AccessBits finAcc;
-            nri::Layout finLay;
-            nri::StageBits finStg;
-            GetNRIState(finalState, finAcc, finLay, finStg);
-
-            for (uint32_t l = 0; l < lNum; ++l) {
-                for (uint32_t m = 0; m < mNum; ++m) {
-                    uint32_t absLayer = lStart + l;
-                    uint32_t absMip = mStart + m;
-                    nri::TextureBarrierDesc& d = tbds.emplace_back();
-                    d.texture = dstTexture;
-                    d.before = { nri::AccessBits::COPY_DESTINATION, nri::Layout::COPY_DESTINATION, nri::StageBits::COPY };
-                    d.after = { finAcc, finLay, finStg };
-                    d.mipOffset = (nri::Dim_t)absMip;
-                    d.mipNum = 1;
-                    d.layerOffset = (nri::Dim_t)absLayer;
-                    d.layerNum = 1;
-                    d.planes = nri::PlaneBits::ALL;
-                }
-            }
-            if (!tbds.empty()) {
-                bd.textures = tbds.data();
-                bd.textureNum = (uint32_t)tbds.size();
-                CORE.NRI.CmdBarrier(cb, bd);
-            }
-        };
+    // with a command list, copy right away and track the states like any other command
+    if (cmd) {
+        if (bufferHandle)
+            cmd->barriers.RequireState(bufferHandle, RFX_STATE_COPY_DST);
+        if (textureHandle)
+            cmd->barriers.RequireState(textureHandle, RFX_STATE_COPY_DST, mStart, mNum, lStart, lNum);
+        cmd->FlushBarriers();
 
-        // update shared state
-        for (uint32_t l = 0; l < lNum; ++l) {
-            for (uint32_t m = 0; m < mNum; ++m) {
-                textureHandle->state->Set(mStart + m, lStart + l, finalState);
-            }
-        }
+        CopyListStreamedDataLocked(cmd->Direct());
 
-        if (cmd) {
-            preBarrier(*cmd->nriCmd);
-            CORE.NRI.CmdCopyStreamedData(*cmd->nriCmd, *CORE.NRIStreamer);
-            postBarrier(*cmd->nriCmd);
-        } else {
-            CORE.PendingPreBarriers.push_back(preBarrier);
-            CORE.PendingPostBarriers.push_back(postBarrier);
-        }
+        if (bufferHandle)
+            cmd->barriers.RequireState(bufferHandle, finalState);
+        if (textureHandle)
+            cmd->barriers.RequireState(textureHandle, finalState, mStart, mNum, lStart, lNum);
+        return;
     }
+
+    // barriers and global states are settled when the prologue records the copy
+    CORE.PendingUploads.push_back({ bufferHandle, textureHandle, mStart, mNum, lStart, lNum, finalState });
 }
 
 static uint32_t AllocTextureSlot() {
-    uint32_t id;
-    if (!CORE.Bindless.freeTextureSlots.empty()) {
-        id = CORE.Bindless.freeTextureSlots.back();
-        CORE.Bindless.freeTextureSlots.pop_back();
-    } else {
-        RFX_ASSERT(CORE.Bindless.textureHighWaterMark < RFX_MAX_BINDLESS_TEXTURES);
-        id = CORE.Bindless.textureHighWaterMark++;
-    }
+    uint32_t id = CORE.Bindless.textureSlots.Alloc();
+    RFX_ASSERT(id != CORE.Bindless.textureSlots.INVALID);
     return id;
 }
 
 static void FreeTextureSlot(uint32_t id) {
-    CORE.Bindless.freeTextureSlots.push_back(id);
+    CORE.Bindless.textureSlots.Free(id);
 }
 
 static uint32_t AllocBufferSlot() {
-    uint32_t id;
-    if (!CORE.Bindless.freeBufferSlots.empty()) {
-        id = CORE.Bindless.freeBufferSlots.back();
-        CORE.Bindless.freeBufferSlots.pop_back();
-    } else {
-        RFX_ASSERT(CORE.Bindless.bufferHighWaterMark < RFX_MAX_BINDLESS_TEXTURES);
-        id = CORE.Bindless.bufferHighWaterMark++;
-    }
+    uint32_t id = CORE.Bindless.bufferSlots.Alloc();
+    RFX_ASSERT(id != CORE.Bindless.bufferSlots.INVALID);
     return id;
 }
 
+static void FreeBufferSlot(uint32_t id) {
+    CORE.Bindless.bufferSlots.Free(id);
+}
+
 static void SubmitImmediate(std::function<void(nri::CommandBuffer&)> work) {
     nri::CommandAllocator* allocator;
     nri::CommandBuffer* cmd;
@@ -886,6 +905,7 @@ static void SetupComputePipeline(RfxPipelineImpl* impl, const RfxComputePipeline
 }
 
 static void UpdateBindlessDescriptor(uint32_t rangeIndex, uint32_t descriptorIndex, nri::Descriptor* descriptor) {
+    std::lock_guard<std::mutex> lock(CORE.Bindless.updateMutex);
     nri::UpdateDescriptorRangeDesc update = {};
     update.descriptorSet = CORE.Bindless.globalDescriptorSet;
     update.rangeIndex = rangeIndex;
@@ -985,111 +1005,320 @@ static void CreateTextureDescriptors(
 // Barrier batcher
 //
 
+// returns the batch of the previous use, which may be this one when nothing was flushed since
+template <typename Tracked>
+static uint64_t TouchTracked(Tracked& tracked, uint64_t batch) {
+    uint64_t lastUse = tracked.useBatch;
+    tracked.useBatch = batch;
+    return lastUse;
+}
+
 void BarrierBatcher::RequireState(RfxBuffer buffer, RfxResourceState state) {
     if (!buffer)
         return;
 
-    if (buffer->currentState == state)
-        return;
-
     nri::AccessBits nextAccess;
     nri::Layout nextLayout;
     nri::StageBits nextStage;
     GetNRIState(state, nextAccess, nextLayout, nextStage);
 
-    bool found = false;
-    for (auto& barrier : bufferBarriers) {
-        if (barrier.buffer == buffer->buffer) {
-            barrier.after = { nextAccess, nextStage };
-            found = true;
-            break;
-        }
+    // first use, Resolve moves it here before the list runs
+    auto [it, inserted] = bufferIndices.try_emplace(buffer, (uint32_t)buffers.size());
+    if (inserted) {
+        buffers.push_back({ buffer, state, state, nextAccess, nextStage, 0, 0, batch, 0 });
+        return;
     }
 
-    if (!found) {
+    TrackedBuffer& tracked = buffers[it->second];
+    uint64_t lastUse = TouchTracked(tracked, batch);
+    if (tracked.current == state)
+        return;
+
+    if (tracked.pendingBatch == batch) {
+        bufferBarriers[tracked.pendingSlot].after = { nextAccess, nextStage };
+    } else {
+        tracked.pendingBatch = batch;
+        tracked.pendingSlot = (uint32_t)bufferBarriers.size();
+        tracked.pendingUseBatch = lastUse;
+
         nri::BufferBarrierDesc& desc = bufferBarriers.emplace_back();
         desc.buffer = buffer->buffer;
-        desc.before = { buffer->currentAccess, buffer->currentStage };
+        desc.before = { tracked.access, tracked.stage };
         desc.after = { nextAccess, nextStage };
     }
 
-    buffer->currentState = state;
-    buffer->currentAccess = nextAccess;
-    buffer->currentStage = nextStage;
+    tracked.current = state;
+    tracked.access = nextAccess;
+    tracked.stage = nextStage;
 }
 
-void BarrierBatcher::RequireState(RfxTexture texture, RfxResourceState nextState) {
+void BarrierBatcher::RequireState(RfxTexture texture, RfxResourceState state) {
+    if (texture)
+        RequireState(texture, state, texture->mipOffset, texture->mipNum, texture->layerOffset, texture->layerNum);
+}
+
+void BarrierBatcher::RequireState(
+    RfxTexture texture, RfxResourceState state, uint32_t mipOffset, uint32_t mipNum, uint32_t layerOffset, uint32_t layerNum
+) {
     if (!texture || !texture->state)
         return;
 
-    for (uint32_t l = 0; l < texture->layerNum; ++l) {
-        uint32_t absLayer = texture->layerOffset + l;
-
-        uint32_t currentStartMip = 0;
-        uint32_t currentMipCount = 0;
-        RfxResourceState batchOldState = RFX_STATE_UNDEFINED;
-        bool inBatch = false;
+    // only record the new states here, Flush diffs them against the batch start
+    uint32_t index = TrackTexture(texture);
+    TrackedTexture& tracked = textures[index];
+    uint64_t lastUse = TouchTracked(tracked, batch);
+    bool joined = tracked.pendingBatch == batch;
 
-        auto FlushBatch = [&](uint32_t layerIdx) {
-            if (!inBatch)
+    // whole-texture transitions cost the same for any number of subresources, until one of them is transitioned alone
+    if (tracked.uniform) {
+        if (mipOffset == 0 && layerOffset == 0 && mipNum == tracked.shared->totalMips && layerNum == tracked.shared->totalLayers) {
+            if (tracked.current == state)
                 return;
 
-            nri::AccessBits oldAccess, newAccess;
-            nri::Layout oldLayout, newLayout;
-            nri::StageBits oldStage, newStage;
-
-            GetNRIState(batchOldState, oldAccess, oldLayout, oldStage);
-            GetNRIState(nextState, newAccess, newLayout, newStage);
-
-            nri::TextureBarrierDesc& desc = textureBarriers.emplace_back();
-            desc.texture = texture->texture;
-            desc.before = { oldAccess, oldLayout, oldStage };
-            desc.after = { newAccess, newLayout, newStage };
-            desc.mipOffset = (nri::Dim_t)currentStartMip;
-            desc.mipNum = (nri::Dim_t)currentMipCount;
-            desc.layerOffset = (nri::Dim_t)layerIdx;
-            desc.layerNum = 1;
-            desc.planes = nri::PlaneBits::ALL;
+            // first use, Resolve moves it here before the list runs
+            if (tracked.current == UNTRACKED) {
+                tracked.first = state;
+                tracked.current = state;
+                if (joined)
+                    tracked.batchStart = state;
+                return;
+            }
 
-            for (uint32_t m = 0; m < currentMipCount; ++m) {
-                texture->state->Set(currentStartMip + m, layerIdx, nextState);
+            if (!joined) {
+                tracked.pendingBatch = batch;
+                tracked.pendingUseBatch = lastUse;
+                tracked.batchStart = tracked.current;
+                pendingTextures.push_back(index);
             }
+            tracked.current = state;
+            return;
+        }
+        Expand(tracked);
+    }
 
-            inBatch = false;
-            currentMipCount = 0;
-        };
+    RfxResourceState* first = &states[tracked.states];
+    RfxResourceState* current = first + tracked.subresourceNum;
+    RfxResourceState* batchStart = current + tracked.subresourceNum;
 
-        for (uint32_t m = 0; m < texture->mipNum; ++m) {
-            uint32_t absMip = texture->mipOffset + m;
-            RfxResourceState currentSubState = texture->state->Get(absMip, absLayer);
+    for (uint32_t l = 0; l < layerNum; ++l) {
+        for (uint32_t m = 0; m < mipNum; ++m) {
+            uint32_t i = (layerOffset + l) * tracked.shared->totalMips + mipOffset + m;
+            if (current[i] == state)
+                continue;
 
-            if (currentSubState == nextState) {
-                FlushBatch(absLayer);
+            // first use, Resolve moves it here before the list runs
+            if (current[i] == UNTRACKED) {
+                first[i] = state;
+                current[i] = state;
+                if (joined)
+                    batchStart[i] = state;
                 continue;
             }
 
-            if (!inBatch) {
-                inBatch = true;
-                currentStartMip = absMip;
-                currentMipCount = 1;
-                batchOldState = currentSubState;
-            } else {
-                if (currentSubState == batchOldState) {
-                    currentMipCount++;
+            if (!joined) {
+                tracked.pendingBatch = batch;
+                tracked.pendingUseBatch = lastUse;
+                std::copy(current, current + tracked.subresourceNum, batchStart);
+                pendingTextures.push_back(index);
+                joined = true;
+            }
+            current[i] = state;
+        }
+    }
+}
+
+void BarrierBatcher::Assume(RfxBuffer buffer, RfxResourceState state) {
+    if (!buffer)
+        return;
+
+    nri::AccessBits access;
+    nri::Layout layout;
+    nri::StageBits stage;
+    GetNRIState(state, access, layout, stage);
+
+    auto [it, inserted] = bufferIndices.try_emplace(buffer, (uint32_t)buffers.size());
+    if (inserted) {
+        buffers.push_back({ buffer, state, state, access, stage, 0, 0, batch, 0 });
+        return;
+    }
+
+    TrackedBuffer& tracked = buffers[it->second];
+    TouchTracked(tracked, batch);
+    tracked.current = state;
+    tracked.access = access;
+    tracked.stage = stage;
+    tracked.pendingBatch = 0;
+}
+
+void BarrierBatcher::Assume(RfxTexture texture, RfxResourceState state) {
+    if (!texture || !texture->state)
+        return;
+
+    TrackedTexture& tracked = textures[TrackTexture(texture)];
+    TouchTracked(tracked, batch);
+    bool joined = tracked.pendingBatch == batch;
+
+    if (tracked.uniform) {
+        if (texture->mipOffset == 0 && texture->layerOffset == 0 && texture->mipNum == tracked.shared->totalMips &&
+            texture->layerNum == tracked.shared->totalLayers) {
+            if (tracked.current == UNTRACKED)
+                tracked.first = state;
+            tracked.current = state;
+            if (joined)
+                tracked.batchStart = state;
+            return;
+        }
+        Expand(tracked);
+    }
+
+    RfxResourceState* first = &states[tracked.states];
+    RfxResourceState* current = first + tracked.subresourceNum;
+    RfxResourceState* batchStart = current + tracked.subresourceNum;
+
+    for (uint32_t l = 0; l < texture->layerNum; ++l) {
+        for (uint32_t m = 0; m < texture->mipNum; ++m) {
+            uint32_t i = (texture->layerOffset + l) * tracked.shared->totalMips + texture->mipOffset + m;
+            if (current[i] == UNTRACKED)
+                first[i] = state;
+            current[i] = state;
+            if (joined)
+                batchStart[i] = state;
+        }
+    }
+}
+
+void BarrierBatcher::AliasMemory(RfxBuffer buffer, nri::AccessBits access, nri::StageBits stage) {
+    // the barrier out of UNDEFINED starts from the tracked access
+    TrackedBuffer* tracked = Find(buffer);
+    if (tracked) {
+        tracked->access = access;
+        tracked->stage = stage;
+    }
+}
+
+void BarrierBatcher::AliasMemory(RfxTexture texture, nri::AccessBits access, nri::StageBits stage) {
+    if (texture)
+        textureAliases.push_back({ texture->texture, access, stage });
+}
+
+BarrierBatcher::TrackedBuffer* BarrierBatcher::Find(RfxBuffer buffer) {
+    auto it = bufferIndices.find(buffer);
+    return it != bufferIndices.end() ? &buffers[it->second] : nullptr;
+}
+
+bool BarrierBatcher::PendingUsedSince(uint64_t sinceBatch) const {
+    if (!globalBarriers.empty())
+        return true;
+    for (const TrackedBuffer& tracked : buffers) {
+        if (tracked.pendingBatch == batch && tracked.pendingUseBatch >= sinceBatch)
+            return true;
+    }
+    for (uint32_t index : pendingTextures) {
+        if (textures[index].pendingUseBatch >= sinceBatch)
+            return true;
+    }
+    return false;
+}
+
+RfxResourceState BarrierBatcher::GetState(RfxTexture texture, uint32_t mip, uint32_t layer) {
+    auto it = textureIndices.find(texture->state);
+    if (it == textureIndices.end())
+        return UNTRACKED;
+
+    const TrackedTexture& tracked = textures[it->second];
+    if (tracked.uniform)
+        return tracked.current;
+    return states[tracked.states + tracked.subresourceNum + layer * texture->state->totalMips + mip];
+}
+
+uint32_t BarrierBatcher::TrackTexture(RfxTexture texture) {
+    RfxTextureSharedState* shared = texture->state;
+    auto [it, inserted] = textureIndices.try_emplace(shared, (uint32_t)textures.size());
+    if (inserted) {
+        uint32_t subresourceNum = shared->totalMips * shared->totalLayers;
+        textures.push_back({ texture->texture, shared, 0, subresourceNum, 0, true, UNTRACKED, UNTRACKED, UNTRACKED, 0, 0 });
+    }
+    return it->second;
+}
+
+// switches a tracked texture to per-subresource states
+void BarrierBatcher::Expand(TrackedTexture& tracked) {
+    tracked.states = (uint32_t)states.size();
+    states.insert(states.end(), tracked.subresourceNum, tracked.first);
+    states.insert(states.end(), tracked.subresourceNum, tracked.current);
+    states.insert(states.end(), tracked.subresourceNum, tracked.batchStart);
+    tracked.uniform = false;
+}
+
+// nothing to wait for on untouched subresources, or before discarding the contents
+static bool NeedsTextureBarrier(RfxResourceState before, RfxResourceState after) {
+    return before != after && before != BarrierBatcher::UNTRACKED && after != BarrierBatcher::UNTRACKED && after != RFX_STATE_UNDEFINED;
+}
+
+void BarrierBatcher::AddTextureBarrier(
+    nri::Texture* texture, RfxResourceState before, RfxResourceState after, uint32_t mipOffset, uint32_t mipNum, uint32_t layerOffset,
+    uint32_t layerNum
+) {
+    nri::AccessBits oldAccess, newAccess;
+    nri::Layout oldLayout, newLayout;
+    nri::StageBits oldStage, newStage;
+    GetNRIState(before, oldAccess, oldLayout, oldStage);
+    GetNRIState(after, newAccess, newLayout, newStage);
+
+    nri::TextureBarrierDesc& desc = textureBarriers.emplace_back();
+    desc.texture = texture;
+    desc.before = { oldAccess, oldLayout, oldStage };
+    desc.after = { newAccess, newLayout, newStage };
+    desc.mipOffset = (nri::Dim_t)mipOffset;
+    desc.mipNum = (nri::Dim_t)mipNum;
+    desc.layerOffset = (nri::Dim_t)layerOffset;
+    desc.layerNum = (nri::Dim_t)layerNum;
+    desc.planes = nri::PlaneBits::ALL;
+}
+
+// one barrier per run of mips with the same transition, extended over consecutive layers
+void BarrierBatcher::EmitTextureBarriers(
+    nri::Texture* texture, const RfxTextureSharedState* shared, const RfxResourceState* before, const RfxResourceState* after
+) {
+    openRuns.clear();
+
+    for (uint32_t layer = 0; layer < shared->totalLayers; ++layer) {
+        nextRuns.clear();
+
+        for (uint32_t mip = 0; mip < shared->totalMips;) {
+            uint32_t base = layer * shared->totalMips;
+            RfxResourceState from = before[base + mip];
+            RfxResourceState to = after[base + mip];
+
+            uint32_t mipNum = 1;
+            while (mip + mipNum < shared->totalMips && before[base + mip + mipNum] == from && after[base + mip + mipNum] == to)
+                mipNum++;
+
+            if (NeedsTextureBarrier(from, to)) {
+                // the same run on the layer before becomes one multi-layer barrier
+                LayerRun* run = nullptr;
+                for (LayerRun& r : openRuns) {
+                    if (r.mipOffset == mip && r.mipNum == mipNum && r.before == from && r.after == to) {
+                        run = &r;
+                        break;
+                    }
+                }
+
+                if (run) {
+                    textureBarriers[run->barrier].layerNum++;
+                    nextRuns.push_back(*run);
                 } else {
-                    FlushBatch(absLayer);
-                    inBatch = true;
-                    currentStartMip = absMip;
-                    currentMipCount = 1;
-                    batchOldState = currentSubState;
+                    AddTextureBarrier(texture, from, to, mip, mipNum, layer, 1);
+                    nextRuns.push_back({ (uint32_t)textureBarriers.size() - 1, mip, mipNum, from, to });
                 }
             }
+            mip += mipNum;
         }
-        FlushBatch(absLayer);
+        std::swap(openRuns, nextRuns);
     }
 }
 
-void BarrierBatcher::Flush(nri::CommandBuffer& cmd) {
+void BarrierBatcher::Submit(nri::CommandBuffer& cmd) {
     if (bufferBarriers.empty() && textureBarriers.empty() && globalBarriers.empty())
         return;
 
@@ -1108,11 +1337,120 @@ void BarrierBatcher::Flush(nri::CommandBuffer& cmd) {
     globalBarriers.clear();
 }
 
+void BarrierBatcher::Flush(nri::CommandBuffer& cmd) {
+    for (uint32_t index : pendingTextures) {
+        const TrackedTexture& tracked = textures[index];
+        if (tracked.uniform) {
+            if (NeedsTextureBarrier(tracked.batchStart, tracked.current))
+                AddTextureBarrier(
+                    tracked.texture, tracked.batchStart, tracked.current, 0, tracked.shared->totalMips, 0, tracked.shared->totalLayers
+                );
+        } else {
+            const RfxResourceState* current = &states[tracked.states + tracked.subresourceNum];
+            EmitTextureBarriers(tracked.texture, tracked.shared, current + tracked.subresourceNum, current);
+        }
+    }
+    pendingTextures.clear();
+    batch++;
+
+    // the layout is discarded either way, but the memory's previous use still has to finish first
+    for (const TextureAlias& alias : textureAliases) {
+        for (nri::TextureBarrierDesc& desc : textureBarriers) {
+            if (desc.texture == alias.texture && desc.before.layout == nri::Layout::UNDEFINED)
+                desc.before = { alias.access, nri::Layout::UNDEFINED, alias.stage };
+        }
+    }
+    textureAliases.clear();
+
+    Submit(cmd);
+}
+
+uint64_t BarrierBatcher::Resolve(nri::CommandBuffer& cmd) {
+    RFX_ASSERT(!HasPending() && "flush the list before resolving it");
+
+    uint64_t uploadValue = 0;
+    for (const TrackedBuffer& tracked : buffers) {
+        RfxBuffer buffer = tracked.buffer;
+        uploadValue = std::max(uploadValue, buffer->uploadValue);
+
+        // writes of an earlier submission still need a UAV barrier
+        bool isWrite = tracked.first == RFX_STATE_SHADER_WRITE || tracked.first == RFX_STATE_COMPUTE_WRITE;
+        if (tracked.first != RFX_STATE_UNDEFINED && (tracked.first != buffer->currentState || isWrite)) {
+            nri::AccessBits access;
+            nri::Layout layout;
+            nri::StageBits stage;
+            GetNRIState(tracked.first, access, layout, stage);
+
+            nri::BufferBarrierDesc& desc = bufferBarriers.emplace_back();
+            desc.buffer = buffer->buffer;
+            desc.before = { buffer->currentAccess, buffer->currentStage };
+            desc.after = { access, stage };
+        }
+
+        buffer->currentState = tracked.current;
+        buffer->currentAccess = tracked.access;
+        buffer->currentStage = tracked.stage;
+    }
+
+    for (TrackedTexture& tracked : textures) {
+        RfxTextureSharedState* shared = tracked.shared;
+        uploadValue = std::max(uploadValue, shared->uploadValue);
+        if (tracked.uniform && shared->uniform) {
+            if (NeedsTextureBarrier(shared->uniformState, tracked.first))
+                AddTextureBarrier(tracked.texture, shared->uniformState, tracked.first, 0, shared->totalMips, 0, shared->totalLayers);
+            if (tracked.current != UNTRACKED)
+                shared->SetAll(tracked.current);
+            continue;
+        }
+
+        if (tracked.uniform)
+            Expand(tracked);
+        shared->Expand();
+
+        const RfxResourceState* first = &states[tracked.states];
+        const RfxResourceState* current = first + tracked.subresourceNum;
+        EmitTextureBarriers(tracked.texture, shared, shared->subresourceStates.data(), first);
+
+        for (uint32_t i = 0; i < tracked.subresourceNum; ++i) {
+            if (current[i] != UNTRACKED)
+                shared->subresourceStates[i] = current[i];
+        }
+        shared->Compact();
+    }
+
+    Submit(cmd);
+    Reset();
+    return uploadValue;
+}
+
+void BarrierBatcher::Reset() {
+    buffers.clear();
+    textures.clear();
+    states.clear();
+    bufferIndices.clear();
+    textureIndices.clear();
+    pendingTextures.clear();
+    textureAliases.clear();
+
+    bufferBarriers.clear();
+    textureBarriers.clear();
+    globalBarriers.clear();
+}
+
 //
 // Command list
 //
 
 void RfxCommandListImpl::PrepareForDraw() {
+    if (recordingBundle) {
+        // states are applied by whoever executes the bundle
+        if (currentVertexBuffer)
+            recordingBundle->Require(currentVertexBuffer, RFX_STATE_VERTEX_BUFFER);
+        if (currentIndexBuffer)
+            recordingBundle->Require(currentIndexBuffer, RFX_STATE_INDEX_BUFFER);
+        return;
+    }
+
     if (currentVertexBuffer)
         barriers.RequireState(currentVertexBuffer, RFX_STATE_VERTEX_BUFFER);
     if (currentIndexBuffer)
@@ -1121,17 +1459,28 @@ void RfxCommandListImpl::PrepareForDraw() {
 
 void RfxCommandListImpl::BindDrawBuffers() {
     if (currentPipeline && currentPipeline->vertexStride > 0 && currentVertexBuffer) {
-        if (currentVertexBuffer != lastBoundVertexBuffer) {
-            nri::VertexBufferDesc vbd = { currentVertexBuffer->buffer, 0, currentPipeline->vertexStride };
-            CORE.NRI.CmdSetVertexBuffers(*nriCmd, 0, &vbd, 1);
+        if (currentVertexBuffer != lastBoundVertexBuffer || currentVertexOffset != lastBoundVertexOffset) {
+            nri::VertexBufferDesc vbd = { currentVertexBuffer->buffer, currentVertexOffset, currentPipeline->vertexStride };
+            if (deferred)
+                stream.Push(RfxStreamOp::SET_VERTEX_BUFFER, vbd);
+            else
+                CORE.NRI.CmdSetVertexBuffers(*nriCmd, 0, &vbd, 1);
             lastBoundVertexBuffer = currentVertexBuffer;
+            lastBoundVertexOffset = currentVertexOffset;
         }
     }
 
     if (currentIndexBuffer) {
-        if (currentIndexBuffer != lastBoundIndexBuffer) {
-            CORE.NRI.CmdSetIndexBuffer(*nriCmd, *currentIndexBuffer->buffer, 0, currentIndexType);
+        if (currentIndexBuffer != lastBoundIndexBuffer || currentIndexOffset != lastBoundIndexOffset) {
+            if (deferred) {
+                stream.Push(RfxStreamOp::SET_INDEX_BUFFER, currentIndexBuffer->buffer);
+                stream.Write(&currentIndexOffset, sizeof(currentIndexOffset));
+                stream.Write(&currentIndexType, sizeof(currentIndexType));
+            } else {
+                CORE.NRI.CmdSetIndexBuffer(*nriCmd, *currentIndexBuffer->buffer, currentIndexOffset, currentIndexType);
+            }
             lastBoundIndexBuffer = currentIndexBuffer;
+            lastBoundIndexOffset = currentIndexOffset;
         }
     }
 }
@@ -1140,65 +1489,343 @@ void RfxCommandListImpl::FlushBarriers() {
     if (!barriers.HasPending())
         return;
 
-    if (isRendering) {
-        // FIXME: this should not be legal
-        // RFX_ASSERT(false && "TODO would break rp");
-        CORE.NRI.CmdEndRendering(*nriCmd);
+    if (renderingPending && hoistBarriers && !barriers.PendingUsedSince(passBatch)) {
+        // the pass isn't open on the NRI side yet and nothing recorded inside it so far touches these resources, so hoist
+        // the barriers in front of it. Bindless uses aren't visible here, the caller vouched for them
         barriers.Flush(*nriCmd);
-        CORE.NRI.CmdBeginRendering(*nriCmd, currentRenderingDesc);
+        return;
+    }
+
+    nri::CommandBuffer& cb = Direct();
+    if (isRendering) {
+        // last resort, tiled GPUs pay dearly for this. See RfxPassResource
+        passRestarts++;
+        CORE.NRI.CmdEndRendering(cb);
+        barriers.Flush(cb);
+        CORE.NRI.CmdBeginRendering(cb, currentRenderingDesc);
+        shadow.InvalidateDynamic();
 
         // restore state
-        CORE.NRI.CmdSetViewports(*nriCmd, &currentViewport, 1);
+        SetViewports(&currentViewport, 1);
         if (scissorSet) {
-            CORE.NRI.CmdSetScissors(*nriCmd, &currentScissor, 1);
+            SetScissor(currentScissor);
         } else {
             nri::Rect r = { (int16_t)currentViewport.x, (int16_t)currentViewport.y, (nri::Dim_t)currentViewport.width,
                             (nri::Dim_t)currentViewport.height };
-            CORE.NRI.CmdSetScissors(*nriCmd, &r, 1);
+            SetScissor(r);
         }
     } else {
-        barriers.Flush(*nriCmd);
+        barriers.Flush(cb);
     }
 }
 
-//
-// Command list
-//
+void RfxCommandListImpl::BeginRendering() {
+    nri::CommandBuffer& cb = Direct();
 
-RfxCommandList rfxGetCommandList() {
-    uint32_t idx = CORE.FrameIndex % GetQueuedFrameNum();
-    return &CORE.QueuedFrames[idx].wrapper;
-}
+    // attachments and pass resources are required in this batch, requirements recorded inside the pass go to later ones
+    passBatch = barriers.batch;
+    barriers.Flush(cb);
 
-static void RecreateSwapChain(int w, int h) {
-    CORE.NRI.QueueWaitIdle(CORE.NRIGraphicsQueue);
-    for (auto& s : CORE.SwapChainTextures) {
-        CORE.NRI.DestroyFence(s.acquireSemaphore);
-        CORE.NRI.DestroyFence(s.releaseSemaphore);
-        CORE.NRI.DestroyDescriptor(s.colorAttachment);
-    }
-    CORE.SwapChainTextures.clear();
-    if (CORE.NRISwapChain)
-        CORE.NRI.DestroySwapChain(CORE.NRISwapChain);
+    if (deferred)
+        renderingPending = true;
+    else
+        CORE.NRI.CmdBeginRendering(cb, currentRenderingDesc);
+    isRendering = true;
+}
 
-    nri::SwapChainDesc scd = {};
-    scd.window = CORE.NRIWindow;
-    scd.queue = CORE.NRIGraphicsQueue;
-    scd.format = nri::SwapChainFormat::BT709_G22_8BIT;
-    scd.flags = (CORE.VsyncEnable ? nri::SwapChainBits::VSYNC : nri::SwapChainBits::NONE) | nri::SwapChainBits::ALLOW_TEARING;
-    if (CORE.AllowLowLatency)
-        scd.flags |= nri::SwapChainBits::ALLOW_LOW_LATENCY;
-    scd.width = (uint16_t)w;
-    scd.height = (uint16_t)h;
-    scd.textureNum = 3;
-    scd.queuedFrameNum = GetQueuedFrameNum();
+void RfxCommandListImpl::OpenPendingPass() {
+    renderingPending = false;
+    CORE.NRI.CmdBeginRendering(*nriCmd, currentRenderingDesc);
+}
 
-    if (CORE.NRI.CreateSwapChain(*CORE.NRIDevice, scd, CORE.NRISwapChain) != nri::Result::SUCCESS) {
-        CORE.NRISwapChain = nullptr;
-        return;
-    }
+// layout + the global bindless set, which has to be rebound whenever the layout changes
+static void EmitPipelineLayout(nri::CommandBuffer& cb, RfxPipelineImpl* pipeline) {
+    CORE.NRI.CmdSetPipelineLayout(cb, pipeline->bindPoint, *pipeline->shader->pipelineLayout);
 
-    if (CORE.AllowLowLatency && CORE.LowLatencyEnabled) {
+    nri::SetDescriptorSetDesc bindlessSet = {};
+    bindlessSet.setIndex = pipeline->shader->bindlessSetIndex;
+    bindlessSet.descriptorSet = CORE.Bindless.globalDescriptorSet;
+    bindlessSet.bindPoint = pipeline->bindPoint;
+    CORE.NRI.CmdSetDescriptorSet(cb, bindlessSet);
+}
+
+template <typename T>
+static T ReadStream(const uint8_t*& p) {
+    T v;
+    memcpy(&v, p, sizeof(T));
+    p += sizeof(T);
+    return v;
+}
+
+// translates encoded commands into NRI calls
+static void ReplayCommands(nri::CommandBuffer& cb, const uint8_t* p, size_t size) {
+    const uint8_t* end = p + size;
+
+    while (p < end) {
+        switch (ReadStream<RfxStreamOp>(p)) {
+        case RfxStreamOp::SET_PIPELINE_LAYOUT:
+            EmitPipelineLayout(cb, ReadStream<RfxPipelineImpl*>(p));
+            break;
+        case RfxStreamOp::SET_PIPELINE:
+            CORE.NRI.CmdSetPipeline(cb, *ReadStream<RfxPipelineImpl*>(p)->pipeline);
+            break;
+        case RfxStreamOp::SET_VIEWPORTS: {
+            uint8_t count = ReadStream<uint8_t>(p);
+            nri::Viewport vp[RFX_MAX_STREAM_VIEWPORTS];
+            memcpy(vp, p, sizeof(nri::Viewport) * count);
+            p += sizeof(nri::Viewport) * count;
+            CORE.NRI.CmdSetViewports(cb, vp, count);
+            break;
+        }
+        case RfxStreamOp::SET_SCISSOR: {
+            nri::Rect r = ReadStream<nri::Rect>(p);
+            CORE.NRI.CmdSetScissors(cb, &r, 1);
+            break;
+        }
+        case RfxStreamOp::SET_BLEND_CONSTANTS:
+            CORE.NRI.CmdSetBlendConstants(cb, ReadStream<nri::Color32f>(p));
+            break;
+        case RfxStreamOp::SET_STENCIL_REF: {
+            uint8_t front = ReadStream<uint8_t>(p);
+            uint8_t back = ReadStream<uint8_t>(p);
+            CORE.NRI.CmdSetStencilReference(cb, front, back);
+            break;
+        }
+        case RfxStreamOp::SET_DEPTH_BIAS:
+            CORE.NRI.CmdSetDepthBias(cb, ReadStream<nri::DepthBiasDesc>(p));
+            break;
+        case RfxStreamOp::PUSH_CONSTANTS: {
+            nri::SetRootConstantsDesc desc = {};
+            desc.bindPoint = ReadStream<nri::BindPoint>(p);
+            desc.size = ReadStream<uint16_t>(p);
+            desc.data = p; // NRI copies root constants on record
+            p += desc.size;
+            CORE.NRI.CmdSetRootConstants(cb, desc);
+            break;
+        }
+        case RfxStreamOp::SET_VERTEX_BUFFER: {
+            nri::VertexBufferDesc vbd = ReadStream<nri::VertexBufferDesc>(p);
+            CORE.NRI.CmdSetVertexBuffers(cb, 0, &vbd, 1);
+            break;
+        }
+        case RfxStreamOp::SET_INDEX_BUFFER: {
+            nri::Buffer* buffer = ReadStream<nri::Buffer*>(p);
+            uint64_t offset = ReadStream<uint64_t>(p);
+            nri::IndexType indexType = ReadStream<nri::IndexType>(p);
+            CORE.NRI.CmdSetIndexBuffer(cb, *buffer, offset, indexType);
+            break;
+        }
+        case RfxStreamOp::DRAW:
+            CORE.NRI.CmdDraw(cb, ReadStream<nri::DrawDesc>(p));
+            break;
+        case RfxStreamOp::DRAW_INDEXED:
+            CORE.NRI.CmdDrawIndexed(cb, ReadStream<nri::DrawIndexedDesc>(p));
+            break;
+        case RfxStreamOp::DISPATCH:
+            CORE.NRI.CmdDispatch(cb, ReadStream<nri::DispatchDesc>(p));
+            break;
+        case RfxStreamOp::DRAW_MESH_TASKS:
+            CORE.NRI.CmdDrawMeshTasks(cb, ReadStream<nri::DrawMeshTasksDesc>(p));
+            break;
+        default:
+            RFX_ASSERT(false && "corrupt command stream");
+            p = end;
+            break;
+        }
+    }
+}
+
+void RfxCommandListImpl::ReplayStream() {
+    ReplayCommands(*nriCmd, stream.bytes.data(), stream.bytes.size());
+    stream.Reset();
+}
+
+void RfxCommandListImpl::SetPipeline(RfxPipelineImpl* pipeline) {
+    nri::PipelineLayout* layout = pipeline->shader->pipelineLayout;
+    if (shadow.layout == layout && shadow.layoutBindPoint == pipeline->bindPoint) {
+        elidedCalls += 2; // layout + bindless set
+    } else {
+        if (deferred)
+            stream.Push(RfxStreamOp::SET_PIPELINE_LAYOUT, pipeline);
+        else
+            EmitPipelineLayout(*nriCmd, pipeline);
+        shadow.layout = layout;
+        shadow.layoutBindPoint = pipeline->bindPoint;
+        shadow.pushConstantsSize = 0; // root constants don't survive a layout change
+    }
+
+    if (shadow.pipeline == pipeline->pipeline) {
+        elidedCalls++;
+        return;
+    }
+    if (deferred)
+        stream.Push(RfxStreamOp::SET_PIPELINE, pipeline);
+    else
+        CORE.NRI.CmdSetPipeline(*nriCmd, *pipeline->pipeline);
+    shadow.pipeline = pipeline->pipeline;
+}
+
+void RfxCommandListImpl::SetRootConstants(nri::BindPoint bindPoint, const void* data, uint32_t size) {
+    if (shadow.pushConstantsSize == size && memcmp(shadow.pushConstants, data, size) == 0) {
+        elidedCalls++;
+        return;
+    }
+    if (size <= RFX_MAX_SHADOWED_PUSH_CONSTANTS) {
+        memcpy(shadow.pushConstants, data, size);
+        shadow.pushConstantsSize = size;
+    } else {
+        shadow.pushConstantsSize = 0;
+    }
+
+    if (deferred) {
+        uint16_t size16 = (uint16_t)size;
+        stream.Push(RfxStreamOp::PUSH_CONSTANTS, bindPoint);
+        stream.Write(&size16, sizeof(size16));
+        stream.Write(data, size);
+    } else {
+        nri::SetRootConstantsDesc desc = {};
+        desc.rootConstantIndex = 0;
+        desc.data = data;
+        desc.size = size;
+        desc.bindPoint = bindPoint;
+        CORE.NRI.CmdSetRootConstants(*nriCmd, desc);
+    }
+}
+
+void RfxCommandListImpl::SetDescriptorPool(nri::DescriptorPool* pool) {
+    if (shadow.descriptorPool == pool) {
+        elidedCalls++;
+        return;
+    }
+    CORE.NRI.CmdSetDescriptorPool(Direct(), *pool);
+    shadow.descriptorPool = pool;
+}
+
+// field-wise, nri::Viewport has padding after originBottomLeft
+static bool SameViewports(const nri::Viewport* a, const nri::Viewport* b, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        if (a[i].x != b[i].x || a[i].y != b[i].y || a[i].width != b[i].width || a[i].height != b[i].height ||
+            a[i].depthMin != b[i].depthMin || a[i].depthMax != b[i].depthMax || a[i].originBottomLeft != b[i].originBottomLeft)
+            return false;
+    }
+    return true;
+}
+
+void RfxCommandListImpl::SetViewports(const nri::Viewport* viewports, uint32_t count) {
+    RFX_ASSERT(count <= RFX_MAX_STREAM_VIEWPORTS);
+    if (shadow.viewportNum == count && SameViewports(shadow.viewports, viewports, count)) {
+        elidedCalls++;
+        return;
+    }
+    memcpy(shadow.viewports, viewports, sizeof(nri::Viewport) * count);
+    shadow.viewportNum = count;
+
+    if (deferred) {
+        uint8_t count8 = (uint8_t)count;
+        stream.Push(RfxStreamOp::SET_VIEWPORTS, count8);
+        stream.Write(viewports, sizeof(nri::Viewport) * count);
+    } else {
+        CORE.NRI.CmdSetViewports(*nriCmd, viewports, count);
+    }
+}
+
+void RfxCommandListImpl::SetScissor(const nri::Rect& rect) {
+    if (shadow.scissorValid && memcmp(&shadow.scissor, &rect, sizeof(rect)) == 0) {
+        elidedCalls++;
+        return;
+    }
+    shadow.scissor = rect;
+    shadow.scissorValid = true;
+
+    if (deferred)
+        stream.Push(RfxStreamOp::SET_SCISSOR, rect);
+    else
+        CORE.NRI.CmdSetScissors(*nriCmd, &rect, 1);
+}
+
+void RfxCommandListImpl::SetBlendConstants(const nri::Color32f& color) {
+    if (shadow.blendConstantsValid && memcmp(&shadow.blendConstants, &color, sizeof(color)) == 0) {
+        elidedCalls++;
+        return;
+    }
+    shadow.blendConstants = color;
+    shadow.blendConstantsValid = true;
+
+    if (deferred)
+        stream.Push(RfxStreamOp::SET_BLEND_CONSTANTS, color);
+    else
+        CORE.NRI.CmdSetBlendConstants(*nriCmd, color);
+}
+
+void RfxCommandListImpl::SetStencilReference(uint8_t front, uint8_t back) {
+    if (shadow.stencilRefValid && shadow.stencilFront == front && shadow.stencilBack == back) {
+        elidedCalls++;
+        return;
+    }
+    shadow.stencilFront = front;
+    shadow.stencilBack = back;
+    shadow.stencilRefValid = true;
+
+    if (deferred) {
+        stream.Push(RfxStreamOp::SET_STENCIL_REF, front);
+        stream.Write(&back, sizeof(back));
+    } else {
+        CORE.NRI.CmdSetStencilReference(*nriCmd, front, back);
+    }
+}
+
+void RfxCommandListImpl::SetDepthBias(const nri::DepthBiasDesc& desc) {
+    if (shadow.depthBiasValid && memcmp(&shadow.depthBias, &desc, sizeof(desc)) == 0) {
+        elidedCalls++;
+        return;
+    }
+    shadow.depthBias = desc;
+    shadow.depthBiasValid = true;
+
+    if (deferred)
+        stream.Push(RfxStreamOp::SET_DEPTH_BIAS, desc);
+    else
+        CORE.NRI.CmdSetDepthBias(*nriCmd, desc);
+}
+
+//
+// Command list
+//
+
+RfxCommandList rfxGetCommandList() {
+    uint32_t idx = CORE.FrameIndex % GetQueuedFrameNum();
+    return &CORE.QueuedFrames[idx].wrapper;
+}
+
+static void RecreateSwapChain(int w, int h) {
+    CORE.NRI.QueueWaitIdle(CORE.NRIGraphicsQueue);
+    for (auto& s : CORE.SwapChainTextures) {
+        CORE.NRI.DestroyFence(s.acquireSemaphore);
+        CORE.NRI.DestroyFence(s.releaseSemaphore);
+        CORE.NRI.DestroyDescriptor(s.colorAttachment);
+    }
+    CORE.SwapChainTextures.clear();
+    if (CORE.NRISwapChain)
+        CORE.NRI.DestroySwapChain(CORE.NRISwapChain);
+
+    nri::SwapChainDesc scd = {};
+    scd.window = CORE.NRIWindow;
+    scd.queue = CORE.NRIGraphicsQueue;
+    scd.format = nri::SwapChainFormat::BT709_G22_8BIT;
+    scd.flags = (CORE.VsyncEnable ? nri::SwapChainBits::VSYNC : nri::SwapChainBits::NONE) | nri::SwapChainBits::ALLOW_TEARING;
+    if (CORE.AllowLowLatency)
+        scd.flags |= nri::SwapChainBits::ALLOW_LOW_LATENCY;
+    scd.width = (uint16_t)w;
+    scd.height = (uint16_t)h;
+    scd.textureNum = std::max<uint8_t>(GetQueuedFrameNum(), 2);
+    scd.queuedFrameNum = GetQueuedFrameNum();
+
+    if (CORE.NRI.CreateSwapChain(*CORE.NRIDevice, scd, CORE.NRISwapChain) != nri::Result::SUCCESS) {
+        CORE.NRISwapChain = nullptr;
+        return;
+    }
+
+    if (CORE.AllowLowLatency && CORE.LowLatencyEnabled) {
         nri::LatencySleepMode mode = {};
         mode.lowLatencyMode = true;
         mode.lowLatencyBoost = CORE.LowLatencyBoost;
@@ -1233,11 +1860,29 @@ static void RecreateSwapChain(int w, int h) {
 // Commands
 //
 
+// queues what draws inside the coming pass need, flushed together with the attachment barriers
+static void RequirePassResources(RfxCommandList cmd, const RfxPassResource* resources, uint32_t resourceCount) {
+    for (uint32_t i = 0; i < resourceCount; ++i) {
+        if (resources[i].texture)
+            cmd->barriers.RequireState(resources[i].texture, resources[i].state);
+        else
+            cmd->barriers.RequireState(resources[i].buffer, resources[i].state);
+    }
+}
+
 void rfxCmdBeginRenderPass(
     RfxCommandList cmd, RfxTexture* colors, uint32_t colorCount, RfxTexture depth, RfxColor clearColor, uint32_t viewMask
+) {
+    rfxCmdBeginRenderPassEx(cmd, colors, colorCount, depth, clearColor, viewMask, nullptr, 0);
+}
+
+void rfxCmdBeginRenderPassEx(
+    RfxCommandList cmd, RfxTexture* colors, uint32_t colorCount, RfxTexture depth, RfxColor clearColor, uint32_t viewMask,
+    const RfxPassResource* resources, uint32_t resourceCount
 ) {
     if (cmd->isRendering)
         rfxCmdEndRenderPass(cmd);
+    RequirePassResources(cmd, resources, resourceCount);
 
     uint32_t width = 0;
     uint32_t height = 0;
@@ -1288,25 +1933,31 @@ void rfxCmdBeginRenderPass(
         }
     }
 
-    cmd->barriers.Flush(*cmd->nriCmd);
-    CORE.NRI.CmdBeginRendering(*cmd->nriCmd, cmd->currentRenderingDesc);
-    cmd->isRendering = true;
+    cmd->BeginRendering();
+    cmd->shadow.InvalidateDynamic();
 
     nri::Viewport vp = { 0.0f, 0.0f, (float)width, (float)height, 0.0f, 1.0f, false };
     cmd->currentViewport = vp;
-    CORE.NRI.CmdSetViewports(*cmd->nriCmd, &vp, 1);
+    cmd->SetViewports(&vp, 1);
 
     nri::Rect r = { 0, 0, (nri::Dim_t)width, (nri::Dim_t)height };
-    CORE.NRI.CmdSetScissors(*cmd->nriCmd, &r, 1);
+    cmd->SetScissor(r);
     cmd->scissorSet = false;
 }
 
 void rfxCmdBeginSwapchainRenderPass(RfxCommandList cmd, RfxFormat depthStencilFormat, RfxColor clearColor) {
-    if (!CORE.NRISwapChain)
+    rfxCmdBeginSwapchainRenderPassEx(cmd, depthStencilFormat, clearColor, nullptr, 0);
+}
+
+void rfxCmdBeginSwapchainRenderPassEx(
+    RfxCommandList cmd, RfxFormat depthStencilFormat, RfxColor clearColor, const RfxPassResource* resources, uint32_t resourceCount
+) {
+    if (!CORE.NRISwapChain && !CORE.Headless)
         return;
 
     if (cmd->isRendering)
         rfxCmdEndRenderPass(cmd);
+    RequirePassResources(cmd, resources, resourceCount);
 
     uint32_t width = CORE.SwapChainWidth;
     uint32_t height = CORE.SwapChainHeight;
@@ -1364,8 +2015,6 @@ void rfxCmdBeginSwapchainRenderPass(RfxCommandList cmd, RfxFormat depthStencilFo
         colorTarget = nullptr;
     }
 
-    cmd->FlushBarriers();
-
     cmd->activeColorAttachments.clear();
     nri::AttachmentDesc& colorDesc = cmd->activeColorAttachments.emplace_back();
 
@@ -1399,14 +2048,14 @@ void rfxCmdBeginSwapchainRenderPass(RfxCommandList cmd, RfxFormat depthStencilFo
         }
     }
 
-    CORE.NRI.CmdBeginRendering(*cmd->nriCmd, cmd->currentRenderingDesc);
-    cmd->isRendering = true;
+    cmd->BeginRendering();
+    cmd->shadow.InvalidateDynamic();
 
     nri::Viewport vp = { 0.0f, 0.0f, (float)width, (float)height, 0.0f, 1.0f, false };
     cmd->currentViewport = vp;
-    CORE.NRI.CmdSetViewports(*cmd->nriCmd, &vp, 1);
+    cmd->SetViewports(&vp, 1);
     nri::Rect r = { 0, 0, (nri::Dim_t)width, (nri::Dim_t)height };
-    CORE.NRI.CmdSetScissors(*cmd->nriCmd, &r, 1);
+    cmd->SetScissor(r);
     cmd->scissorSet = false;
 }
 
@@ -1414,10 +2063,10 @@ void rfxCmdEndRenderPass(RfxCommandList cmd) {
     if (!cmd->isRendering)
         return;
 
-    CORE.NRI.CmdEndRendering(*cmd->nriCmd);
+    CORE.NRI.CmdEndRendering(cmd->Direct());
     cmd->isRendering = false;
 
-    cmd->barriers.Flush(*cmd->nriCmd);
+    cmd->barriers.Flush(cmd->Direct());
 
     // cleanup
     cmd->activeColorTextures.clear();
@@ -1453,69 +2102,83 @@ void rfxCmdClear(RfxCommandList cmd, RfxColor color) {
     nri::Rect rect = { (int16_t)cmd->currentViewport.x, (int16_t)cmd->currentViewport.y, (nri::Dim_t)cmd->currentViewport.width,
                        (nri::Dim_t)cmd->currentViewport.height };
 
-    CORE.NRI.CmdClearAttachments(*cmd->nriCmd, clears.data(), (uint32_t)clears.size(), &rect, 1);
+    CORE.NRI.CmdClearAttachments(cmd->Direct(), clears.data(), (uint32_t)clears.size(), &rect, 1);
 }
 
 void rfxCmdBindPipeline(RfxCommandList cmd, RfxPipeline pipeline) {
     cmd->currentPipeline = (RfxPipelineImpl*)pipeline;
-    CORE.NRI.CmdSetPipelineLayout(*cmd->nriCmd, pipeline->bindPoint, *cmd->currentPipeline->shader->pipelineLayout);
-    CORE.NRI.CmdSetPipeline(*cmd->nriCmd, *cmd->currentPipeline->pipeline);
-
-    nri::SetDescriptorSetDesc bindlessSet = {};
-    bindlessSet.setIndex = cmd->currentPipeline->shader->bindlessSetIndex;
-    bindlessSet.descriptorSet = CORE.Bindless.globalDescriptorSet;
-    bindlessSet.bindPoint = pipeline->bindPoint;
-    CORE.NRI.CmdSetDescriptorSet(*cmd->nriCmd, bindlessSet);
+    cmd->SetPipeline(cmd->currentPipeline);
 }
 
 void rfxCmdSetScissor(RfxCommandList cmd, int x, int y, int width, int height) {
     cmd->currentScissor = { (int16_t)x, (int16_t)y, (nri::Dim_t)width, (nri::Dim_t)height };
     cmd->scissorSet = true;
     if (cmd->isRendering)
-        CORE.NRI.CmdSetScissors(*cmd->nriCmd, &cmd->currentScissor, 1);
+        cmd->SetScissor(cmd->currentScissor);
 }
 
 void rfxCmdSetBlendConstants(RfxCommandList cmd, RfxColor color) {
     nri::Color32f c = { color.r, color.g, color.b, color.a };
-    CORE.NRI.CmdSetBlendConstants(*cmd->nriCmd, c);
+    cmd->SetBlendConstants(c);
 }
 
 void rfxCmdBindVertexBuffer(RfxCommandList cmd, RfxBuffer buffer) {
+    rfxCmdBindVertexBufferEx(cmd, buffer, 0);
+}
+
+void rfxCmdBindVertexBufferEx(RfxCommandList cmd, RfxBuffer buffer, size_t offset) {
     cmd->currentVertexBuffer = buffer;
+    cmd->currentVertexOffset = offset;
 }
 
 void rfxCmdBindIndexBuffer(RfxCommandList cmd, RfxBuffer buffer, RfxIndexType indexType) {
+    rfxCmdBindIndexBufferEx(cmd, buffer, 0, indexType);
+}
+
+void rfxCmdBindIndexBufferEx(RfxCommandList cmd, RfxBuffer buffer, size_t offset, RfxIndexType indexType) {
     cmd->currentIndexBuffer = buffer;
+    cmd->currentIndexOffset = offset;
     cmd->currentIndexType = (indexType == RFX_INDEX_UINT32) ? nri::IndexType::UINT32 : nri::IndexType::UINT16;
 }
 
 void rfxCmdPushConstants(RfxCommandList cmd, const void* data, size_t size) {
     if (!cmd->currentPipeline)
         return;
-    nri::SetRootConstantsDesc desc = {};
-    desc.rootConstantIndex = 0;
-    desc.data = data;
-    desc.size = (uint32_t)size;
-    desc.bindPoint = cmd->currentPipeline->bindPoint;
-    CORE.NRI.CmdSetRootConstants(*cmd->nriCmd, desc);
+    cmd->SetRootConstants(cmd->currentPipeline->bindPoint, data, (uint32_t)size);
 }
 
 void rfxCmdDraw(RfxCommandList cmd, uint32_t vc, uint32_t ic) {
+    rfxCmdDrawEx(cmd, vc, ic, 0, 0);
+}
+
+void rfxCmdDrawEx(RfxCommandList cmd, uint32_t vc, uint32_t ic, uint32_t firstVertex, uint32_t firstInstance) {
     cmd->PrepareForDraw();
     cmd->FlushBarriers();
     cmd->BindDrawBuffers();
 
-    nri::DrawDesc d = { vc, ic, 0, 0 };
-    CORE.NRI.CmdDraw(*cmd->nriCmd, d);
+    nri::DrawDesc d = { vc, ic, firstVertex, firstInstance };
+    if (cmd->deferred)
+        cmd->stream.Push(RfxStreamOp::DRAW, d);
+    else
+        CORE.NRI.CmdDraw(*cmd->nriCmd, d);
 }
 
 void rfxCmdDrawIndexed(RfxCommandList cmd, uint32_t ic, uint32_t instanceCount) {
+    rfxCmdDrawIndexedEx(cmd, ic, instanceCount, 0, 0, 0);
+}
+
+void rfxCmdDrawIndexedEx(
+    RfxCommandList cmd, uint32_t ic, uint32_t instanceCount, uint32_t firstIndex, int32_t baseVertex, uint32_t firstInstance
+) {
     cmd->PrepareForDraw();
     cmd->FlushBarriers();
     cmd->BindDrawBuffers();
 
-    nri::DrawIndexedDesc d = { ic, instanceCount, 0, 0, 0 };
-    CORE.NRI.CmdDrawIndexed(*cmd->nriCmd, d);
+    nri::DrawIndexedDesc d = { ic, instanceCount, firstIndex, baseVertex, firstInstance };
+    if (cmd->deferred)
+        cmd->stream.Push(RfxStreamOp::DRAW_INDEXED, d);
+    else
+        CORE.NRI.CmdDrawIndexed(*cmd->nriCmd, d);
 }
 
 void rfxCmdDispatch(RfxCommandList cmd, uint32_t x, uint32_t y, uint32_t z) {
@@ -1523,7 +2186,10 @@ void rfxCmdDispatch(RfxCommandList cmd, uint32_t x, uint32_t y, uint32_t z) {
     cmd->FlushBarriers();
 
     nri::DispatchDesc d = { x, y, z };
-    CORE.NRI.CmdDispatch(*cmd->nriCmd, d);
+    if (cmd->deferred)
+        cmd->stream.Push(RfxStreamOp::DISPATCH, d);
+    else
+        CORE.NRI.CmdDispatch(*cmd->nriCmd, d);
 }
 
 void rfxCmdDrawIndirect(RfxCommandList cmd, RfxBuffer buffer, size_t offset, uint32_t drawCount, uint32_t stride) {
@@ -1532,7 +2198,7 @@ void rfxCmdDrawIndirect(RfxCommandList cmd, RfxBuffer buffer, size_t offset, uin
     cmd->FlushBarriers();
     cmd->BindDrawBuffers();
 
-    CORE.NRI.CmdDrawIndirect(*cmd->nriCmd, *buffer->buffer, offset, drawCount, stride, nullptr, 0);
+    CORE.NRI.CmdDrawIndirect(cmd->Direct(), *buffer->buffer, offset, drawCount, stride, nullptr, 0);
 }
 
 void rfxCmdDrawIndexedIndirect(RfxCommandList cmd, RfxBuffer buffer, size_t offset, uint32_t drawCount, uint32_t stride) {
@@ -1541,7 +2207,7 @@ void rfxCmdDrawIndexedIndirect(RfxCommandList cmd, RfxBuffer buffer, size_t offs
     cmd->FlushBarriers();
     cmd->BindDrawBuffers();
 
-    CORE.NRI.CmdDrawIndexedIndirect(*cmd->nriCmd, *buffer->buffer, offset, drawCount, stride, nullptr, 0);
+    CORE.NRI.CmdDrawIndexedIndirect(cmd->Direct(), *buffer->buffer, offset, drawCount, stride, nullptr, 0);
 }
 
 void rfxCmdDispatchIndirect(RfxCommandList cmd, RfxBuffer buffer, size_t offset) {
@@ -1549,21 +2215,24 @@ void rfxCmdDispatchIndirect(RfxCommandList cmd, RfxBuffer buffer, size_t offset)
     rfxCmdTransitionBuffer(cmd, buffer, RFX_STATE_INDIRECT_ARGUMENT);
     cmd->FlushBarriers();
 
-    CORE.NRI.CmdDispatchIndirect(*cmd->nriCmd, *buffer->buffer, offset);
+    CORE.NRI.CmdDispatchIndirect(cmd->Direct(), *buffer->buffer, offset);
 }
 
 void rfxCmdDrawMeshTasks(RfxCommandList cmd, uint32_t x, uint32_t y, uint32_t z) {
     cmd->FlushBarriers();
 
     nri::DrawMeshTasksDesc d = { x, y, z };
-    CORE.NRI.CmdDrawMeshTasks(*cmd->nriCmd, d);
+    if (cmd->deferred)
+        cmd->stream.Push(RfxStreamOp::DRAW_MESH_TASKS, d);
+    else
+        CORE.NRI.CmdDrawMeshTasks(*cmd->nriCmd, d);
 }
 
 void rfxCmdDrawMeshTasksIndirect(RfxCommandList cmd, RfxBuffer buffer, size_t offset, uint32_t drawCount, uint32_t stride) {
     rfxCmdTransitionBuffer(cmd, buffer, RFX_STATE_INDIRECT_ARGUMENT);
     cmd->FlushBarriers();
 
-    CORE.NRI.CmdDrawMeshTasksIndirect(*cmd->nriCmd, *buffer->buffer, offset, drawCount, stride, nullptr, 0);
+    CORE.NRI.CmdDrawMeshTasksIndirect(cmd->Direct(), *buffer->buffer, offset, drawCount, stride, nullptr, 0);
 }
 
 void rfxCmdDrawIndirectCount(
@@ -1576,7 +2245,7 @@ void rfxCmdDrawIndirectCount(
     cmd->FlushBarriers();
     cmd->BindDrawBuffers();
 
-    CORE.NRI.CmdDrawIndirect(*cmd->nriCmd, *buffer->buffer, offset, maxDrawCount, stride, countBuffer->buffer, countBufferOffset);
+    CORE.NRI.CmdDrawIndirect(cmd->Direct(), *buffer->buffer, offset, maxDrawCount, stride, countBuffer->buffer, countBufferOffset);
 }
 
 void rfxCmdDrawIndexedIndirectCount(
@@ -1589,7 +2258,7 @@ void rfxCmdDrawIndexedIndirectCount(
     cmd->FlushBarriers();
     cmd->BindDrawBuffers();
 
-    CORE.NRI.CmdDrawIndexedIndirect(*cmd->nriCmd, *buffer->buffer, offset, maxDrawCount, stride, countBuffer->buffer, countBufferOffset);
+    CORE.NRI.CmdDrawIndexedIndirect(cmd->Direct(), *buffer->buffer, offset, maxDrawCount, stride, countBuffer->buffer, countBufferOffset);
 }
 
 void rfxCmdDrawMeshTasksIndirectCount(
@@ -1600,7 +2269,7 @@ void rfxCmdDrawMeshTasksIndirectCount(
     rfxCmdTransitionBuffer(cmd, countBuffer, RFX_STATE_INDIRECT_ARGUMENT);
     cmd->FlushBarriers();
 
-    CORE.NRI.CmdDrawMeshTasksIndirect(*cmd->nriCmd, *buffer->buffer, offset, maxDrawCount, stride, countBuffer->buffer, countBufferOffset);
+    CORE.NRI.CmdDrawMeshTasksIndirect(cmd->Direct(), *buffer->buffer, offset, maxDrawCount, stride, countBuffer->buffer, countBufferOffset);
 }
 
 void rfxCmdCopyBuffer(RfxCommandList cmd, RfxBuffer src, size_t srcOffset, RfxBuffer dst, size_t dstOffset, size_t size) {
@@ -1608,7 +2277,7 @@ void rfxCmdCopyBuffer(RfxCommandList cmd, RfxBuffer src, size_t srcOffset, RfxBu
     rfxCmdTransitionBuffer(cmd, src, RFX_STATE_COPY_SRC);
     rfxCmdTransitionBuffer(cmd, dst, RFX_STATE_COPY_DST);
     cmd->FlushBarriers();
-    CORE.NRI.CmdCopyBuffer(*cmd->nriCmd, *dst->buffer, dstOffset, *src->buffer, srcOffset, size);
+    CORE.NRI.CmdCopyBuffer(cmd->Direct(), *dst->buffer, dstOffset, *src->buffer, srcOffset, size);
 }
 
 void rfxCmdCopyTexture(RfxCommandList cmd, RfxTexture src, RfxTexture dst) {
@@ -1616,110 +2285,432 @@ void rfxCmdCopyTexture(RfxCommandList cmd, RfxTexture src, RfxTexture dst) {
     rfxCmdTransitionTexture(cmd, src, RFX_STATE_COPY_SRC);
     rfxCmdTransitionTexture(cmd, dst, RFX_STATE_COPY_DST);
     cmd->FlushBarriers();
-    CORE.NRI.CmdCopyTexture(*cmd->nriCmd, *dst->texture, nullptr, *src->texture, nullptr);
+    CORE.NRI.CmdCopyTexture(cmd->Direct(), *dst->texture, nullptr, *src->texture, nullptr);
 }
 
 //
-// Resource creation
+// Render queue
 //
 
-template <typename T, typename BindDesc, typename GetDescFunc, typename BindFunc>
-static void AllocateAndBind(T* resource, nri::MemoryLocation loc, nri::Memory*& outMemory, GetDescFunc getDesc, BindFunc bind) {
-    nri::MemoryDesc memReq = {};
-    getDesc(*resource, loc, memReq);
+// 16-bit fold of a pointer, equal pointers end up next to each other after sorting
+static uint64_t FoldPointer16(const void* ptr) {
+    uint64_t v = (uint64_t)(uintptr_t)ptr >> 4;
+    v ^= v >> 16;
+    v ^= v >> 32;
+    return v & 0xFFFF;
+}
 
-    nri::AllocateMemoryDesc allocDesc = {};
-    allocDesc.size = memReq.size;
-    allocDesc.type = memReq.type;
-    allocDesc.priority = 0.0f;
-    allocDesc.vma = { true, 0 };
+// non-negative floats order like their bit patterns, keep the top `bits` of the 31 that matter
+static uint64_t QuantizeDepth(float depth, uint32_t bits) {
+    if (!(depth > 0.0f))
+        return 0;
+    uint32_t u;
+    memcpy(&u, &depth, sizeof(u));
+    return u >> (31 - bits);
+}
 
-    // TODO: not sure if this correct for anything but d3d12
-    if (memReq.alignment > 65536) {
-        allocDesc.allowMultisampleTextures = true;
-    }
+// | layer:4 | pipeline:16 | buffers:16 | depth:28 |   front to back
+// | layer:4 | ~depth:24 | pipeline:16 | buffers:16 | 0:4 |   back to front
+static uint64_t MakeSortKey(const RfxDrawPacket* p) {
+    uint64_t layer = (uint64_t)(p->layer & 0xF) << 60;
+    uint64_t pipeline = FoldPointer16(p->pipeline);
+    uint64_t buffers = FoldPointer16((const void*)((uintptr_t)p->vertexBuffer ^ ((uintptr_t)p->indexBuffer * 31)));
 
-    NRI_CHECK(CORE.NRI.AllocateMemory(*CORE.NRIDevice, allocDesc, outMemory));
+    if (p->backToFront)
+        return layer | ((0xFFFFFFull - QuantizeDepth(p->depth, 24)) << 36) | (pipeline << 20) | (buffers << 4);
+    return layer | (pipeline << 44) | (buffers << 28) | QuantizeDepth(p->depth, 28);
+}
 
-    BindDesc bindDesc = {};
-    bindDesc.memory = outMemory;
-    bindDesc.offset = 0;
-    if constexpr (std::is_same_v<T, nri::Buffer>) {
-        bindDesc.buffer = resource;
-    } else if constexpr (std::is_same_v<T, nri::Texture>) {
-        bindDesc.texture = resource;
-    } else if constexpr (std::is_same_v<T, nri::AccelerationStructure>) {
-        bindDesc.accelerationStructure = resource;
-    } else if constexpr (std::is_same_v<T, nri::Micromap>) {
-        bindDesc.micromap = resource;
+// stable LSD radix sort, 8 bits per pass. Passes where every key has the same byte are skipped
+static void RadixSortKeys(RfxRenderQueueImpl* q) {
+    size_t n = q->keys.size();
+    if (n < 2)
+        return;
+
+    q->keysTmp.resize(n);
+    q->orderTmp.resize(n);
+
+    uint32_t counts[8][256] = {};
+    for (uint64_t key : q->keys) {
+        for (uint32_t pass = 0; pass < 8; ++pass)
+            counts[pass][(key >> (pass * 8)) & 0xFF]++;
     }
 
-    NRI_CHECK(bind(&bindDesc, 1));
-}
+    for (uint32_t pass = 0; pass < 8; ++pass) {
+        uint32_t shift = pass * 8;
+        uint32_t* c = counts[pass];
+        if (c[(q->keys[0] >> shift) & 0xFF] == n)
+            continue;
 
-RfxBuffer rfxCreateBuffer(size_t size, size_t stride, RfxBufferUsageFlags usage, RfxMemoryType memType, const void* initialData) {
-    RfxBufferImpl* impl = RfxNew<RfxBufferImpl>(nullptr, nullptr, nullptr, nullptr, (uint64_t)size, (uint32_t)stride, 0);
-    impl->bindlessIndex = AllocBufferSlot();
+        uint32_t sum = 0;
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t count = c[i];
+            c[i] = sum;
+            sum += count;
+        }
 
-    nri::BufferDesc bd = {};
-    bd.size = size;
-    bd.structureStride = 4; // allows "typed", "byte address (raw)" and "structured" views
-    bd.usage = nri::BufferUsageBits::SHADER_RESOURCE;
+        for (size_t i = 0; i < n; ++i) {
+            uint32_t dst = c[(q->keys[i] >> shift) & 0xFF]++;
+            q->keysTmp[dst] = q->keys[i];
+            q->orderTmp[dst] = q->order[i];
+        }
 
-    if (usage & RFX_USAGE_VERTEX_BUFFER)
-        bd.usage |= nri::BufferUsageBits::VERTEX_BUFFER;
-    if (usage & RFX_USAGE_INDEX_BUFFER)
-        bd.usage |= nri::BufferUsageBits::INDEX_BUFFER;
-    if (usage & RFX_USAGE_CONSTANT_BUFFER)
-        bd.usage |= nri::BufferUsageBits::CONSTANT_BUFFER;
-    if (usage & RFX_USAGE_ARGUMENT_BUFFER)
-        bd.usage |= nri::BufferUsageBits::ARGUMENT_BUFFER;
-    if (usage & RFX_USAGE_SCRATCH_BUFFER)
-        bd.usage |= nri::BufferUsageBits::SCRATCH_BUFFER;
-    if (usage & RFX_USAGE_SHADER_BINDING_TABLE)
-        bd.usage |= nri::BufferUsageBits::SHADER_BINDING_TABLE;
-    if (usage & RFX_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT)
-        bd.usage |= nri::BufferUsageBits::ACCELERATION_STRUCTURE_BUILD_INPUT;
-    if (usage & RFX_USAGE_TRANSFER_SRC)
-        bd.usage |= nri::BufferUsageBits::SHADER_RESOURCE;
-    if (usage & RFX_USAGE_SHADER_RESOURCE_STORAGE)
-        bd.usage |= nri::BufferUsageBits::SHADER_RESOURCE_STORAGE;
-    if (usage & RFX_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT) {
-        bd.usage |= nri::BufferUsageBits::ACCELERATION_STRUCTURE_BUILD_INPUT;
-        bd.usage |= nri::BufferUsageBits::SHADER_RESOURCE;
+        q->keys.swap(q->keysTmp);
+        q->order.swap(q->orderTmp);
     }
+}
 
-    NRI_CHECK(CORE.NRI.CreateBuffer(*CORE.NRIDevice, bd, impl->buffer));
+RfxRenderQueue rfxCreateRenderQueue() {
+    return RfxNew<RfxRenderQueueImpl>();
+}
 
-    nri::MemoryLocation loc = (memType == RFX_MEM_CPU_TO_GPU)
-                                  ? nri::MemoryLocation::HOST_UPLOAD
-                                  : (memType == RFX_MEM_GPU_TO_CPU ? nri::MemoryLocation::HOST_READBACK : nri::MemoryLocation::DEVICE);
+void rfxDestroyRenderQueue(RfxRenderQueue queue) {
+    if (queue)
+        RfxDelete(queue);
+}
 
-    AllocateAndBind<nri::Buffer, nri::BindBufferMemoryDesc>(
-        impl->buffer, loc, impl->memory,
-        [&](nri::Buffer& b, nri::MemoryLocation l, nri::MemoryDesc& d) { CORE.NRI.GetBufferMemoryDesc(b, l, d); },
-        [&](const nri::BindBufferMemoryDesc* d, uint32_t n) { return CORE.NRI.BindBufferMemory(d, n); }
-    );
+void rfxResetRenderQueue(RfxRenderQueue queue) {
+    if (!queue)
+        return;
+    queue->packets.clear();
+    queue->pushData.clear();
+    queue->keys.clear();
+    queue->order.clear();
+}
 
-    if (usage & RFX_USAGE_SHADER_RESOURCE_STORAGE) {
-        nri::BufferViewDesc uavDesc = {};
-        uavDesc.buffer = impl->buffer;
-        uavDesc.viewType = nri::BufferViewType::SHADER_RESOURCE_STORAGE;
-        uavDesc.format = nri::Format::UNKNOWN;
-        uavDesc.size = size;
-        uavDesc.structureStride = 0;
-        NRI_CHECK(CORE.NRI.CreateBufferView(uavDesc, impl->descriptorUAV));
-        UpdateBindlessDescriptor(3, impl->bindlessIndex, impl->descriptorUAV);
+void rfxAddDrawPacket(RfxRenderQueue queue, const RfxDrawPacket* packet) {
+    if (!queue || !packet || !packet->pipeline)
+        return;
+
+    RfxRenderQueueImpl::Packet& p = queue->packets.emplace_back();
+    p.pipeline = packet->pipeline;
+    p.vertexBuffer = packet->vertexBuffer;
+    p.indexBuffer = packet->indexBuffer;
+    p.indexType = packet->indexType;
+    p.vertexOffset = packet->vertexOffset;
+    p.indexOffset = packet->indexOffset;
+    p.count = packet->count;
+    p.instanceCount = packet->instanceCount ? packet->instanceCount : 1;
+    p.first = packet->first;
+    p.baseVertex = packet->baseVertex;
+    p.firstInstance = packet->firstInstance;
+    p.pushOffset = (uint32_t)queue->pushData.size();
+    p.pushSize = packet->pushConstants ? packet->pushConstantsSize : 0;
+
+    if (p.pushSize > 0) {
+        const uint8_t* bytes = (const uint8_t*)packet->pushConstants;
+        queue->pushData.insert(queue->pushData.end(), bytes, bytes + p.pushSize);
     }
 
-    nri::BufferViewDesc vd = {};
-    vd.buffer = impl->buffer;
+    queue->keys.push_back(MakeSortKey(packet));
+    queue->order.push_back((uint32_t)queue->packets.size() - 1);
+}
+
+void rfxCmdDrawRenderQueue(RfxCommandList cmd, RfxRenderQueue queue) {
+    if (!queue || queue->packets.empty())
+        return;
+
+    RadixSortKeys(queue);
+
+    RfxPipeline lastPipeline = nullptr;
+    for (uint32_t idx : queue->order) {
+        const RfxRenderQueueImpl::Packet& p = queue->packets[idx];
+
+        if (p.pipeline != lastPipeline) {
+            rfxCmdBindPipeline(cmd, p.pipeline);
+            lastPipeline = p.pipeline;
+        }
+
+        // buffer binds only update the pending state, BindDrawBuffers drops the unchanged ones
+        rfxCmdBindVertexBufferEx(cmd, p.vertexBuffer, p.vertexOffset);
+        if (p.indexBuffer)
+            rfxCmdBindIndexBufferEx(cmd, p.indexBuffer, p.indexOffset, p.indexType);
+        if (p.pushSize > 0)
+            rfxCmdPushConstants(cmd, queue->pushData.data() + p.pushOffset, p.pushSize);
+
+        if (p.indexBuffer)
+            rfxCmdDrawIndexedEx(cmd, p.count, p.instanceCount, p.first, p.baseVertex, p.firstInstance);
+        else
+            rfxCmdDrawEx(cmd, p.count, p.instanceCount, p.first, p.firstInstance);
+    }
+}
+
+//
+// Geometry pool
+//
+
+RfxGeometryPool rfxCreateGeometryPool(const RfxGeometryPoolDesc* desc) {
+    RFX_ASSERT(desc && desc->vertexStride > 0 && desc->vertexCapacity > 0 && desc->maxMeshes > 0);
+
+    RfxGeometryPoolImpl* impl = RfxNew<RfxGeometryPoolImpl>();
+    impl->vertexStride = desc->vertexStride;
+    impl->indexType = desc->indexType;
+    impl->indexSize = desc->indexType == RFX_INDEX_UINT32 ? 4 : 2;
+
+    impl->vertexBuffer = rfxCreateBuffer(
+        (size_t)desc->vertexCapacity * desc->vertexStride, desc->vertexStride,
+        RFX_USAGE_VERTEX_BUFFER | RFX_USAGE_SHADER_RESOURCE | RFX_USAGE_TRANSFER_DST, RFX_MEM_GPU_ONLY, nullptr
+    );
+    if (desc->indexCapacity > 0) {
+        impl->indexBuffer = rfxCreateBuffer(
+            (size_t)desc->indexCapacity * impl->indexSize, impl->indexSize,
+            RFX_USAGE_INDEX_BUFFER | RFX_USAGE_SHADER_RESOURCE | RFX_USAGE_TRANSFER_DST, RFX_MEM_GPU_ONLY, nullptr
+        );
+    }
+    impl->meshTable = rfxCreateBuffer(
+        (size_t)desc->maxMeshes * sizeof(RfxMeshRecord), sizeof(RfxMeshRecord), RFX_USAGE_SHADER_RESOURCE | RFX_USAGE_TRANSFER_DST,
+        RFX_MEM_GPU_ONLY, nullptr
+    );
+
+    impl->vertexRanges.Init(desc->vertexCapacity);
+    impl->indexRanges.Init(desc->indexCapacity);
+    impl->records.resize(desc->maxMeshes);
+    impl->live.resize(desc->maxMeshes, 0);
+
+    // hand out low indices first
+    impl->freeMeshes.reserve(desc->maxMeshes);
+    for (uint32_t i = desc->maxMeshes; i > 0; --i)
+        impl->freeMeshes.push_back(i - 1);
+
+    return impl;
+}
+
+void rfxDestroyGeometryPool(RfxGeometryPool pool) {
+    if (!pool)
+        return;
+    rfxDestroyBuffer(pool->vertexBuffer);
+    if (pool->indexBuffer)
+        rfxDestroyBuffer(pool->indexBuffer);
+    rfxDestroyBuffer(pool->meshTable);
+
+    // after any rfxFreeMesh still waiting in the graveyard
+    rfxDeferDestruction([=]() { RfxDelete(pool); });
+}
+
+uint32_t rfxAllocMesh(RfxGeometryPool pool, const RfxMeshDesc* desc) {
+    if (!pool || !desc || !desc->vertices || desc->vertexCount == 0)
+        return UINT32_MAX;
+    if (desc->indexCount > 0 && (!desc->indices || !pool->indexBuffer))
+        return UINT32_MAX;
+
+    RfxMeshRecord record = {};
+    uint32_t mesh;
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        if (pool->freeMeshes.empty())
+            return UINT32_MAX;
+
+        record.vertexOffset = pool->vertexRanges.Alloc(desc->vertexCount);
+        if (record.vertexOffset == RfxRangeAllocator::INVALID)
+            return UINT32_MAX;
+
+        if (desc->indexCount > 0) {
+            record.indexOffset = pool->indexRanges.Alloc(desc->indexCount);
+            if (record.indexOffset == RfxRangeAllocator::INVALID) {
+                pool->vertexRanges.Free(record.vertexOffset, desc->vertexCount);
+                return UINT32_MAX;
+            }
+        }
+
+        record.vertexCount = desc->vertexCount;
+        record.indexCount = desc->indexCount;
+        memcpy(record.boundsCenter, desc->boundsCenter, sizeof(record.boundsCenter));
+        record.boundsRadius = desc->boundsRadius;
+
+        mesh = pool->freeMeshes.back();
+        pool->freeMeshes.pop_back();
+        pool->records[mesh] = record;
+        pool->live[mesh] = 1;
+    }
+
+    // the ranges are ours now, upload outside the pool lock. The copy queue waits for the frames in flight, and the first
+    // list drawing from the pool resolves copy dst into however it binds the buffers
+    rfxUploadBuffer(
+        pool->vertexBuffer, (uint64_t)record.vertexOffset * pool->vertexStride, desc->vertices,
+        (uint64_t)desc->vertexCount * pool->vertexStride
+    );
+    if (desc->indexCount > 0) {
+        rfxUploadBuffer(
+            pool->indexBuffer, (uint64_t)record.indexOffset * pool->indexSize, desc->indices, (uint64_t)desc->indexCount * pool->indexSize
+        );
+    }
+    rfxUploadBuffer(pool->meshTable, (uint64_t)mesh * sizeof(RfxMeshRecord), &record, sizeof(RfxMeshRecord));
+
+    return mesh;
+}
+
+void rfxFreeMesh(RfxGeometryPool pool, uint32_t mesh) {
+    if (!pool)
+        return;
+
+    RfxMeshRecord record;
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        if (mesh >= pool->records.size() || !pool->live[mesh])
+            return;
+        pool->live[mesh] = 0;
+        record = pool->records[mesh];
+    }
+
+    // frames in flight may still draw from these ranges
+    rfxDeferDestruction([=]() {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        pool->vertexRanges.Free(record.vertexOffset, record.vertexCount);
+        pool->indexRanges.Free(record.indexOffset, record.indexCount);
+        pool->freeMeshes.push_back(mesh);
+    });
+}
+
+RfxMeshRecord rfxGetMeshRecord(RfxGeometryPool pool, uint32_t mesh) {
+    if (!pool)
+        return {};
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    if (mesh >= pool->records.size() || !pool->live[mesh])
+        return {};
+    return pool->records[mesh];
+}
+
+RfxBuffer rfxGetGeometryPoolVertexBuffer(RfxGeometryPool pool) {
+    return pool ? pool->vertexBuffer : nullptr;
+}
+
+RfxBuffer rfxGetGeometryPoolIndexBuffer(RfxGeometryPool pool) {
+    return pool ? pool->indexBuffer : nullptr;
+}
+
+RfxBuffer rfxGetGeometryPoolMeshTable(RfxGeometryPool pool) {
+    return pool ? pool->meshTable : nullptr;
+}
+
+void rfxCmdDrawMesh(RfxCommandList cmd, RfxGeometryPool pool, uint32_t mesh, uint32_t instanceCount) {
+    RfxMeshRecord r = rfxGetMeshRecord(pool, mesh);
+    if (r.vertexCount == 0)
+        return;
+
+    rfxCmdBindVertexBuffer(cmd, pool->vertexBuffer);
+    if (r.indexCount > 0) {
+        rfxCmdBindIndexBuffer(cmd, pool->indexBuffer, pool->indexType);
+        rfxCmdDrawIndexedEx(cmd, r.indexCount, instanceCount, r.indexOffset, (int32_t)r.vertexOffset, 0);
+    } else {
+        rfxCmdDrawEx(cmd, r.vertexCount, instanceCount, r.vertexOffset, 0);
+    }
+}
+
+//
+// Resource creation
+//
+
+template <typename T, typename BindDesc, typename GetDescFunc, typename BindFunc>
+static void AllocateAndBind(T* resource, nri::MemoryLocation loc, nri::Memory*& outMemory, GetDescFunc getDesc, BindFunc bind) {
+    nri::MemoryDesc memReq = {};
+    getDesc(*resource, loc, memReq);
+
+    nri::AllocateMemoryDesc allocDesc = {};
+    allocDesc.size = memReq.size;
+    allocDesc.type = memReq.type;
+    allocDesc.priority = 0.0f;
+    allocDesc.vma = { true, 0 };
+
+    // TODO: not sure if this correct for anything but d3d12
+    if (memReq.alignment > 65536) {
+        allocDesc.allowMultisampleTextures = true;
+    }
+
+    NRI_CHECK(CORE.NRI.AllocateMemory(*CORE.NRIDevice, allocDesc, outMemory));
+
+    BindDesc bindDesc = {};
+    bindDesc.memory = outMemory;
+    bindDesc.offset = 0;
+    if constexpr (std::is_same_v<T, nri::Buffer>) {
+        bindDesc.buffer = resource;
+    } else if constexpr (std::is_same_v<T, nri::Texture>) {
+        bindDesc.texture = resource;
+    } else if constexpr (std::is_same_v<T, nri::AccelerationStructure>) {
+        bindDesc.accelerationStructure = resource;
+    } else if constexpr (std::is_same_v<T, nri::Micromap>) {
+        bindDesc.micromap = resource;
+    }
+
+    NRI_CHECK(bind(&bindDesc, 1));
+}
+
+// creates the RfxBufferImpl and its NRI buffer, without memory or views
+static RfxBufferImpl* CreateBufferObject(size_t size, size_t stride, RfxBufferUsageFlags usage) {
+    RfxBufferImpl* impl = RfxNew<RfxBufferImpl>(nullptr, nullptr, nullptr, nullptr, (uint64_t)size, (uint32_t)stride, 0);
+    impl->bindlessIndex = AllocBufferSlot();
+
+    nri::BufferDesc bd = {};
+    bd.size = size;
+    bd.structureStride = 4; // allows "typed", "byte address (raw)" and "structured" views
+    bd.usage = nri::BufferUsageBits::SHADER_RESOURCE;
+
+    if (usage & RFX_USAGE_VERTEX_BUFFER)
+        bd.usage |= nri::BufferUsageBits::VERTEX_BUFFER;
+    if (usage & RFX_USAGE_INDEX_BUFFER)
+        bd.usage |= nri::BufferUsageBits::INDEX_BUFFER;
+    if (usage & RFX_USAGE_CONSTANT_BUFFER)
+        bd.usage |= nri::BufferUsageBits::CONSTANT_BUFFER;
+    if (usage & RFX_USAGE_ARGUMENT_BUFFER)
+        bd.usage |= nri::BufferUsageBits::ARGUMENT_BUFFER;
+    if (usage & RFX_USAGE_SCRATCH_BUFFER)
+        bd.usage |= nri::BufferUsageBits::SCRATCH_BUFFER;
+    if (usage & RFX_USAGE_SHADER_BINDING_TABLE)
+        bd.usage |= nri::BufferUsageBits::SHADER_BINDING_TABLE;
+    if (usage & RFX_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT)
+        bd.usage |= nri::BufferUsageBits::ACCELERATION_STRUCTURE_BUILD_INPUT;
+    if (usage & RFX_USAGE_TRANSFER_SRC)
+        bd.usage |= nri::BufferUsageBits::SHADER_RESOURCE;
+    if (usage & RFX_USAGE_SHADER_RESOURCE_STORAGE)
+        bd.usage |= nri::BufferUsageBits::SHADER_RESOURCE_STORAGE;
+    if (usage & RFX_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT) {
+        bd.usage |= nri::BufferUsageBits::ACCELERATION_STRUCTURE_BUILD_INPUT;
+        bd.usage |= nri::BufferUsageBits::SHADER_RESOURCE;
+    }
+
+    NRI_CHECK(CORE.NRI.CreateBuffer(*CORE.NRIDevice, bd, impl->buffer));
+    return impl;
+}
+
+// SRV (and UAV for storage buffers) in the bindless heap
+static void CreateBufferDescriptors(RfxBufferImpl* impl, RfxBufferUsageFlags usage) {
+    if (usage & RFX_USAGE_SHADER_RESOURCE_STORAGE) {
+        nri::BufferViewDesc uavDesc = {};
+        uavDesc.buffer = impl->buffer;
+        uavDesc.viewType = nri::BufferViewType::SHADER_RESOURCE_STORAGE;
+        uavDesc.format = nri::Format::UNKNOWN;
+        uavDesc.size = impl->size;
+        uavDesc.structureStride = 0;
+        NRI_CHECK(CORE.NRI.CreateBufferView(uavDesc, impl->descriptorUAV));
+        UpdateBindlessDescriptor(3, impl->bindlessIndex, impl->descriptorUAV);
+    }
+
+    nri::BufferViewDesc vd = {};
+    vd.buffer = impl->buffer;
     vd.viewType = nri::BufferViewType::SHADER_RESOURCE;
     vd.format = nri::Format::UNKNOWN;
-    vd.size = size;
+    vd.size = impl->size;
     vd.structureStride = 0;
     NRI_CHECK(CORE.NRI.CreateBufferView(vd, impl->descriptorSRV));
     UpdateBindlessDescriptor(2, impl->bindlessIndex, impl->descriptorSRV);
+}
+
+RfxBuffer rfxCreateBuffer(size_t size, size_t stride, RfxBufferUsageFlags usage, RfxMemoryType memType, const void* initialData) {
+    RfxBufferImpl* impl = CreateBufferObject(size, stride, usage);
+
+    nri::MemoryLocation loc = (memType == RFX_MEM_CPU_TO_GPU)
+                                  ? nri::MemoryLocation::HOST_UPLOAD
+                                  : (memType == RFX_MEM_GPU_TO_CPU ? nri::MemoryLocation::HOST_READBACK : nri::MemoryLocation::DEVICE);
+
+    AllocateAndBind<nri::Buffer, nri::BindBufferMemoryDesc>(
+        impl->buffer, loc, impl->memory,
+        [&](nri::Buffer& b, nri::MemoryLocation l, nri::MemoryDesc& d) { CORE.NRI.GetBufferMemoryDesc(b, l, d); },
+        [&](const nri::BindBufferMemoryDesc* d, uint32_t n) { return CORE.NRI.BindBufferMemory(d, n); }
+    );
+
+    CreateBufferDescriptors(impl, usage);
+
+    if ((usage & RFX_USAGE_PERSISTENT_MAP) && memType != RFX_MEM_GPU_ONLY)
+        impl->persistentData = (uint8_t*)CORE.NRI.MapBuffer(*impl->buffer, 0, size);
 
     // init
     if (initialData) {
@@ -1728,9 +2719,8 @@ RfxBuffer rfxCreateBuffer(size_t size, size_t stride, RfxBufferUsageFlags usage,
             UploadToResource(nullptr, impl->buffer, 0, nullptr, nullptr, initialData, size, 0, 0, RFX_STATE_SHADER_READ, impl, nullptr);
         } else {
             // map now
-            void* p = CORE.NRI.MapBuffer(*impl->buffer, 0, size);
-            memcpy(p, initialData, size);
-            CORE.NRI.UnmapBuffer(*impl->buffer);
+            memcpy(rfxMapBuffer(impl), initialData, size);
+            rfxUnmapBuffer(impl);
 
             impl->currentAccess = nri::AccessBits::SHADER_RESOURCE;
             impl->currentStage = nri::StageBits::ALL;
@@ -1758,28 +2748,150 @@ void rfxDestroyBuffer(RfxBuffer buffer) {
         return;
     RfxBufferImpl* ptr = buffer;
     rfxDeferDestruction([=]() {
+        FreeBufferSlot(ptr->bindlessIndex);
+        if (ptr->persistentData)
+            CORE.NRI.UnmapBuffer(*ptr->buffer);
         if (ptr->descriptorSRV)
             CORE.NRI.DestroyDescriptor(ptr->descriptorSRV);
         if (ptr->descriptorUAV)
             CORE.NRI.DestroyDescriptor(ptr->descriptorUAV);
         CORE.NRI.DestroyBuffer(ptr->buffer);
-        CORE.NRI.FreeMemory(ptr->memory);
+        if (ptr->memory) // placed buffers don't own their memory
+            CORE.NRI.FreeMemory(ptr->memory);
         RfxDelete(ptr);
     });
 }
 
 void* rfxMapBuffer(RfxBuffer buffer) {
+    return rfxMapBufferRange(buffer, 0, buffer ? buffer->size : 0);
+}
+
+void* rfxMapBufferRange(RfxBuffer buffer, uint64_t offset, uint64_t size) {
     if (!buffer)
         return nullptr;
-    return CORE.NRI.MapBuffer(*buffer->buffer, 0, buffer->size);
+    RFX_ASSERT(offset + size <= buffer->size);
+    if (buffer->persistentData)
+        return buffer->persistentData + offset;
+    return CORE.NRI.MapBuffer(*buffer->buffer, offset, size);
 }
 
 void rfxUnmapBuffer(RfxBuffer buffer) {
-    if (!buffer)
+    if (!buffer || buffer->persistentData)
         return;
     CORE.NRI.UnmapBuffer(*buffer->buffer);
 }
 
+// NRI only hands out host-coherent memory, so the device side needs nothing and these just order the CPU's accesses
+// against the submit / the fence wait
+void rfxFlushBufferRange(RfxBuffer buffer, uint64_t offset, uint64_t size) {
+    if (!buffer)
+        return;
+    RFX_ASSERT(offset + size <= buffer->size);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void rfxInvalidateBufferRange(RfxBuffer buffer, uint64_t offset, uint64_t size) {
+    if (!buffer)
+        return;
+    RFX_ASSERT(offset + size <= buffer->size);
+    std::atomic_thread_fence(std::memory_order_acquire);
+}
+
+//
+// Transient allocations
+//
+
+#define RFX_TRANSIENT_FRAME_SIZE (4ull * 1024 * 1024)
+
+static TransientPage CreateTransientPage(uint64_t size) {
+    TransientPage page = {};
+    page.size = size;
+    page.buffer = rfxCreateBuffer(
+        size, 0,
+        RFX_USAGE_SHADER_RESOURCE | RFX_USAGE_VERTEX_BUFFER | RFX_USAGE_INDEX_BUFFER | RFX_USAGE_CONSTANT_BUFFER | RFX_USAGE_PERSISTENT_MAP,
+        RFX_MEM_CPU_TO_GPU, nullptr
+    );
+    page.data = page.buffer->persistentData;
+    page.deviceAddress = CORE.NRI.GetBufferDeviceAddress(*page.buffer->buffer);
+    return page;
+}
+
+// the buffer itself goes through the graveyard, so frames still reading it are fine
+static void DestroyTransientPage(TransientPage& page) {
+    rfxDestroyBuffer(page.buffer);
+    page = {};
+}
+
+// the frame's previous use has retired: frees its overflow pages and points the ring at its slice, growing the ring
+// first if the last frame overflowed
+static void BeginTransientFrame(QueuedFrame& qf, uint32_t frameIdx) {
+    for (TransientPage& page : qf.transientOverflow)
+        DestroyTransientPage(page);
+    qf.transientOverflow.clear();
+    qf.transientOverflowUsed = 0;
+
+    CoreData::TransientRing& ring = CORE.Transient;
+    uint64_t overflow = ring.overflow.exchange(0);
+    if (!ring.page.buffer || overflow > 0) {
+        uint64_t frameSize = ring.page.buffer ? std::max(ring.frameSize * 2, ring.frameSize + overflow) : RFX_TRANSIENT_FRAME_SIZE;
+        ring.frameSize = (frameSize + 255) & ~255ull;
+        DestroyTransientPage(ring.page);
+        ring.page = CreateTransientPage(ring.frameSize * GetQueuedFrameNum());
+    }
+
+    ring.sliceOffset = frameIdx * ring.frameSize;
+    ring.used = 0;
+}
+
+RfxTransientAlloc rfxAllocTransient(uint64_t size, uint64_t alignment) {
+    RfxTransientAlloc alloc = {};
+    if (size == 0)
+        return alloc;
+    if (alignment == 0)
+        alignment = 16;
+    RFX_ASSERT((alignment & (alignment - 1)) == 0 && "alignment must be a power of two");
+
+    CoreData::TransientRing& ring = CORE.Transient;
+    TransientPage page = ring.page;
+    uint64_t offset = 0;
+    bool fits = false;
+
+    // lock-free bump within the frame's slice
+    uint64_t used = ring.used.load(std::memory_order_relaxed);
+    while (true) {
+        offset = (ring.sliceOffset + used + alignment - 1) & ~(alignment - 1);
+        uint64_t newUsed = offset + size - ring.sliceOffset;
+        if (newUsed > ring.frameSize)
+            break;
+        if (ring.used.compare_exchange_weak(used, newUsed, std::memory_order_relaxed)) {
+            fits = true;
+            break;
+        }
+    }
+
+    // the slice is full, take it from a page of the frame's own and grow the ring at the next frame
+    if (!fits) {
+        ring.overflow += size + alignment;
+
+        std::lock_guard<std::mutex> lock(ring.overflowMutex);
+        QueuedFrame& qf = CORE.QueuedFrames[CORE.FrameIndex % GetQueuedFrameNum()];
+        offset = (qf.transientOverflowUsed + alignment - 1) & ~(alignment - 1);
+        if (qf.transientOverflow.empty() || offset + size > qf.transientOverflow.back().size) {
+            qf.transientOverflow.push_back(CreateTransientPage(std::max<uint64_t>(size, RFX_TRANSIENT_FRAME_SIZE)));
+            offset = 0;
+        }
+        qf.transientOverflowUsed = offset + size;
+        page = qf.transientOverflow.back();
+    }
+
+    alloc.cpu = page.data + offset;
+    alloc.buffer = page.buffer;
+    alloc.bufferId = page.buffer->bindlessIndex;
+    alloc.offset = offset;
+    alloc.deviceAddress = page.deviceAddress ? page.deviceAddress + offset : 0;
+    return alloc;
+}
+
 RfxTexture rfxCreateTexture(int width, int height, RfxFormat format, int sampleCount, RfxTextureUsageFlags usage, const void* initialData) {
     RfxTextureDesc desc = {};
     desc.width = width;
@@ -1794,10 +2906,8 @@ RfxTexture rfxCreateTexture(int width, int height, RfxFormat format, int sampleC
     return rfxCreateTextureEx(&desc);
 }
 
-RfxTexture rfxCreateTextureEx(const RfxTextureDesc* desc) {
-    if (!desc)
-        return nullptr;
-
+// creates the RfxTextureImpl and its NRI texture, without memory or views
+static RfxTextureImpl* CreateTextureObject(const RfxTextureDesc* desc) {
     int sampleCount = (desc->sampleCount <= 0) ? 1 : desc->sampleCount;
     uint32_t depth = (desc->depth <= 0) ? 1 : desc->depth;
     uint32_t mips = (desc->mipLevels <= 0) ? 1 : desc->mipLevels;
@@ -1818,7 +2928,6 @@ RfxTexture rfxCreateTextureEx(const RfxTextureDesc* desc) {
     impl->state = RfxNew<RfxTextureSharedState>();
     impl->state->totalMips = mips;
     impl->state->totalLayers = layers;
-    impl->state->subresourceStates.resize(mips * layers, RFX_STATE_UNDEFINED);
 
     nri::TextureDesc td = {};
     td.type = (depth > 1) ? nri::TextureType::TEXTURE_3D : nri::TextureType::TEXTURE_2D;
@@ -1841,6 +2950,48 @@ RfxTexture rfxCreateTextureEx(const RfxTextureDesc* desc) {
         td.usage |= nri::TextureUsageBits::SHADER_RESOURCE_STORAGE;
 
     NRI_CHECK(CORE.NRI.CreateTexture(*CORE.NRIDevice, td, impl->texture));
+    return impl;
+}
+
+// streams every given subresource of a fresh texture, the whole batch behind one pair of barriers
+static void UploadSubresources(RfxTextureImpl* impl, const void* const* data, uint32_t depth) {
+    const nri::FormatProps* props = nri::nriGetFormatProps(impl->format);
+    std::lock_guard<std::mutex> lock(CORE.StreamerMutex);
+
+    for (uint32_t layer = 0; layer < impl->layerNum; ++layer) {
+        for (uint32_t mip = 0; mip < impl->mipNum; ++mip) {
+            const void* subresource = data[layer * impl->mipNum + mip];
+            if (!subresource)
+                continue;
+
+            uint32_t w = std::max(1u, impl->width >> mip);
+            uint32_t h = std::max(1u, impl->height >> mip);
+            uint32_t rowPitch = (w + props->blockWidth - 1) / props->blockWidth * props->stride;
+
+            nri::StreamTextureDataDesc std = {};
+            std.data = subresource;
+            std.dataRowPitch = rowPitch;
+            std.dataSlicePitch = rowPitch * ((h + props->blockHeight - 1) / props->blockHeight);
+            std.dstTexture = impl->texture;
+            std.dstRegion.mipOffset = (nri::Dim_t)mip;
+            std.dstRegion.layerOffset = (nri::Dim_t)layer;
+            std.dstRegion.width = (nri::Dim_t)w;
+            std.dstRegion.height = (nri::Dim_t)h;
+            std.dstRegion.depth = (nri::Dim_t)std::max(1u, depth >> mip);
+            std.dstRegion.planes = nri::PlaneBits::ALL;
+            CORE.NRI.StreamTextureData(*CORE.NRIStreamer, std);
+        }
+    }
+
+    CORE.PendingUploads.push_back({ nullptr, impl, 0, impl->mipNum, 0, impl->layerNum, RFX_STATE_SHADER_READ });
+}
+
+RfxTexture rfxCreateTextureEx(const RfxTextureDesc* desc) {
+    if (!desc)
+        return nullptr;
+
+    RfxTextureImpl* impl = CreateTextureObject(desc);
+    uint32_t depth = (desc->depth <= 0) ? 1 : desc->depth;
 
     AllocateAndBind<nri::Texture, nri::BindTextureMemoryDesc>(
         impl->texture, nri::MemoryLocation::DEVICE, impl->memory,
@@ -1852,7 +3003,9 @@ RfxTexture rfxCreateTextureEx(const RfxTextureDesc* desc) {
     CreateTextureDescriptors(impl, desc->usage, 0, nri::REMAINING, 0, nri::REMAINING);
 
     // only transition if we have data to upload
-    if (desc->initialData && sampleCount == 1) {
+    if (desc->subresourceData && impl->sampleCount == 1) {
+        UploadSubresources(impl, desc->subresourceData, depth);
+    } else if (desc->initialData && impl->sampleCount == 1) {
         RfxResourceState finalState = RFX_STATE_SHADER_READ;
 
         const nri::FormatProps* props = nri::nriGetFormatProps(impl->format);
@@ -1875,11 +3028,450 @@ RfxTexture rfxCreateTextureEx(const RfxTextureDesc* desc) {
     return impl;
 }
 
+//
+// Texture containers (DDS, KTX2)
+//
+
+// read-only mapping of a whole file
+struct MappedFile {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+#if RAFX_PLATFORM == RAFX_WINDOWS
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+    bool Open(const char* path) {
+#if RAFX_PLATFORM == RAFX_WINDOWS
+        file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+            return false;
+        size = (size_t)fileSize.QuadPart;
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping)
+            return false;
+        data = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+        int fd = open(path, O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            close(fd);
+            return false;
+        }
+        size = (size_t)st.st_size;
+        void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd); // the mapping keeps the file alive
+        if (p == MAP_FAILED)
+            return false;
+        madvise(p, size, MADV_SEQUENTIAL);
+        data = (const uint8_t*)p;
+#endif
+        return data != nullptr;
+    }
+
+    void Close() {
+#if RAFX_PLATFORM == RAFX_WINDOWS
+        if (data)
+            UnmapViewOfFile(data);
+        if (mapping)
+            CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (data)
+            munmap((void*)data, size);
+#endif
+        data = nullptr;
+        size = 0;
+    }
+};
+
+struct DDSPixelFormat {
+    uint32_t size, flags, fourCC, rgbBitCount, rMask, gMask, bMask, aMask;
+};
+
+struct DDSHeader {
+    uint32_t size, flags, height, width, pitchOrLinearSize, depth, mipMapCount, reserved1[11];
+    DDSPixelFormat ddspf;
+    uint32_t caps, caps2, caps3, caps4, reserved2;
+};
+
+struct DDSHeaderDX10 {
+    uint32_t dxgiFormat, resourceDimension, miscFlag, arraySize, miscFlags2;
+};
+
+struct KTX2Header {
+    uint8_t identifier[12];
+    uint32_t vkFormat, typeSize, pixelWidth, pixelHeight, pixelDepth, layerCount, faceCount, levelCount, supercompressionScheme;
+    uint32_t dfdByteOffset, dfdByteLength, kvdByteOffset, kvdByteLength;
+    uint64_t sgdByteOffset, sgdByteLength;
+};
+
+struct KTX2Level {
+    uint64_t byteOffset, byteLength, uncompressedByteLength;
+};
+
+static_assert(sizeof(DDSHeader) == 124 && sizeof(DDSHeaderDX10) == 20, "DDS headers must match the file layout");
+static_assert(sizeof(KTX2Header) == 80 && sizeof(KTX2Level) == 24, "KTX2 headers must match the file layout");
+
+#define RFX_FOURCC(a, b, c, d) ((uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+
+// the D3D12 limits, anything beyond is a broken header
+#define RFX_MAX_LOADED_EXTENT 16384
+#define RFX_MAX_LOADED_DEPTH 2048
+#define RFX_MAX_LOADED_LAYERS 2048
+
+static RfxFormat FromDXGIFormat(uint32_t format) {
+    switch (format) {
+    case 2: return RFX_FORMAT_RGBA32_FLOAT;
+    case 3: return RFX_FORMAT_RGBA32_UINT;
+    case 4: return RFX_FORMAT_RGBA32_SINT;
+    case 6: return RFX_FORMAT_RGB32_FLOAT;
+    case 7: return RFX_FORMAT_RGB32_UINT;
+    case 8: return RFX_FORMAT_RGB32_SINT;
+    case 10: return RFX_FORMAT_RGBA16_FLOAT;
+    case 11: return RFX_FORMAT_RGBA16_UNORM;
+    case 12: return RFX_FORMAT_RGBA16_UINT;
+    case 13: return RFX_FORMAT_RGBA16_SNORM;
+    case 14: return RFX_FORMAT_RGBA16_SINT;
+    case 16: return RFX_FORMAT_RG32_FLOAT;
+    case 17: return RFX_FORMAT_RG32_UINT;
+    case 18: return RFX_FORMAT_RG32_SINT;
+    case 24: return RFX_FORMAT_R10_G10_B10_A2_UNORM;
+    case 25: return RFX_FORMAT_R10_G10_B10_A2_UINT;
+    case 26: return RFX_FORMAT_R11_G11_B10_UFLOAT;
+    case 28: return RFX_FORMAT_RGBA8_UNORM;
+    case 29: return RFX_FORMAT_RGBA8_SRGB;
+    case 30: return RFX_FORMAT_RGBA8_UINT;
+    case 32: return RFX_FORMAT_RGBA8_SINT;
+    case 35: return RFX_FORMAT_RG16_UNORM;
+    case 36: return RFX_FORMAT_RG16_UINT;
+    case 37: return RFX_FORMAT_RG16_SNORM;
+    case 38: return RFX_FORMAT_RG16_SINT;
+    case 41: return RFX_FORMAT_R32_FLOAT;
+    case 42: return RFX_FORMAT_R32_UINT;
+    case 43: return RFX_FORMAT_R32_SINT;
+    case 50: return RFX_FORMAT_RG8_UINT;
+    case 52: return RFX_FORMAT_RG8_SINT;
+    case 56: return RFX_FORMAT_R16_UNORM;
+    case 57: return RFX_FORMAT_R16_UINT;
+    case 58: return RFX_FORMAT_R16_SNORM;
+    case 59: return RFX_FORMAT_R16_SINT;
+    case 62: return RFX_FORMAT_R8_UINT;
+    case 64: return RFX_FORMAT_R8_SINT;
+    case 67: return RFX_FORMAT_R9_G9_B9_E5_UFLOAT;
+    case 71: return RFX_FORMAT_BC1_RGBA_UNORM;
+    case 72: return RFX_FORMAT_BC1_RGBA_SRGB;
+    case 74: return RFX_FORMAT_BC2_RGBA_UNORM;
+    case 75: return RFX_FORMAT_BC2_RGBA_SRGB;
+    case 77: return RFX_FORMAT_BC3_RGBA_UNORM;
+    case 78: return RFX_FORMAT_BC3_RGBA_SRGB;
+    case 80: return RFX_FORMAT_BC4_R_UNORM;
+    case 81: return RFX_FORMAT_BC4_R_SNORM;
+    case 83: return RFX_FORMAT_BC5_RG_UNORM;
+    case 84: return RFX_FORMAT_BC5_RG_SNORM;
+    case 87: return RFX_FORMAT_BGRA8_UNORM;
+    case 91: return RFX_FORMAT_BGRA8_SRGB;
+    case 95: return RFX_FORMAT_BC6H_RGB_UFLOAT;
+    case 96: return RFX_FORMAT_BC6H_RGB_SFLOAT;
+    case 98: return RFX_FORMAT_BC7_RGBA_UNORM;
+    case 99: return RFX_FORMAT_BC7_RGBA_SRGB;
+    default: return RFX_FORMAT_UNKNOWN;
+    }
+}
+
+static RfxFormat FromVkFormat(uint32_t format) {
+    switch (format) {
+    case 13: return RFX_FORMAT_R8_UINT;
+    case 14: return RFX_FORMAT_R8_SINT;
+    case 20: return RFX_FORMAT_RG8_UINT;
+    case 21: return RFX_FORMAT_RG8_SINT;
+    case 37: return RFX_FORMAT_RGBA8_UNORM;
+    case 41: return RFX_FORMAT_RGBA8_UINT;
+    case 42: return RFX_FORMAT_RGBA8_SINT;
+    case 43: return RFX_FORMAT_RGBA8_SRGB;
+    case 44: return RFX_FORMAT_BGRA8_UNORM;
+    case 50: return RFX_FORMAT_BGRA8_SRGB;
+    case 64: return RFX_FORMAT_R10_G10_B10_A2_UNORM;
+    case 68: return RFX_FORMAT_R10_G10_B10_A2_UINT;
+    case 70: return RFX_FORMAT_R16_UNORM;
+    case 71: return RFX_FORMAT_R16_SNORM;
+    case 74: return RFX_FORMAT_R16_UINT;
+    case 75: return RFX_FORMAT_R16_SINT;
+    case 77: return RFX_FORMAT_RG16_UNORM;
+    case 78: return RFX_FORMAT_RG16_SNORM;
+    case 81: return RFX_FORMAT_RG16_UINT;
+    case 82: return RFX_FORMAT_RG16_SINT;
+    case 91: return RFX_FORMAT_RGBA16_UNORM;
+    case 92: return RFX_FORMAT_RGBA16_SNORM;
+    case 95: return RFX_FORMAT_RGBA16_UINT;
+    case 96: return RFX_FORMAT_RGBA16_SINT;
+    case 97: return RFX_FORMAT_RGBA16_FLOAT;
+    case 98: return RFX_FORMAT_R32_UINT;
+    case 99: return RFX_FORMAT_R32_SINT;
+    case 100: return RFX_FORMAT_R32_FLOAT;
+    case 101: return RFX_FORMAT_RG32_UINT;
+    case 102: return RFX_FORMAT_RG32_SINT;
+    case 103: return RFX_FORMAT_RG32_FLOAT;
+    case 104: return RFX_FORMAT_RGB32_UINT;
+    case 105: return RFX_FORMAT_RGB32_SINT;
+    case 106: return RFX_FORMAT_RGB32_FLOAT;
+    case 107: return RFX_FORMAT_RGBA32_UINT;
+    case 108: return RFX_FORMAT_RGBA32_SINT;
+    case 109: return RFX_FORMAT_RGBA32_FLOAT;
+    case 122: return RFX_FORMAT_R11_G11_B10_UFLOAT;
+    case 123: return RFX_FORMAT_R9_G9_B9_E5_UFLOAT;
+    case 131: // BC1 RGB shares the block layout
+    case 133: return RFX_FORMAT_BC1_RGBA_UNORM;
+    case 132:
+    case 134: return RFX_FORMAT_BC1_RGBA_SRGB;
+    case 135: return RFX_FORMAT_BC2_RGBA_UNORM;
+    case 136: return RFX_FORMAT_BC2_RGBA_SRGB;
+    case 137: return RFX_FORMAT_BC3_RGBA_UNORM;
+    case 138: return RFX_FORMAT_BC3_RGBA_SRGB;
+    case 139: return RFX_FORMAT_BC4_R_UNORM;
+    case 140: return RFX_FORMAT_BC4_R_SNORM;
+    case 141: return RFX_FORMAT_BC5_RG_UNORM;
+    case 142: return RFX_FORMAT_BC5_RG_SNORM;
+    case 143: return RFX_FORMAT_BC6H_RGB_UFLOAT;
+    case 144: return RFX_FORMAT_BC6H_RGB_SFLOAT;
+    case 145: return RFX_FORMAT_BC7_RGBA_UNORM;
+    case 146: return RFX_FORMAT_BC7_RGBA_SRGB;
+    default: return RFX_FORMAT_UNKNOWN;
+    }
+}
+
+// formats of DDS files without a DX10 header
+static RfxFormat FromDDSPixelFormat(const DDSPixelFormat& pf) {
+    if (pf.flags & 0x4) { // DDPF_FOURCC
+        switch (pf.fourCC) {
+        case RFX_FOURCC('D', 'X', 'T', '1'): return RFX_FORMAT_BC1_RGBA_UNORM;
+        case RFX_FOURCC('D', 'X', 'T', '2'):
+        case RFX_FOURCC('D', 'X', 'T', '3'): return RFX_FORMAT_BC2_RGBA_UNORM;
+        case RFX_FOURCC('D', 'X', 'T', '4'):
+        case RFX_FOURCC('D', 'X', 'T', '5'): return RFX_FORMAT_BC3_RGBA_UNORM;
+        case RFX_FOURCC('A', 'T', 'I', '1'):
+        case RFX_FOURCC('B', 'C', '4', 'U'): return RFX_FORMAT_BC4_R_UNORM;
+        case RFX_FOURCC('B', 'C', '4', 'S'): return RFX_FORMAT_BC4_R_SNORM;
+        case RFX_FOURCC('A', 'T', 'I', '2'):
+        case RFX_FOURCC('B', 'C', '5', 'U'): return RFX_FORMAT_BC5_RG_UNORM;
+        case RFX_FOURCC('B', 'C', '5', 'S'): return RFX_FORMAT_BC5_RG_SNORM;
+        case 36: return RFX_FORMAT_RGBA16_UNORM; // D3DFMT_A16B16G16R16
+        case 110: return RFX_FORMAT_RGBA16_SNORM;
+        case 113: return RFX_FORMAT_RGBA16_FLOAT;
+        case 114: return RFX_FORMAT_R32_FLOAT;
+        case 115: return RFX_FORMAT_RG32_FLOAT;
+        case 116: return RFX_FORMAT_RGBA32_FLOAT;
+        default: return RFX_FORMAT_UNKNOWN;
+        }
+    }
+
+    if ((pf.flags & 0x40) && pf.rgbBitCount == 32) { // DDPF_RGB
+        if (pf.rMask == 0xff && pf.gMask == 0xff00 && pf.bMask == 0xff0000)
+            return RFX_FORMAT_RGBA8_UNORM;
+        if (pf.rMask == 0xff0000 && pf.gMask == 0xff00 && pf.bMask == 0xff)
+            return RFX_FORMAT_BGRA8_UNORM;
+        if (pf.rMask == 0x3ff && pf.gMask == 0xffc00 && pf.bMask == 0x3ff00000)
+            return RFX_FORMAT_R10_G10_B10_A2_UNORM;
+        if (pf.rMask == 0xffff && pf.gMask == 0xffff0000)
+            return RFX_FORMAT_RG16_UNORM;
+    }
+    return RFX_FORMAT_UNKNOWN;
+}
+
+// tightly packed size of one subresource, with the same block math as rfxCmdUploadTexture
+static uint64_t GetSubresourceSize(const nri::FormatProps* props, uint32_t width, uint32_t height, uint32_t depth, uint32_t mip) {
+    uint64_t w = std::max(1u, width >> mip);
+    uint64_t h = std::max(1u, height >> mip);
+    uint64_t d = std::max(1u, depth >> mip);
+    uint64_t rowPitch = (w + props->blockWidth - 1) / props->blockWidth * props->stride;
+    return rowPitch * ((h + props->blockHeight - 1) / props->blockHeight) * d;
+}
+
+// rejects headers no real texture has. Past this, mips shift by less than 32 and the size math fits in 64 bits
+static bool IsPlausibleTextureDesc(const RfxTextureDesc& desc, uint64_t arrayLayers) {
+    if (desc.width == 0 || desc.height == 0 || desc.depth == 0 || desc.mipLevels == 0 || arrayLayers == 0)
+        return false;
+    if (desc.width > RFX_MAX_LOADED_EXTENT || desc.height > RFX_MAX_LOADED_EXTENT || desc.depth > RFX_MAX_LOADED_DEPTH ||
+        arrayLayers > RFX_MAX_LOADED_LAYERS)
+        return false;
+
+    // floor(log2(largest extent)) + 1
+    uint32_t largest = std::max({ desc.width, desc.height, desc.depth });
+    uint32_t maxMips = 1;
+    while (largest >> maxMips)
+        maxMips++;
+    return desc.mipLevels <= maxMips;
+}
+
+// DDS stores each layer (cube faces are layers) with its whole mip chain, one after another
+static bool ParseDDS(const uint8_t* data, size_t size, RfxTextureDesc& desc, RfxVector<const void*>& subresources) {
+    if (size < 4 + sizeof(DDSHeader))
+        return false;
+
+    DDSHeader header;
+    memcpy(&header, data + 4, sizeof(header));
+    uint64_t offset = 4 + sizeof(header);
+
+    uint32_t layers = 1;
+    uint32_t depth = 1;
+    bool cube = (header.caps2 & 0x200) != 0; // DDSCAPS2_CUBEMAP
+    if ((header.caps2 & 0x200000) && (header.flags & 0x800000)) // DDSCAPS2_VOLUME & DDSD_DEPTH
+        depth = header.depth;
+
+    if ((header.ddspf.flags & 0x4) && header.ddspf.fourCC == RFX_FOURCC('D', 'X', '1', '0')) {
+        if (size < offset + sizeof(DDSHeaderDX10))
+            return false;
+        DDSHeaderDX10 dx10;
+        memcpy(&dx10, data + offset, sizeof(dx10));
+        offset += sizeof(dx10);
+
+        desc.format = FromDXGIFormat(dx10.dxgiFormat);
+        layers = dx10.arraySize;
+        cube = (dx10.miscFlag & 0x4) != 0; // RESOURCE_MISC_TEXTURECUBE
+        if (dx10.resourceDimension == 4) // TEXTURE3D
+            depth = header.depth;
+    } else {
+        desc.format = FromDDSPixelFormat(header.ddspf);
+    }
+
+    if (desc.format == RFX_FORMAT_UNKNOWN)
+        return false;
+
+    uint64_t arrayLayers = (uint64_t)layers * (cube ? 6 : 1);
+    desc.width = header.width;
+    desc.height = header.height;
+    desc.depth = depth;
+    desc.mipLevels = (header.flags & 0x20000) ? std::max(1u, header.mipMapCount) : 1; // DDSD_MIPMAPCOUNT
+    if (!IsPlausibleTextureDesc(desc, arrayLayers))
+        return false;
+    desc.arrayLayers = (uint32_t)arrayLayers;
+
+    // every layer holds the same mip chain, so the whole payload is known up front
+    const nri::FormatProps* props = nri::nriGetFormatProps(ToNRIFormat(desc.format));
+    uint64_t chainBytes = 0;
+    for (uint32_t mip = 0; mip < desc.mipLevels; ++mip)
+        chainBytes += GetSubresourceSize(props, desc.width, desc.height, depth, mip);
+    if (chainBytes * arrayLayers > size - offset)
+        return false;
+
+    subresources.resize((size_t)arrayLayers * desc.mipLevels);
+    for (uint32_t layer = 0; layer < desc.arrayLayers; ++layer) {
+        for (uint32_t mip = 0; mip < desc.mipLevels; ++mip) {
+            subresources[layer * desc.mipLevels + mip] = data + offset;
+            offset += GetSubresourceSize(props, desc.width, desc.height, depth, mip);
+        }
+    }
+    return true;
+}
+
+// KTX2 stores mips one after another (at the offsets of its level index), each holding every layer & face
+static bool ParseKTX2(const uint8_t* data, size_t size, RfxTextureDesc& desc, RfxVector<const void*>& subresources) {
+    if (size < sizeof(KTX2Header))
+        return false;
+
+    KTX2Header header;
+    memcpy(&header, data, sizeof(header));
+    if (header.supercompressionScheme != 0) {
+        fprintf(stderr, "[Rafx] Supercompressed KTX2 files aren't supported\n");
+        return false;
+    }
+
+    desc.format = FromVkFormat(header.vkFormat);
+    if (desc.format == RFX_FORMAT_UNKNOWN || (header.faceCount != 1 && header.faceCount != 6))
+        return false;
+
+    // a zero height/depth/layer count marks 1D/2D/non-array textures, zero levels asks for runtime mip generation
+    uint64_t arrayLayers = (uint64_t)std::max(1u, header.layerCount) * header.faceCount;
+    desc.width = header.pixelWidth;
+    desc.height = std::max(1u, header.pixelHeight);
+    desc.depth = std::max(1u, header.pixelDepth);
+    desc.mipLevels = std::max(1u, header.levelCount);
+    if (!IsPlausibleTextureDesc(desc, arrayLayers))
+        return false;
+    desc.arrayLayers = (uint32_t)arrayLayers;
+
+    if (size < sizeof(KTX2Header) + desc.mipLevels * sizeof(KTX2Level))
+        return false;
+
+    // check the whole level index before pointing into it
+    const nri::FormatProps* props = nri::nriGetFormatProps(ToNRIFormat(desc.format));
+    for (uint32_t mip = 0; mip < desc.mipLevels; ++mip) {
+        KTX2Level level;
+        memcpy(&level, data + sizeof(KTX2Header) + mip * sizeof(KTX2Level), sizeof(level));
+
+        uint64_t bytes = GetSubresourceSize(props, desc.width, desc.height, desc.depth, mip);
+        if (level.byteOffset > size || level.byteLength > size - level.byteOffset || level.byteLength < bytes * arrayLayers)
+            return false;
+    }
+
+    subresources.resize((size_t)arrayLayers * desc.mipLevels);
+    for (uint32_t mip = 0; mip < desc.mipLevels; ++mip) {
+        KTX2Level level;
+        memcpy(&level, data + sizeof(KTX2Header) + mip * sizeof(KTX2Level), sizeof(level));
+
+        uint64_t bytes = GetSubresourceSize(props, desc.width, desc.height, desc.depth, mip);
+        for (uint32_t layer = 0; layer < desc.arrayLayers; ++layer)
+            subresources[layer * desc.mipLevels + mip] = data + level.byteOffset + layer * bytes;
+    }
+    return true;
+}
+
+RfxTexture rfxLoadTextureMem(const void* data, size_t size, RfxTextureUsageFlags usage) {
+    if (!data)
+        return nullptr;
+
+    static const uint8_t ktx2Identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+    const uint8_t* bytes = (const uint8_t*)data;
+
+    RfxTextureDesc desc = {};
+    RfxVector<const void*> subresources;
+    bool parsed = false;
+    if (size >= 4 && memcmp(bytes, "DDS ", 4) == 0)
+        parsed = ParseDDS(bytes, size, desc, subresources);
+    else if (size >= sizeof(ktx2Identifier) && memcmp(bytes, ktx2Identifier, sizeof(ktx2Identifier)) == 0)
+        parsed = ParseKTX2(bytes, size, desc, subresources);
+
+    if (!parsed) {
+        fprintf(stderr, "[Rafx] Not a supported DDS/KTX2 texture\n");
+        return nullptr;
+    }
+
+    desc.sampleCount = 1;
+    desc.usage = usage ? usage : (RfxTextureUsageFlags)RFX_TEXTURE_USAGE_SHADER_RESOURCE;
+    desc.subresourceData = subresources.data();
+    return rfxCreateTextureEx(&desc);
+}
+
+RfxTexture rfxLoadTexture(const char* path, RfxTextureUsageFlags usage) {
+    MappedFile file;
+    if (!path || !file.Open(path)) {
+        fprintf(stderr, "[Rafx] Failed to open texture: %s\n", path ? path : "(null)");
+        file.Close();
+        return nullptr;
+    }
+
+    // creation streams every subresource straight out of the mapping, so it can go right after
+    RfxTexture texture = rfxLoadTextureMem(file.data, file.size, usage);
+    file.Close();
+    return texture;
+}
+
 void rfxDestroyTexture(RfxTexture texture) {
     if (!texture)
         return;
     RfxTextureImpl* ptr = texture;
 
+    for (RfxTexture view : ptr->mipViews)
+        rfxDestroyTexture(view);
+
     if (!ptr->isView && ptr->bindlessIndex != 0)
         FreeTextureSlot(ptr->bindlessIndex);
     else if (ptr->isView && ptr->bindlessIndex != 0)
@@ -1895,42 +3487,440 @@ void rfxDestroyTexture(RfxTexture texture) {
 
         if (!ptr->isView) {
             CORE.NRI.DestroyTexture(ptr->texture);
-            CORE.NRI.FreeMemory(ptr->memory);
+            if (ptr->memory) // placed textures don't own their memory
+                CORE.NRI.FreeMemory(ptr->memory);
+        }
+
+        if (ptr->state)
+            ptr->state->Release();
+        RfxDelete(ptr);
+    });
+}
+
+uint32_t rfxGetTextureId(RfxTexture texture) {
+    return texture ? texture->bindlessIndex : 0;
+}
+
+RfxSampler rfxCreateSampler(RfxFilter filter, RfxAddressMode addressMode) {
+    RfxSamplerImpl* impl = RfxNew<RfxSamplerImpl>();
+    nri::SamplerDesc sd = {};
+    nri::Filter f = (filter == RFX_FILTER_LINEAR) ? nri::Filter::LINEAR : nri::Filter::NEAREST;
+    sd.filters = { f, f, f, nri::FilterOp::AVERAGE };
+    nri::AddressMode m = (addressMode == RFX_WRAP_CLAMP)
+                             ? nri::AddressMode::CLAMP_TO_EDGE
+                             : (addressMode == RFX_WRAP_MIRROR ? nri::AddressMode::MIRRORED_REPEAT : nri::AddressMode::REPEAT);
+    sd.addressModes = { m, m, m };
+    sd.anisotropy = 1;
+    sd.mipMax = 16.0f;
+    NRI_CHECK(CORE.NRI.CreateSampler(*CORE.NRIDevice, sd, impl->descriptor));
+    return impl;
+}
+
+void rfxDestroySampler(RfxSampler sampler) {
+    if (!sampler)
+        return;
+    RfxSamplerImpl* ptr = sampler;
+    rfxDeferDestruction([=]() {
+        CORE.NRI.DestroyDescriptor(ptr->descriptor);
+        RfxDelete(ptr);
+    });
+}
+
+//
+// Frame graph
+//
+
+RfxFrameGraph rfxCreateFrameGraph() {
+    return RfxNew<RfxFrameGraphImpl>();
+}
+
+// hands the placed transients and their heaps to the graveyard
+static void ReleaseTransients(RfxFrameGraphImpl* graph) {
+    for (RfxFrameGraphImpl::Transient& t : graph->transients) {
+        rfxDestroyTexture(t.texture);
+        rfxDestroyBuffer(t.buffer);
+    }
+    graph->transients.clear();
+
+    if (!graph->heaps.empty()) {
+        RfxVector<nri::Memory*> heaps = std::move(graph->heaps);
+        rfxDeferDestruction([=]() {
+            for (nri::Memory* heap : heaps)
+                CORE.NRI.FreeMemory(heap);
+        });
+        graph->heaps.clear();
+    }
+}
+
+void rfxDestroyFrameGraph(RfxFrameGraph graph) {
+    if (!graph)
+        return;
+    ReleaseTransients(graph);
+    RfxDelete(graph);
+}
+
+void rfxResetFrameGraph(RfxFrameGraph graph) {
+    graph->passes.clear();
+    graph->resources.clear();
+}
+
+uint32_t rfxGraphImportTexture(RfxFrameGraph graph, RfxTexture texture) {
+    RfxFrameGraphImpl::Resource& r = graph->resources.emplace_back();
+    r.texture = texture;
+    r.imported = true;
+    return (uint32_t)graph->resources.size() - 1;
+}
+
+uint32_t rfxGraphImportBuffer(RfxFrameGraph graph, RfxBuffer buffer) {
+    RfxFrameGraphImpl::Resource& r = graph->resources.emplace_back();
+    r.buffer = buffer;
+    r.imported = true;
+    return (uint32_t)graph->resources.size() - 1;
+}
+
+uint32_t rfxGraphCreateTexture(RfxFrameGraph graph, const RfxTextureDesc* desc) {
+    RfxFrameGraphImpl::Resource& r = graph->resources.emplace_back();
+    r.key.width = desc->width;
+    r.key.height = desc->height;
+    r.key.depth = (desc->depth <= 0) ? 1 : desc->depth;
+    r.key.mipLevels = (desc->mipLevels <= 0) ? 1 : desc->mipLevels;
+    r.key.arrayLayers = (desc->arrayLayers <= 0) ? 1 : desc->arrayLayers;
+    r.key.format = desc->format;
+    r.key.sampleCount = (desc->sampleCount <= 0) ? 1 : desc->sampleCount;
+    r.key.usage = desc->usage;
+    return (uint32_t)graph->resources.size() - 1;
+}
+
+uint32_t rfxGraphCreateBuffer(RfxFrameGraph graph, size_t size, size_t stride, RfxBufferUsageFlags usage) {
+    RfxFrameGraphImpl::Resource& r = graph->resources.emplace_back();
+    r.key.isBuffer = true;
+    r.key.size = size;
+    r.key.stride = (uint32_t)stride;
+    r.key.usage = usage;
+    return (uint32_t)graph->resources.size() - 1;
+}
+
+uint32_t rfxGraphAddPass(RfxFrameGraph graph, const char* name, RfxGraphPassFunc func, void* userData) {
+    RfxFrameGraphImpl::Pass& pass = graph->passes.emplace_back();
+    pass.name = name;
+    pass.func = func;
+    pass.userData = userData;
+    return (uint32_t)graph->passes.size() - 1;
+}
+
+void rfxGraphRead(RfxFrameGraph graph, uint32_t pass, uint32_t resource, RfxResourceState state) {
+    RFX_ASSERT(pass < graph->passes.size() && resource < graph->resources.size());
+    graph->passes[pass].accesses.push_back({ resource, state, false });
+}
+
+void rfxGraphWrite(RfxFrameGraph graph, uint32_t pass, uint32_t resource, RfxResourceState state) {
+    RFX_ASSERT(pass < graph->passes.size() && resource < graph->resources.size());
+    graph->passes[pass].accesses.push_back({ resource, state, true });
+}
+
+RfxTexture rfxGraphGetTexture(RfxFrameGraph graph, uint32_t resource) {
+    return resource < graph->resources.size() ? graph->resources[resource].texture : nullptr;
+}
+
+RfxBuffer rfxGraphGetBuffer(RfxFrameGraph graph, uint32_t resource) {
+    return resource < graph->resources.size() ? graph->resources[resource].buffer : nullptr;
+}
+
+// walks the passes backwards, keeping the ones whose writes are observable or read by a kept pass
+static void CullPasses(RfxFrameGraphImpl* graph) {
+    for (RfxFrameGraphImpl::Resource& r : graph->resources)
+        r.needed = false;
+
+    for (size_t i = graph->passes.size(); i-- > 0;) {
+        RfxFrameGraphImpl::Pass& pass = graph->passes[i];
+
+        bool hasWrites = false;
+        bool keep = false;
+        for (const RfxFrameGraphImpl::Access& a : pass.accesses) {
+            if (!a.write)
+                continue;
+            const RfxFrameGraphImpl::Resource& r = graph->resources[a.resource];
+            hasWrites = true;
+            keep |= r.imported || r.needed;
+        }
+
+        pass.culled = hasWrites && !keep;
+        if (pass.culled)
+            continue;
+        for (const RfxFrameGraphImpl::Access& a : pass.accesses) {
+            if (!a.write)
+                graph->resources[a.resource].needed = true;
+        }
+    }
+}
+
+// creates the transients and packs the ones with disjoint lifetimes into the same heap ranges
+static void PlaceTransients(RfxFrameGraphImpl* graph) {
+    struct Placement {
+        nri::MemoryDesc memory;
+        uint32_t heap;
+        uint64_t offset;
+    };
+    struct Heap {
+        nri::MemoryType type;
+        uint64_t size;
+        uint32_t alignment;
+        bool multisample;
+    };
+
+    uint32_t transientNum = (uint32_t)graph->transients.size();
+    RfxVector<Placement> placements(transientNum);
+    RfxVector<uint32_t> order(transientNum);
+    RfxVector<Heap> heaps;
+
+    for (uint32_t i = 0; i < transientNum; ++i) {
+        RfxFrameGraphImpl::Transient& t = graph->transients[i];
+        const RfxFrameGraphImpl::TransientKey& k = t.key;
+        if (k.isBuffer) {
+            t.buffer = CreateBufferObject(k.size, k.stride, k.usage);
+            CORE.NRI.GetBufferMemoryDesc(*t.buffer->buffer, nri::MemoryLocation::DEVICE, placements[i].memory);
+        } else {
+            RfxTextureDesc desc = {};
+            desc.width = k.width;
+            desc.height = k.height;
+            desc.depth = k.depth;
+            desc.mipLevels = k.mipLevels;
+            desc.arrayLayers = k.arrayLayers;
+            desc.format = k.format;
+            desc.sampleCount = k.sampleCount;
+            desc.usage = (RfxTextureUsageFlags)k.usage;
+            t.texture = CreateTextureObject(&desc);
+            CORE.NRI.GetTextureMemoryDesc(*t.texture->texture, nri::MemoryLocation::DEVICE, placements[i].memory);
+        }
+        order[i] = i;
+    }
+
+    // largest first, so the small ones fill the gaps
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return placements[a].memory.size > placements[b].memory.size;
+    });
+
+    RfxVector<uint32_t> placed;
+    for (uint32_t i : order) {
+        Placement& p = placements[i];
+        const RfxFrameGraphImpl::TransientKey& k = graph->transients[i].key;
+        if (p.memory.mustBeDedicated) {
+            p.heap = (uint32_t)-1;
+            continue;
+        }
+
+        p.heap = (uint32_t)heaps.size();
+        for (uint32_t h = 0; h < heaps.size(); ++h) {
+            if (heaps[h].type == p.memory.type) {
+                p.heap = h;
+                break;
+            }
+        }
+        if (p.heap == heaps.size())
+            heaps.push_back({ p.memory.type, 0, 1, false });
+
+        // bump past every live overlapping neighbour until the range is free
+        p.offset = 0;
+        for (bool moved = true; moved;) {
+            moved = false;
+            for (uint32_t j : placed) {
+                const Placement& q = placements[j];
+                const RfxFrameGraphImpl::TransientKey& qk = graph->transients[j].key;
+                if (q.heap != p.heap || qk.lastPass < k.firstPass || k.lastPass < qk.firstPass)
+                    continue;
+                if (p.offset < q.offset + q.memory.size && q.offset < p.offset + p.memory.size) {
+                    p.offset = Align(q.offset + q.memory.size, p.memory.alignment);
+                    moved = true;
+                }
+            }
+        }
+        placed.push_back(i);
+
+        Heap& heap = heaps[p.heap];
+        heap.size = std::max(heap.size, p.offset + p.memory.size);
+        heap.alignment = std::max(heap.alignment, (uint32_t)p.memory.alignment);
+        heap.multisample |= !k.isBuffer && k.sampleCount > 1;
+    }
+
+    // what each placed transient's first barrier has to wait for
+    for (uint32_t i = 0; i < transientNum; ++i) {
+        const Placement& p = placements[i];
+        RfxFrameGraphImpl::Transient& t = graph->transients[i];
+        if (p.heap == (uint32_t)-1)
+            continue;
+
+        for (uint32_t j = 0; j < transientNum; ++j) {
+            const Placement& q = placements[j];
+            if (j == i || q.heap != p.heap || p.offset >= q.offset + q.memory.size || q.offset >= p.offset + p.memory.size)
+                continue;
+            if (graph->transients[j].key.lastPass < t.key.firstPass)
+                t.aliasedBefore.push_back(j);
+            else
+                t.aliasedAfter = true;
+        }
+    }
+
+    for (const Heap& heap : heaps) {
+        nri::AllocateMemoryDesc allocDesc = {};
+        allocDesc.size = heap.size;
+        allocDesc.type = heap.type;
+        allocDesc.priority = 0.0f;
+        allocDesc.vma = { true, heap.alignment };
+        allocDesc.allowMultisampleTextures = heap.multisample;
+
+        nri::Memory* memory = nullptr;
+        NRI_CHECK(CORE.NRI.AllocateMemory(*CORE.NRIDevice, allocDesc, memory));
+        graph->heaps.push_back(memory);
+    }
+
+    for (uint32_t i = 0; i < transientNum; ++i) {
+        RfxFrameGraphImpl::Transient& t = graph->transients[i];
+        const Placement& p = placements[i];
+
+        if (t.buffer) {
+            if (p.heap == (uint32_t)-1) {
+                AllocateAndBind<nri::Buffer, nri::BindBufferMemoryDesc>(
+                    t.buffer->buffer, nri::MemoryLocation::DEVICE, t.buffer->memory,
+                    [&](nri::Buffer& b, nri::MemoryLocation l, nri::MemoryDesc& d) { CORE.NRI.GetBufferMemoryDesc(b, l, d); },
+                    [&](const nri::BindBufferMemoryDesc* d, uint32_t n) { return CORE.NRI.BindBufferMemory(d, n); }
+                );
+            } else {
+                nri::BindBufferMemoryDesc bindDesc = {};
+                bindDesc.buffer = t.buffer->buffer;
+                bindDesc.memory = graph->heaps[p.heap];
+                bindDesc.offset = p.offset;
+                NRI_CHECK(CORE.NRI.BindBufferMemory(&bindDesc, 1));
+            }
+            CreateBufferDescriptors(t.buffer, (RfxBufferUsageFlags)t.key.usage);
+        } else {
+            if (p.heap == (uint32_t)-1) {
+                AllocateAndBind<nri::Texture, nri::BindTextureMemoryDesc>(
+                    t.texture->texture, nri::MemoryLocation::DEVICE, t.texture->memory,
+                    [&](nri::Texture& tex, nri::MemoryLocation l, nri::MemoryDesc& d) { CORE.NRI.GetTextureMemoryDesc(tex, l, d); },
+                    [&](const nri::BindTextureMemoryDesc* d, uint32_t n) { return CORE.NRI.BindTextureMemory(d, n); }
+                );
+            } else {
+                nri::BindTextureMemoryDesc bindDesc = {};
+                bindDesc.texture = t.texture->texture;
+                bindDesc.memory = graph->heaps[p.heap];
+                bindDesc.offset = p.offset;
+                NRI_CHECK(CORE.NRI.BindTextureMemory(&bindDesc, 1));
+            }
+            CreateTextureDescriptors(t.texture, (RfxTextureUsageFlags)t.key.usage, 0, nri::REMAINING, 0, nri::REMAINING);
+        }
+    }
+}
+
+static void CompileFrameGraph(RfxFrameGraphImpl* graph) {
+    CullPasses(graph);
+
+    for (RfxFrameGraphImpl::Resource& r : graph->resources) {
+        r.key.firstPass = (uint32_t)-1;
+        r.key.lastPass = 0;
+        r.transient = (uint32_t)-1;
+    }
+    for (uint32_t i = 0; i < graph->passes.size(); ++i) {
+        if (graph->passes[i].culled)
+            continue;
+        for (const RfxFrameGraphImpl::Access& a : graph->passes[i].accesses) {
+            RfxFrameGraphImpl::Resource& r = graph->resources[a.resource];
+            r.key.firstPass = std::min(r.key.firstPass, i);
+            r.key.lastPass = std::max(r.key.lastPass, i);
+        }
+    }
+
+    RfxVector<RfxFrameGraphImpl::TransientKey> keys;
+    for (RfxFrameGraphImpl::Resource& r : graph->resources) {
+        if (r.imported || r.key.firstPass == (uint32_t)-1)
+            continue;
+        r.transient = (uint32_t)keys.size();
+        keys.push_back(r.key);
+    }
+
+    bool same = keys.size() == graph->transients.size();
+    for (size_t i = 0; same && i < keys.size(); ++i)
+        same = keys[i] == graph->transients[i].key;
+
+    if (!same) {
+        ReleaseTransients(graph);
+        for (const RfxFrameGraphImpl::TransientKey& k : keys)
+            graph->transients.push_back({ k, nullptr, nullptr, {}, false, RFX_STATE_UNDEFINED });
+        PlaceTransients(graph);
+    }
+
+    for (RfxFrameGraphImpl::Resource& r : graph->resources) {
+        if (r.imported)
+            continue;
+        bool used = r.transient != (uint32_t)-1;
+        r.texture = used ? graph->transients[r.transient].texture : nullptr;
+        r.buffer = used ? graph->transients[r.transient].buffer : nullptr;
+    }
+}
+
+// forgets the contents of a transient. Its first barrier still waits for the transients that used its memory before
+static void DiscardTransient(RfxCommandList cmd, RfxFrameGraphImpl* graph, RfxFrameGraphImpl::Resource& r) {
+    const RfxFrameGraphImpl::Transient& t = graph->transients[r.transient];
+
+    nri::AccessBits access = nri::AccessBits::NONE;
+    nri::StageBits stage = nri::StageBits::NONE;
+    if (t.aliasedAfter) {
+        // last used by the previous execution, whatever it did there
+        access = nri::AccessBits::COLOR_ATTACHMENT | nri::AccessBits::DEPTH_STENCIL_ATTACHMENT_WRITE |
+                 nri::AccessBits::SHADER_RESOURCE_STORAGE | nri::AccessBits::COPY_DESTINATION | nri::AccessBits::RESOLVE_DESTINATION;
+        stage = nri::StageBits::ALL;
+    } else {
+        for (uint32_t j : t.aliasedBefore) {
+            nri::AccessBits lastAccess;
+            nri::Layout lastLayout;
+            nri::StageBits lastStage;
+            GetNRIState(graph->transients[j].lastState, lastAccess, lastLayout, lastStage);
+            access |= lastAccess;
+            stage |= lastStage;
         }
+    }
 
-        if (ptr->state)
-            ptr->state->Release();
-        RfxDelete(ptr);
-    });
+    if (r.texture) {
+        cmd->barriers.Assume(r.texture, RFX_STATE_UNDEFINED);
+        if (stage != nri::StageBits::NONE)
+            cmd->barriers.AliasMemory(r.texture, access, stage);
+    } else {
+        cmd->barriers.Assume(r.buffer, RFX_STATE_UNDEFINED);
+        if (stage != nri::StageBits::NONE)
+            cmd->barriers.AliasMemory(r.buffer, access, stage);
+    }
 }
 
-uint32_t rfxGetTextureId(RfxTexture texture) {
-    return texture ? texture->bindlessIndex : 0;
-}
+void rfxCmdExecuteFrameGraph(RfxCommandList cmd, RfxFrameGraph graph) {
+    RFX_ASSERT(!cmd->isRendering && "frame graphs must be executed outside of a render pass");
+    CompileFrameGraph(graph);
 
-RfxSampler rfxCreateSampler(RfxFilter filter, RfxAddressMode addressMode) {
-    RfxSamplerImpl* impl = RfxNew<RfxSamplerImpl>();
-    nri::SamplerDesc sd = {};
-    nri::Filter f = (filter == RFX_FILTER_LINEAR) ? nri::Filter::LINEAR : nri::Filter::NEAREST;
-    sd.filters = { f, f, f, nri::FilterOp::AVERAGE };
-    nri::AddressMode m = (addressMode == RFX_WRAP_CLAMP)
-                             ? nri::AddressMode::CLAMP_TO_EDGE
-                             : (addressMode == RFX_WRAP_MIRROR ? nri::AddressMode::MIRRORED_REPEAT : nri::AddressMode::REPEAT);
-    sd.addressModes = { m, m, m };
-    sd.anisotropy = 1;
-    sd.mipMax = 16.0f;
-    NRI_CHECK(CORE.NRI.CreateSampler(*CORE.NRIDevice, sd, impl->descriptor));
-    return impl;
-}
+    for (uint32_t i = 0; i < graph->passes.size(); ++i) {
+        RfxFrameGraphImpl::Pass& pass = graph->passes[i];
+        if (pass.culled)
+            continue;
 
-void rfxDestroySampler(RfxSampler sampler) {
-    if (!sampler)
-        return;
-    RfxSamplerImpl* ptr = sampler;
-    rfxDeferDestruction([=]() {
-        CORE.NRI.DestroyDescriptor(ptr->descriptor);
-        RfxDelete(ptr);
-    });
+        for (const RfxFrameGraphImpl::Access& a : pass.accesses) {
+            RfxFrameGraphImpl::Resource& r = graph->resources[a.resource];
+            if (!r.imported) {
+                if (r.key.firstPass == i)
+                    DiscardTransient(cmd, graph, r);
+                graph->transients[r.transient].lastState = a.state;
+            }
+            if (r.texture)
+                cmd->barriers.RequireState(r.texture, a.state);
+            else
+                cmd->barriers.RequireState(r.buffer, a.state);
+        }
+        cmd->FlushBarriers();
+
+        if (pass.name)
+            rfxCmdBeginEvent(cmd, pass.name);
+        if (pass.func)
+            pass.func(cmd, pass.userData);
+        if (pass.name)
+            rfxCmdEndEvent(cmd);
+        RFX_ASSERT(!cmd->isRendering && "frame graph passes must end their render pass");
+    }
 }
 
 //
@@ -1983,6 +3973,17 @@ SamplerState GetSamplerLinearWrap() { return g_Samplers[1]; }
 SamplerState GetSamplerNearestClamp() { return g_Samplers[2]; }
 SamplerState GetSamplerNearestWrap() { return g_Samplers[3]; }
 
+// matches RfxMeshRecord, `tableId` is rfxGetBufferId(rfxGetGeometryPoolMeshTable(pool))
+struct RfxMeshRecord {
+    uint vertexOffset;
+    uint vertexCount;
+    uint indexOffset;
+    uint indexCount;
+    float3 boundsCenter;
+    float boundsRadius;
+};
+RfxMeshRecord GetMeshRecord(uint tableId, uint mesh) { return g_Buffers[tableId].Load<RfxMeshRecord>(mesh * 32); }
+
 #endif
 )";
 
@@ -2029,16 +4030,18 @@ struct RafxMemoryBlob : public ISlangBlob {
     }
 };
 
+// shared by every context, like rfxAddVirtualFile
 struct RafxFileSystem : public ISlangFileSystem {
     std::map<std::string, std::string> m_VirtualFiles;
+    std::mutex m_Mutex;
 
     void addFile(const char* name, const char* content) {
-        std::lock_guard<std::mutex> lock(CORE.VirtualFSMutex);
+        std::lock_guard<std::mutex> lock(m_Mutex);
         m_VirtualFiles[name] = content;
     }
 
     void removeFile(const char* name) {
-        std::lock_guard<std::mutex> lock(CORE.VirtualFSMutex);
+        std::lock_guard<std::mutex> lock(m_Mutex);
         m_VirtualFiles.erase(name);
     }
 
@@ -2077,7 +4080,7 @@ struct RafxFileSystem : public ISlangFileSystem {
 
         // check vfs
         {
-            std::lock_guard<std::mutex> lock(CORE.VirtualFSMutex);
+            std::lock_guard<std::mutex> lock(m_Mutex);
             auto it = m_VirtualFiles.find(path);
             if (it != m_VirtualFiles.end()) {
                 size_t len = it->second.size();
@@ -2164,7 +4167,7 @@ static uint64_t ComputeShaderHash(
         // try VFS first
         bool foundInVfs = false;
         {
-            std::lock_guard<std::mutex> lock(CORE.VirtualFSMutex);
+            std::lock_guard<std::mutex> lock(s_FileSystem.m_Mutex);
             auto it = s_FileSystem.m_VirtualFiles.find(path);
             if (it != s_FileSystem.m_VirtualFiles.end()) {
                 hash = Hash64(it->second.c_str(), it->second.size(), hash);
@@ -2781,7 +4784,9 @@ void rfxWatchShader(RfxShader shader, bool watch) {
     std::filesystem::path watchDir = shaderPath.parent_path();
     std::string targetFilename = shaderPath.filename().string();
 
-    auto callback = [impl, targetFilename](const wtr::event& e) {
+    // runs on the watcher thread, which has no current context of its own
+    CoreData* ctx = g_CurrentContext;
+    auto callback = [impl, ctx, targetFilename](const wtr::event& e) {
         if (e.path_type == wtr::event::path_type::watcher)
             return;
 
@@ -2799,8 +4804,8 @@ void rfxWatchShader(RfxShader shader, bool watch) {
         }
 
         if (shouldReload) {
-            std::lock_guard<std::mutex> lock(CORE.HotReloadMutex);
-            CORE.ShadersToReload.insert((RfxShader)impl);
+            std::lock_guard<std::mutex> lock(ctx->HotReloadMutex);
+            ctx->ShadersToReload.insert((RfxShader)impl);
         }
     };
 
@@ -2978,7 +4983,7 @@ void rfxShutdownImGui() {
 }
 
 void rfxCmdDrawImGui(RfxCommandList cmd, const RfxImGuiDrawData* data) {
-    if (!CORE.ImguiRenderer || !data || !CORE.NRISwapChain)
+    if (!CORE.ImguiRenderer || !data || (!CORE.NRISwapChain && !CORE.Headless))
         return;
 
     MustTransition(cmd);
@@ -2988,7 +4993,10 @@ void rfxCmdDrawImGui(RfxCommandList cmd, const RfxImGuiDrawData* data) {
     copy.drawListNum = data->drawListCount;
     copy.textures = (ImTextureData* const*)data->textures;
     copy.textureNum = data->textureCount;
-    CORE.NRI.CmdCopyImguiData(*cmd->nriCmd, *CORE.NRIStreamer, *CORE.ImguiRenderer, copy);
+    {
+        std::lock_guard<std::mutex> lock(CORE.StreamerMutex);
+        CORE.NRI.CmdCopyImguiData(cmd->Direct(), *CORE.NRIStreamer, *CORE.ImguiRenderer, copy);
+    }
 
     nri::Format fmt = CORE.SwapChainTextures[CORE.CurrentSwapChainTextureIndex].attachmentFormat;
 
@@ -3004,7 +5012,7 @@ void rfxCmdDrawImGui(RfxCommandList cmd, const RfxImGuiDrawData* data) {
     cmd->currentRenderingDesc.colors = cmd->activeColorAttachments.data();
     cmd->currentRenderingDesc.colorNum = 1;
 
-    CORE.NRI.CmdBeginRendering(*cmd->nriCmd, cmd->currentRenderingDesc);
+    CORE.NRI.CmdBeginRendering(cmd->Direct(), cmd->currentRenderingDesc);
     cmd->isRendering = true;
 
     nri::DrawImguiDesc did = {};
@@ -3014,11 +5022,12 @@ void rfxCmdDrawImGui(RfxCommandList cmd, const RfxImGuiDrawData* data) {
     did.hdrScale = data->hdrScale;
     did.attachmentFormat = fmt;
     did.linearColor = data->linearColor;
-    CORE.NRI.CmdDrawImgui(*cmd->nriCmd, *CORE.ImguiRenderer, did);
+    CORE.NRI.CmdDrawImgui(cmd->Direct(), *CORE.ImguiRenderer, did);
 
     cmd->currentPipeline = nullptr;
+    cmd->InvalidateState(); // imgui binds its own pipeline, buffers, pool and dynamic state
 
-    CORE.NRI.CmdSetDescriptorPool(*cmd->nriCmd, *CORE.Bindless.descriptorPool);
+    cmd->SetDescriptorPool(CORE.Bindless.descriptorPool);
 }
 
 RfxFormat rfxGetSwapChainFormat() {
@@ -3038,33 +5047,29 @@ void rfxCmdTransitionBuffer(RfxCommandList cmd, RfxBuffer buffer, RfxResourceSta
     if (!buffer)
         return;
 
-    // handle UAV->UAV barriers
-    if (state == RFX_STATE_SHADER_WRITE && buffer->currentState == RFX_STATE_SHADER_WRITE) {
-        nri::BufferBarrierDesc d = {};
+    // handle UAV->UAV barriers, only waiting on the stages the state covers. On first use Resolve handles them
+    bool isWrite = state == RFX_STATE_SHADER_WRITE || state == RFX_STATE_COMPUTE_WRITE;
+    BarrierBatcher::TrackedBuffer* tracked = cmd->barriers.Find(buffer);
+    if (isWrite && tracked && tracked->current == state) {
+        BarrierBatcher& batcher = cmd->barriers;
+        uint64_t lastUse = TouchTracked(*tracked, batcher.batch);
+
+        // a transition into this state is already pending and nothing ran since, it orders the writes as well
+        if (tracked->pendingBatch == batcher.batch)
+            return;
+
+        tracked->pendingBatch = batcher.batch;
+        tracked->pendingSlot = (uint32_t)batcher.bufferBarriers.size();
+        tracked->pendingUseBatch = lastUse;
+
+        nri::BufferBarrierDesc& d = batcher.bufferBarriers.emplace_back();
         d.buffer = buffer->buffer;
-        d.before = { nri::AccessBits::SHADER_RESOURCE_STORAGE, nri::StageBits::ALL };
+        d.before = { tracked->access, tracked->stage };
         d.after = d.before;
-        cmd->barriers.bufferBarriers.push_back(d);
         return;
     }
 
-    if (buffer->currentState == state)
-        return;
-
-    nri::AccessBits nextAccess;
-    nri::Layout nextLayout;
-    nri::StageBits nextStage;
-    GetNRIState(state, nextAccess, nextLayout, nextStage);
-
-    nri::BufferBarrierDesc desc = {};
-    desc.buffer = buffer->buffer;
-    desc.before = { buffer->currentAccess, buffer->currentStage };
-    desc.after = { nextAccess, nextStage };
-    cmd->barriers.bufferBarriers.push_back(desc);
-
-    buffer->currentState = state;
-    buffer->currentAccess = nextAccess;
-    buffer->currentStage = nextStage;
+    cmd->barriers.RequireState(buffer, state);
 }
 
 void rfxCmdTransitionTexture(RfxCommandList cmd, RfxTexture texture, RfxResourceState state) {
@@ -3168,7 +5173,7 @@ void rfxCmdDenoise(
 
     MustTransition(cmd);
 
-    cmd->barriers.Flush(*cmd->nriCmd);
+    cmd->barriers.Flush(cmd->Direct());
 
     nrd::CommonSettings common = {};
     memcpy(common.viewToClipMatrix, settings->viewToClip, sizeof(float) * 16);
@@ -3235,7 +5240,12 @@ void rfxCmdDenoise(
         nrd::Resource resource = {};
         resource.nri.texture = texture->texture;
 
-        RfxResourceState st = texture->state->Get(texture->mipOffset, texture->layerOffset);
+        // NRD transitions from whatever we report, so untouched textures are brought to a known state first
+        RfxResourceState st = cmd->barriers.GetState(texture, texture->mipOffset, texture->layerOffset);
+        if (st == BarrierBatcher::UNTRACKED) {
+            st = RFX_STATE_SHADER_READ;
+            cmd->barriers.RequireState(texture, st);
+        }
         nri::AccessBits acc;
         nri::Layout lay;
         nri::StageBits stg;
@@ -3247,8 +5257,10 @@ void rfxCmdDenoise(
         snapshot.SetResource(nrdType, resource);
     }
 
-    denoiser->instance.Denoise(&denoiser->identifier, 1, *cmd->nriCmd, snapshot);
-    CORE.NRI.CmdSetDescriptorPool(*cmd->nriCmd, *CORE.Bindless.descriptorPool);
+    cmd->FlushBarriers();
+    denoiser->instance.Denoise(&denoiser->identifier, 1, cmd->Direct(), snapshot);
+    cmd->InvalidateState();
+    cmd->SetDescriptorPool(CORE.Bindless.descriptorPool);
     cmd->currentPipeline = nullptr;
 
     // sync state after NRD messed with it
@@ -3262,25 +5274,21 @@ void rfxCmdDenoise(
             else if (res.state.layout == nri::Layout::SHADER_RESOURCE_STORAGE)
                 newState = RFX_STATE_SHADER_WRITE;
 
-            for (uint32_t l = 0; l < texture->layerNum; ++l) {
-                for (uint32_t m = 0; m < texture->mipNum; ++m) {
-                    texture->state->Set(texture->mipOffset + m, texture->layerOffset + l, newState);
-                }
-            }
+            cmd->barriers.Assume(texture, newState);
         }
     }
 }
 
 void rfxCmdBeginEvent(RfxCommandList cmd, const char* name) {
-    CORE.NRI.CmdBeginAnnotation(*cmd->nriCmd, name, 0);
+    CORE.NRI.CmdBeginAnnotation(cmd->Direct(), name, 0);
 }
 
 void rfxCmdEndEvent(RfxCommandList cmd) {
-    CORE.NRI.CmdEndAnnotation(*cmd->nriCmd);
+    CORE.NRI.CmdEndAnnotation(cmd->Direct());
 }
 
 void rfxCmdMarker(RfxCommandList cmd, const char* name) {
-    CORE.NRI.CmdAnnotation(*cmd->nriCmd, name, 0);
+    CORE.NRI.CmdAnnotation(cmd->Direct(), name, 0);
 }
 
 void rfxBeginMarker(const char* name) {
@@ -3314,7 +5322,7 @@ void rfxCmdBeginProfile(RfxCommandList cmd, const char* name) {
     qf.profileStack.push_back((int)qf.profileRegions.size());
     qf.profileRegions.push_back(region);
 
-    CORE.NRI.CmdEndQuery(*cmd->nriCmd, *CORE.TimestampPool, globalIdx);
+    CORE.NRI.CmdEndQuery(cmd->Direct(), *CORE.TimestampPool, globalIdx);
 }
 
 void rfxCmdEndProfile(RfxCommandList cmd) {
@@ -3334,7 +5342,7 @@ void rfxCmdEndProfile(RfxCommandList cmd) {
 
     qf.profileRegions[regionIdx].endIndex = qIdx;
 
-    CORE.NRI.CmdEndQuery(*cmd->nriCmd, *CORE.TimestampPool, globalIdx);
+    CORE.NRI.CmdEndQuery(cmd->Direct(), *CORE.TimestampPool, globalIdx);
 }
 
 uint32_t rfxGetGpuTimestamps(RfxGpuTimestamp* outTimestamps, uint32_t maxCount) {
@@ -3346,6 +5354,11 @@ uint32_t rfxGetGpuTimestamps(RfxGpuTimestamp* outTimestamps, uint32_t maxCount)
     return count;
 }
 
+void rfxGetFrameStats(RfxFrameStats* outStats) {
+    if (outStats)
+        *outStats = CORE.LastFrameStats;
+}
+
 RfxAccelerationStructure rfxCreateAccelerationStructure(const RfxAccelerationStructureDesc* desc) {
     RfxAccelerationStructureImpl* impl = RfxNew<RfxAccelerationStructureImpl>();
     bool isTLAS = (desc->type == RFX_AS_TOP_LEVEL);
@@ -3460,7 +5473,7 @@ void rfxCmdUploadInstances(RfxCommandList cmd, RfxBuffer dstBuffer, const RfxIns
     }
 
     rfxCmdTransitionBuffer(cmd, dstBuffer, RFX_STATE_COPY_DST);
-    cmd->barriers.Flush(*cmd->nriCmd);
+    cmd->barriers.Flush(cmd->Direct());
 
     nri::DataSize chunk = { nriInstances.data(), instanceCount * sizeof(nri::TopLevelInstance) };
     nri::StreamBufferDataDesc sbd = {};
@@ -3468,8 +5481,11 @@ void rfxCmdUploadInstances(RfxCommandList cmd, RfxBuffer dstBuffer, const RfxIns
     sbd.dstOffset = 0;
     sbd.dataChunks = &chunk;
     sbd.dataChunkNum = 1;
-    CORE.NRI.StreamBufferData(*CORE.NRIStreamer, sbd);
-    CORE.NRI.CmdCopyStreamedData(*cmd->nriCmd, *CORE.NRIStreamer);
+    {
+        std::lock_guard<std::mutex> lock(CORE.StreamerMutex);
+        CORE.NRI.StreamBufferData(*CORE.NRIListStreamer, sbd);
+        CopyListStreamedDataLocked(cmd->Direct());
+    }
 
     nri::BufferBarrierDesc bbd = {};
     bbd.buffer = dstBuffer->buffer;
@@ -3478,10 +5494,11 @@ void rfxCmdUploadInstances(RfxCommandList cmd, RfxBuffer dstBuffer, const RfxIns
     nri::BarrierDesc bd = {};
     bd.buffers = &bbd;
     bd.bufferNum = 1;
-    CORE.NRI.CmdBarrier(*cmd->nriCmd, bd);
+    CORE.NRI.CmdBarrier(cmd->Direct(), bd);
 
-    dstBuffer->currentAccess = nri::AccessBits::SHADER_RESOURCE;
-    dstBuffer->currentStage = nri::StageBits::ACCELERATION_STRUCTURE;
+    BarrierBatcher::TrackedBuffer* tracked = cmd->barriers.Find(dstBuffer);
+    tracked->access = nri::AccessBits::SHADER_RESOURCE;
+    tracked->stage = nri::StageBits::ACCELERATION_STRUCTURE;
 }
 
 void rfxCmdBuildAccelerationStructure(RfxCommandList cmd, RfxAccelerationStructure dst, RfxBuffer scratch, RfxBuffer instanceBuffer) {
@@ -3507,14 +5524,14 @@ void rfxCmdBuildAccelerationStructure(RfxCommandList cmd, RfxAccelerationStructu
         build.geometries = dstImpl->geometries.data();
         build.geometryNum = (uint32_t)dstImpl->geometries.size();
         build.scratchBuffer = scratch->buffer;
-        CORE.NRI.CmdBuildBottomLevelAccelerationStructures(*cmd->nriCmd, &build, 1);
+        CORE.NRI.CmdBuildBottomLevelAccelerationStructures(cmd->Direct(), &build, 1);
     } else {
         nri::BuildTopLevelAccelerationStructureDesc build = {};
         build.dst = dstImpl->as;
         build.instanceBuffer = instanceBuffer ? instanceBuffer->buffer : nullptr;
         build.instanceNum = dstImpl->nriDesc.geometryOrInstanceNum;
         build.scratchBuffer = scratch->buffer;
-        CORE.NRI.CmdBuildTopLevelAccelerationStructures(*cmd->nriCmd, &build, 1);
+        CORE.NRI.CmdBuildTopLevelAccelerationStructures(cmd->Direct(), &build, 1);
     }
 
     // TODO: build->trace for now
@@ -3654,8 +5671,11 @@ RfxShaderBindingTable rfxCreateShaderBindingTable(RfxPipeline pipeline) {
     sbd.dstBuffer = impl->buffer;
     sbd.dataChunks = &chunk;
     sbd.dataChunkNum = 1;
-    CORE.NRI.StreamBufferData(*CORE.NRIStreamer, sbd);
-    CORE.NRI.CmdCopyStreamedData(*cmd, *CORE.NRIStreamer);
+    {
+        std::lock_guard<std::mutex> lock(CORE.StreamerMutex);
+        CORE.NRI.StreamBufferData(*CORE.NRIListStreamer, sbd);
+        CopyListStreamedDataLocked(*cmd);
+    }
 
     nri::BufferBarrierDesc post = pre;
     post.before = pre.after;
@@ -3709,14 +5729,14 @@ void rfxCmdTraceRays(RfxCommandList cmd, const RfxTraceRaysDesc* desc, uint32_t
     d.y = height;
     d.z = depth;
 
-    CORE.NRI.CmdDispatchRays(*cmd->nriCmd, d);
+    CORE.NRI.CmdDispatchRays(cmd->Direct(), d);
 }
 
 void rfxCmdDispatchRaysIndirect(RfxCommandList cmd, RfxBuffer argsBuffer, uint64_t argsOffset) {
     MustTransition(cmd);
     rfxCmdTransitionBuffer(cmd, argsBuffer, RFX_STATE_INDIRECT_ARGUMENT);
     cmd->FlushBarriers();
-    CORE.NRI.CmdDispatchRaysIndirect(*cmd->nriCmd, *argsBuffer->buffer, argsOffset);
+    CORE.NRI.CmdDispatchRaysIndirect(cmd->Direct(), *argsBuffer->buffer, argsOffset);
 }
 
 RfxMicromap rfxCreateMicromap(const RfxMicromapDesc* desc) {
@@ -3798,7 +5818,7 @@ void rfxCmdBuildMicromaps(RfxCommandList cmd, const RfxBuildMicromapDesc* desc)
     buildDesc.scratchBuffer = desc->scratch ? desc->scratch->buffer : nullptr;
     buildDesc.scratchOffset = desc->scratchOffset;
 
-    CORE.NRI.CmdBuildMicromaps(*cmd->nriCmd, &buildDesc, 1);
+    CORE.NRI.CmdBuildMicromaps(cmd->Direct(), &buildDesc, 1);
 
     // transition dst to read
     {
@@ -3871,7 +5891,7 @@ void rfxCmdUpscale(RfxCommandList cmd, RfxUpscaler upscaler, const RfxUpscaleDes
     SetupUpscalerResource(cmd, desc->input, dud.input, false);
     SetupUpscalerResource(cmd, desc->output, dud.output, true);
 
-    cmd->barriers.Flush(*cmd->nriCmd);
+    cmd->barriers.Flush(cmd->Direct());
 
     // guides
     if (upscaler->type == RFX_UPSCALER_DLRR) {
@@ -3892,7 +5912,7 @@ void rfxCmdUpscale(RfxCommandList cmd, RfxUpscaler upscaler, const RfxUpscaleDes
         SetupUpscalerResource(cmd, desc->reactive, dud.guides.upscaler.reactive, false);
     }
 
-    cmd->barriers.Flush(*cmd->nriCmd);
+    cmd->barriers.Flush(cmd->Direct());
 
     // params
     dud.currentResolution = { (nri::Dim_t)desc->input->width, (nri::Dim_t)desc->input->height };
@@ -3915,10 +5935,11 @@ void rfxCmdUpscale(RfxCommandList cmd, RfxUpscaler upscaler, const RfxUpscaleDes
     }
 
     // dispatch
-    CORE.NRI.CmdDispatchUpscale(*cmd->nriCmd, *upscaler->upscaler, dud);
+    CORE.NRI.CmdDispatchUpscale(cmd->Direct(), *upscaler->upscaler, dud);
 
     // restore state
-    CORE.NRI.CmdSetDescriptorPool(*cmd->nriCmd, *CORE.Bindless.descriptorPool);
+    cmd->InvalidateState();
+    cmd->SetDescriptorPool(CORE.Bindless.descriptorPool);
     cmd->currentPipeline = nullptr;
 }
 
@@ -3948,9 +5969,8 @@ void rfxGetUpscalerProps(RfxUpscaler upscaler, RfxUpscalerProps* outProps) {
 }
 
 void rfxCmdSetStencilReference(RfxCommandList cmd, uint8_t frontRef, uint8_t backRef) {
-    if (cmd->isRendering) {
-        CORE.NRI.CmdSetStencilReference(*cmd->nriCmd, frontRef, backRef);
-    }
+    if (cmd->isRendering)
+        cmd->SetStencilReference(frontRef, backRef);
 }
 
 void rfxCmdSetViewports(RfxCommandList cmd, float* viewports, uint32_t count) {
@@ -3969,7 +5989,7 @@ void rfxCmdSetViewports(RfxCommandList cmd, float* viewports, uint32_t count) {
     }
 
     cmd->currentViewport = vp[0];
-    CORE.NRI.CmdSetViewports(*cmd->nriCmd, vp, count);
+    cmd->SetViewports(vp, count);
 }
 
 void rfxCmdUploadTexture(RfxCommandList cmd, RfxTexture dst, const void* data, uint32_t mip, uint32_t layer) {
@@ -3995,21 +6015,212 @@ void rfxCmdUploadTexture(RfxCommandList cmd, RfxTexture dst, const void* data, u
     region.depth = 1;
     region.planes = nri::PlaneBits::ALL;
 
-    RfxResourceState restoreState = dst->state->Get(region.mipOffset, region.layerOffset);
+    // go back to the state this list left it in, or to shader reads if it hasn't used it yet
+    RfxResourceState restoreState = cmd->barriers.GetState(dst, region.mipOffset, region.layerOffset);
+    if (restoreState == BarrierBatcher::UNTRACKED)
+        restoreState = RFX_STATE_SHADER_READ;
 
     UploadToResource(cmd, nullptr, 0, dst->texture, &region, data, size, rowPitch, slicePitch, restoreState, nullptr, dst);
 }
 
-void rfxCmdSetDepthBias(RfxCommandList cmd, float constant, float clamp, float slope) {
-    if (cmd->isRendering) {
-        nri::DepthBiasDesc dbd = { constant, clamp, slope };
-        CORE.NRI.CmdSetDepthBias(*cmd->nriCmd, dbd);
+// each group turns a 64x64 tile of the source mip into up to 6 mips: the first straight from bilinear taps, the second
+// from each thread's own 2x2 results, the rest through groupshared memory
+static const char* s_MipGenShaderSource = R"(
+#include "rafx.slang"
+
+struct MipGenPush {
+    uint srcId; // SRV of the source mip
+    uint mipCount;
+    uint2 srcSize;
+    uint dst0;  // UAVs of the next mipCount mips
+    uint dst1;
+    uint dst2;
+    uint dst3;
+    uint dst4;
+    uint dst5;
+};
+RFX_PUSH_CONSTANTS(MipGenPush, g_Push);
+
+groupshared float4 g_Tile[16][16];
+
+void Store(uint id, uint level, uint2 p, float4 c) {
+    uint2 size = max(g_Push.srcSize >> level, uint2(1, 1));
+    if (all(p < size))
+        GetRWTexture(id)[p] = c;
+}
+
+[shader("compute")]
+[numthreads(16, 16, 1)]
+void main(uint3 gid : SV_GroupID, uint3 tid : SV_GroupThreadID) {
+    Texture2D src = GetTexture(g_Push.srcId);
+    float2 invSrcSize = 1.0 / float2(g_Push.srcSize);
+
+    float4 sum = 0;
+    uint2 base = gid.xy * 32 + tid.xy * 2;
+    [unroll]
+    for (uint i = 0; i < 4; ++i) {
+        uint2 p = base + uint2(i & 1, i >> 1);
+        float4 c = src.SampleLevel(GetSamplerLinearClamp(), (float2(p) * 2.0 + 1.0) * invSrcSize, 0);
+        Store(g_Push.dst0, 1, p, c);
+        sum += c;
+    }
+    if (g_Push.mipCount < 2)
+        return;
+
+    float4 c = sum * 0.25;
+    Store(g_Push.dst1, 2, gid.xy * 16 + tid.xy, c);
+    g_Tile[tid.y][tid.x] = c;
+
+    uint dst[4] = { g_Push.dst2, g_Push.dst3, g_Push.dst4, g_Push.dst5 };
+    uint size = 8;
+    for (uint m = 0; m < 4 && m + 2 < g_Push.mipCount; ++m, size >>= 1) {
+        GroupMemoryBarrierWithGroupSync();
+        bool active = all(tid.xy < size);
+        if (active) {
+            uint2 q = tid.xy * 2;
+            c = (g_Tile[q.y][q.x] + g_Tile[q.y][q.x + 1] + g_Tile[q.y + 1][q.x] + g_Tile[q.y + 1][q.x + 1]) * 0.25;
+        }
+        GroupMemoryBarrierWithGroupSync();
+        if (active) {
+            g_Tile[tid.y][tid.x] = c;
+            Store(dst[m], m + 3, gid.xy * size + tid.xy, c);
+        }
+    }
+}
+)";
+
+static RfxPipeline GetMipGenPipeline() {
+    std::lock_guard<std::mutex> lock(CORE.MipGenMutex);
+    if (!CORE.MipGenPipeline) {
+        CORE.MipGenShader = rfxCompileShaderMem(s_MipGenShaderSource, nullptr, 0, nullptr, 0);
+        RFX_ASSERT(CORE.MipGenShader && "mip generation shader failed to compile");
+
+        RfxComputePipelineDesc desc = {};
+        desc.shader = CORE.MipGenShader;
+        CORE.MipGenPipeline = rfxCreateComputePipeline(&desc);
+    }
+    return CORE.MipGenPipeline;
+}
+
+void rfxCmdGenerateMips(RfxCommandList cmd, RfxTexture texture) {
+    if (!texture || texture->mipNum < 2)
+        return;
+    RFX_ASSERT(!texture->isView && "generate mips on the texture itself");
+    RFX_ASSERT(texture->descriptor && texture->descriptorUAV && "texture needs shader resource & storage usage");
+
+    // the shader downsamples 2D tiles through groupshared memory
+    bool is2D = CORE.NRI.GetTextureDesc(*texture->texture).depth == 1;
+    RFX_ASSERT(is2D && "generate mips only handles 2D textures");
+    if (!is2D)
+        return;
+
+    MustTransition(cmd);
+
+    uint32_t mipNum = texture->mipNum;
+    if (texture->mipViews.empty()) {
+        texture->mipViews.resize(mipNum * texture->layerNum);
+        for (uint32_t layer = 0; layer < texture->layerNum; ++layer) {
+            for (uint32_t mip = 0; mip < mipNum; ++mip)
+                texture->mipViews[layer * mipNum + mip] = rfxCreateTextureView(texture, RFX_FORMAT_UNKNOWN, mip, 1, layer, 1);
+        }
+    }
+
+    RfxPipelineImpl* prevPipeline = cmd->currentPipeline;
+    rfxCmdBindPipeline(cmd, GetMipGenPipeline());
+
+    // up to 6 mips per dispatch, one dispatch per layer
+    for (uint32_t layer = 0; layer < texture->layerNum; ++layer) {
+        RfxTexture* views = &texture->mipViews[layer * mipNum];
+        for (uint32_t mip = 0; mip + 1 < mipNum; mip += 6) {
+            uint32_t count = std::min(6u, mipNum - 1 - mip);
+
+            struct {
+                uint32_t srcId;
+                uint32_t mipCount;
+                uint32_t srcSize[2];
+                uint32_t dst[6];
+            } push = {};
+            push.srcId = views[mip]->bindlessIndex;
+            push.mipCount = count;
+            push.srcSize[0] = views[mip]->width;
+            push.srcSize[1] = views[mip]->height;
+
+            rfxCmdTransitionTexture(cmd, views[mip], RFX_STATE_SHADER_READ);
+            for (uint32_t i = 0; i < count; ++i) {
+                push.dst[i] = views[mip + 1 + i]->bindlessIndex;
+                rfxCmdTransitionTexture(cmd, views[mip + 1 + i], RFX_STATE_SHADER_WRITE);
+            }
+
+            rfxCmdPushConstants(cmd, &push, sizeof(push));
+            uint32_t w = views[mip + 1]->width, h = views[mip + 1]->height;
+            rfxCmdDispatch(cmd, (w + 31) / 32, (h + 31) / 32, 1);
+        }
+    }
+
+    rfxCmdTransitionTexture(cmd, texture, RFX_STATE_SHADER_READ);
+
+    // hand the list back with the caller's pipeline, the push constants went to ours
+    cmd->InvalidateState();
+    cmd->currentPipeline = prevPipeline;
+    if (prevPipeline)
+        cmd->SetPipeline(prevPipeline);
+}
+
+void rfxCmdUpdateBuffer(RfxCommandList cmd, RfxBuffer buffer, uint64_t offset, const void* data, uint64_t size) {
+    RfxBufferUpdate update = { offset, data, size };
+    rfxCmdUpdateBufferScatter(cmd, buffer, &update, 1);
+}
+
+void rfxCmdUpdateBufferScatter(RfxCommandList cmd, RfxBuffer buffer, const RfxBufferUpdate* updates, uint32_t updateCount) {
+    if (!buffer || !updates || updateCount == 0)
+        return;
+
+    MustTransition(cmd);
+
+    // go back to the state this list left it in, or to shader reads if it hasn't used it yet
+    BarrierBatcher::TrackedBuffer* tracked = cmd->barriers.Find(buffer);
+    RfxResourceState restoreState = tracked ? tracked->current : RFX_STATE_SHADER_READ;
+
+    std::lock_guard<std::mutex> lock(CORE.StreamerMutex);
+
+    // one request per run of back-to-back updates, with the run's pieces as its data chunks
+    RfxVector<nri::DataSize> chunks;
+    for (uint32_t i = 0; i < updateCount;) {
+        uint64_t dstOffset = updates[i].offset;
+        uint64_t end = dstOffset;
+        chunks.clear();
+        for (; i < updateCount && updates[i].offset == end; ++i) {
+            RFX_ASSERT(updates[i].offset + updates[i].size <= buffer->size);
+            chunks.push_back({ updates[i].data, updates[i].size });
+            end += updates[i].size;
+        }
+
+        nri::StreamBufferDataDesc sbd = {};
+        sbd.dataChunks = chunks.data();
+        sbd.dataChunkNum = (uint32_t)chunks.size();
+        sbd.dstBuffer = buffer->buffer;
+        sbd.dstOffset = dstOffset;
+        sbd.placementAlignment = 1;
+        CORE.NRI.StreamBufferData(*CORE.NRIListStreamer, sbd);
     }
+
+    cmd->barriers.RequireState(buffer, RFX_STATE_COPY_DST);
+    cmd->FlushBarriers();
+    CopyListStreamedDataLocked(cmd->Direct());
+    cmd->barriers.RequireState(buffer, restoreState);
+}
+
+void rfxCmdSetDepthBias(RfxCommandList cmd, float constant, float clamp, float slope) {
+    if (!cmd->isRendering)
+        return;
+
+    nri::DepthBiasDesc dbd = { constant, clamp, slope };
+    cmd->SetDepthBias(dbd);
 }
 
 void rfxCmdSetDepthBounds(RfxCommandList cmd, float minBound, float maxBound) {
     if (cmd->isRendering) {
-        CORE.NRI.CmdSetDepthBounds(*cmd->nriCmd, minBound, maxBound);
+        CORE.NRI.CmdSetDepthBounds(cmd->Direct(), minBound, maxBound);
     }
 }
 
@@ -4021,7 +6232,7 @@ void rfxCmdSetShadingRate(
         srd.shadingRate = ToNRIShadingRate(rate);
         srd.primitiveCombiner = ToNRIShadingRateCombiner(primitiveCombiner);
         srd.attachmentCombiner = ToNRIShadingRateCombiner(attachmentCombiner);
-        CORE.NRI.CmdSetShadingRate(*cmd->nriCmd, srd);
+        CORE.NRI.CmdSetShadingRate(cmd->Direct(), srd);
     }
 }
 
@@ -4036,14 +6247,17 @@ RfxCommandList rfxCreateCommandList(RfxQueueType queueType) {
     uint32_t frames = GetQueuedFrameNum();
     impl->allocators.resize(frames);
     impl->buffers.resize(frames);
+    impl->patchBuffers.resize(frames);
 
     for (uint32_t i = 0; i < frames; ++i) {
         NRI_CHECK(CORE.NRI.CreateCommandAllocator(*queue, impl->allocators[i]));
         NRI_CHECK(CORE.NRI.CreateCommandBuffer(*impl->allocators[i], impl->buffers[i]));
+        NRI_CHECK(CORE.NRI.CreateCommandBuffer(*impl->allocators[i], impl->patchBuffers[i]));
     }
 
     // will be updated in Begin
     impl->nriCmd = impl->buffers[0];
+    impl->patchCmd = impl->patchBuffers[0];
 
     impl->ResetCache();
     return impl;
@@ -4054,11 +6268,14 @@ void rfxDestroyCommandList(RfxCommandList cmd) {
         return;
 
     RfxVector<nri::CommandBuffer*> buffers = std::move(cmd->buffers);
+    RfxVector<nri::CommandBuffer*> patchBuffers = std::move(cmd->patchBuffers);
     RfxVector<nri::CommandAllocator*> allocators = std::move(cmd->allocators);
 
     rfxDeferDestruction([=]() {
         for (auto* cb : buffers)
             CORE.NRI.DestroyCommandBuffer(cb);
+        for (auto* cb : patchBuffers)
+            CORE.NRI.DestroyCommandBuffer(cb);
         for (auto* ca : allocators)
             CORE.NRI.DestroyCommandAllocator(ca);
     });
@@ -4081,18 +6298,97 @@ void rfxBeginCommandList(RfxCommandList cmd) {
     nri::CommandBuffer* buffer = cmd->buffers[frameSlot];
 
     cmd->nriCmd = buffer;
+    cmd->patchCmd = cmd->patchBuffers[frameSlot];
 
     CORE.NRI.ResetCommandAllocator(*allocator);
     CORE.NRI.BeginCommandBuffer(*buffer, CORE.Bindless.descriptorPool);
 
     cmd->ResetCache();
+    cmd->shadow.descriptorPool = CORE.Bindless.descriptorPool;
 }
 
 void rfxEndCommandList(RfxCommandList cmd) {
     if (!cmd)
         return;
     cmd->FlushBarriers();
-    CORE.NRI.EndCommandBuffer(*cmd->nriCmd);
+    CORE.NRI.EndCommandBuffer(cmd->Direct());
+
+    CORE.ElidedStateCalls += cmd->elidedCalls;
+    cmd->elidedCalls = 0;
+    CORE.RenderPassRestarts += cmd->passRestarts;
+    cmd->passRestarts = 0;
+}
+
+RfxBundle rfxCreateBundle() {
+    RfxBundleImpl* impl = RfxNew<RfxBundleImpl>();
+    impl->recorder.nriCmd = nullptr;
+    impl->recorder.queueType = RFX_QUEUE_GRAPHICS;
+    impl->recorder.isSecondary = true;
+    impl->recorder.deferred = true;
+    impl->recorder.recordingBundle = impl;
+    return impl;
+}
+
+void rfxDestroyBundle(RfxBundle bundle) {
+    if (bundle)
+        RfxDelete(bundle);
+}
+
+RfxCommandList rfxBeginBundle(RfxBundle bundle) {
+    RfxCommandListImpl& rec = bundle->recorder;
+    rec.ResetCache();
+    rec.isRendering = true; // bundles only ever run inside a pass
+    bundle->stream.Reset();
+    bundle->bufferRequirements.clear();
+    return &rec;
+}
+
+void rfxEndBundle(RfxBundle bundle) {
+    bundle->stream.bytes.swap(bundle->recorder.stream.bytes);
+    bundle->stream.commandNum = bundle->recorder.stream.commandNum;
+    bundle->recorder.stream.Reset();
+    bundle->recorder.elidedCalls = 0;
+}
+
+void rfxCmdExecuteBundle(RfxCommandList cmd, RfxBundle bundle) {
+    if (!bundle || bundle->stream.Empty())
+        return;
+
+    for (const RfxBundleImpl::BufferRequirement& r : bundle->bufferRequirements)
+        cmd->barriers.RequireState(r.buffer, r.state);
+    cmd->FlushBarriers();
+
+    if (cmd->deferred) {
+        cmd->stream.Write(bundle->stream.bytes.data(), bundle->stream.bytes.size());
+        cmd->stream.commandNum += bundle->stream.commandNum;
+    } else {
+        ReplayCommands(*cmd->nriCmd, bundle->stream.bytes.data(), bundle->stream.bytes.size());
+    }
+
+    // the bundle left its own pipeline, buffers and dynamic state bound
+    cmd->InvalidateState();
+    cmd->currentPipeline = nullptr;
+}
+
+void rfxSetCommandListDeferred(RfxCommandList cmd, bool deferred) {
+    if (!cmd || cmd->deferred == deferred)
+        return;
+    cmd->Direct(); // keep ordering with what was already encoded
+    cmd->deferred = deferred;
+}
+
+void rfxSetCommandListBarrierHoisting(RfxCommandList cmd, bool enabled) {
+    if (cmd)
+        cmd->hoistBarriers = enabled;
+}
+
+void rfxQueueCommandList(RfxCommandList cmd) {
+    if (!cmd)
+        return;
+    RFX_ASSERT(cmd->isSecondary && cmd->queueType == RFX_QUEUE_GRAPHICS && "only secondary graphics lists can be queued");
+
+    std::lock_guard<std::mutex> lock(CORE.QueuedListsMutex);
+    CORE.QueuedFrames[CORE.FrameIndex % GetQueuedFrameNum()].queuedLists.push_back(cmd);
 }
 
 void rfxSubmitCommandListAsync(
@@ -4122,14 +6418,26 @@ void rfxSubmitCommandListAsync(
         queue = CORE.NRIGraphicsQueue;
     }
 
+    nri::CommandBuffer* commandBuffers[2] = {};
     nri::QueueSubmitDesc submit = {};
     if (cmd) {
-        submit.commandBuffers = &cmd->nriCmd;
-        submit.commandBufferNum = 1;
+        // patch-up barriers against everything submitted so far, right before the list
+        CORE.NRI.BeginCommandBuffer(*cmd->patchCmd, nullptr);
+        uint64_t uploadValue = cmd->barriers.Resolve(*cmd->patchCmd);
+        CORE.NRI.EndCommandBuffer(*cmd->patchCmd);
+
+        nri::FenceSubmitDesc uploadWait = {};
+        if (GetUploadWait(uploadValue, uploadWait))
+            waits.push_back(uploadWait);
+
+        commandBuffers[0] = cmd->patchCmd;
+        commandBuffers[1] = cmd->nriCmd;
+        submit.commandBuffers = commandBuffers;
+        submit.commandBufferNum = 2;
     }
-    if (waitCount > 0) {
+    if (!waits.empty()) {
         submit.waitFences = waits.data();
-        submit.waitFenceNum = waitCount;
+        submit.waitFenceNum = (uint32_t)waits.size();
     }
     if (signalCount > 0) {
         submit.signalFences = signals.data();
@@ -4154,7 +6462,7 @@ void rfxCmdClearStorageBuffer(RfxCommandList cmd, RfxBuffer buffer, uint32_t val
     clear.descriptorIndex = buffer->bindlessIndex;
     clear.value.ui = { value, value, value, value };
 
-    CORE.NRI.CmdClearStorage(*cmd->nriCmd, clear);
+    CORE.NRI.CmdClearStorage(cmd->Direct(), clear);
 }
 
 void rfxCmdClearStorageTexture(RfxCommandList cmd, RfxTexture texture, RfxColor value) {
@@ -4172,7 +6480,7 @@ void rfxCmdClearStorageTexture(RfxCommandList cmd, RfxTexture texture, RfxColor
     clear.descriptorIndex = texture->bindlessIndex;
     clear.value.f = { value.r, value.g, value.b, value.a };
 
-    CORE.NRI.CmdClearStorage(*cmd->nriCmd, clear);
+    CORE.NRI.CmdClearStorage(cmd->Direct(), clear);
 }
 
 RfxFence rfxCreateFence(uint64_t initialValue) {
@@ -4201,6 +6509,246 @@ uint64_t rfxGetFenceValue(RfxFence fence) {
     return fence ? CORE.NRI.GetFenceValue(*fence->fence) : 0;
 }
 
+//
+// Copy-queue uploads
+//
+
+#define RFX_UPLOAD_CHUNK_SIZE (4ull * 1024 * 1024)
+
+// the batch uploads are recorded into, reusing one the copy queue is done with. UploadMutex must be held
+static UploadBatch* GetRecordingUploadBatchLocked() {
+    if (CORE.UploadRecording)
+        return CORE.UploadRecording;
+
+    uint64_t completed = CORE.NRI.GetFenceValue(*CORE.UploadFence->fence);
+    for (size_t i = 0; i < CORE.UploadBatches.size(); ++i) {
+        UploadBatch* batch = CORE.UploadBatches[i];
+        if (batch->value > completed)
+            continue;
+
+        CORE.UploadBatches[i] = CORE.UploadBatches.back();
+        CORE.UploadBatches.pop_back();
+        batch->value = 0;
+        batch->chunk = 0;
+        batch->chunkUsed = 0;
+        CORE.UploadRecording = batch;
+        return batch;
+    }
+
+    UploadBatch* batch = RfxNew<UploadBatch>();
+    NRI_CHECK(CORE.NRI.CreateCommandAllocator(*CORE.NRICopyQueue, batch->allocator));
+    NRI_CHECK(CORE.NRI.CreateCommandBuffer(*batch->allocator, batch->commandBuffer));
+    CORE.UploadRecording = batch;
+    return batch;
+}
+
+// reserves staging memory in the batch, filling its chunks in order. Requests larger than a chunk get their own
+static uint8_t* AllocUploadStaging(UploadBatch* batch, uint64_t size, uint64_t alignment, uint32_t& chunk, uint64_t& offset) {
+    for (; batch->chunk < batch->staging.size(); batch->chunk++, batch->chunkUsed = 0) {
+        UploadBatch::StagingChunk& c = batch->staging[batch->chunk];
+        uint64_t aligned = (batch->chunkUsed + alignment - 1) & ~(alignment - 1);
+        if (aligned + size <= c.size) {
+            chunk = batch->chunk;
+            offset = aligned;
+            batch->chunkUsed = aligned + size;
+            return c.data + aligned;
+        }
+    }
+
+    // only ever a copy source, so a plain NRI buffer without views or a bindless slot
+    UploadBatch::StagingChunk& c = batch->staging.emplace_back();
+    c.size = std::max<uint64_t>(size, RFX_UPLOAD_CHUNK_SIZE);
+
+    nri::BufferDesc bd = {};
+    bd.size = c.size;
+    NRI_CHECK(CORE.NRI.CreateBuffer(*CORE.NRIDevice, bd, c.buffer));
+    AllocateAndBind<nri::Buffer, nri::BindBufferMemoryDesc>(
+        c.buffer, nri::MemoryLocation::HOST_UPLOAD, c.memory,
+        [&](nri::Buffer& b, nri::MemoryLocation l, nri::MemoryDesc& d) { CORE.NRI.GetBufferMemoryDesc(b, l, d); },
+        [&](const nri::BindBufferMemoryDesc* d, uint32_t n) { return CORE.NRI.BindBufferMemory(d, n); }
+    );
+    c.data = (uint8_t*)CORE.NRI.MapBuffer(*c.buffer, 0, c.size);
+
+    chunk = batch->chunk = (uint32_t)batch->staging.size() - 1;
+    offset = 0;
+    batch->chunkUsed = size;
+    return c.data;
+}
+
+void rfxUploadBuffer(RfxBuffer dst, uint64_t dstOffset, const void* data, uint64_t size) {
+    if (!dst || !data || size == 0)
+        return;
+    RFX_ASSERT(dstOffset + size <= dst->size);
+
+    std::lock_guard<std::mutex> lock(CORE.UploadMutex);
+    UploadBatch* batch = GetRecordingUploadBatchLocked();
+
+    UploadBatch::BufferCopy copy = {};
+    copy.dst = dst;
+    copy.dstOffset = dstOffset;
+    copy.size = size;
+    memcpy(AllocUploadStaging(batch, size, 16, copy.chunk, copy.srcOffset), data, size);
+    batch->bufferCopies.push_back(copy);
+}
+
+void rfxUploadTexture(RfxTexture dst, const void* data, uint32_t mip, uint32_t layer) {
+    if (!dst || !data)
+        return;
+    RFX_ASSERT(dst->state && "texture has no tracked state");
+
+    const nri::FormatProps* props = nri::nriGetFormatProps(dst->format);
+    uint32_t w = std::max(1u, dst->width >> mip);
+    uint32_t h = std::max(1u, dst->height >> mip);
+    uint32_t rowPitch = (w + props->blockWidth - 1) / props->blockWidth * props->stride;
+    uint32_t rows = (h + props->blockHeight - 1) / props->blockHeight;
+
+    // copies out of a buffer want 256 byte rows & 512 byte offsets
+    uint32_t alignedRowPitch = (rowPitch + 255) & ~255;
+
+    UploadBatch::TextureCopy copy = {};
+    copy.dst = dst;
+    copy.region.mipOffset = (nri::Dim_t)(dst->mipOffset + mip);
+    copy.region.layerOffset = (nri::Dim_t)(dst->layerOffset + layer);
+    copy.region.width = (nri::Dim_t)w;
+    copy.region.height = (nri::Dim_t)h;
+    copy.region.depth = 1;
+    copy.region.planes = nri::PlaneBits::ALL;
+    copy.layout.rowPitch = alignedRowPitch;
+    copy.layout.slicePitch = alignedRowPitch * rows;
+
+    std::lock_guard<std::mutex> lock(CORE.UploadMutex);
+    UploadBatch* batch = GetRecordingUploadBatchLocked();
+
+    uint64_t offset;
+    uint8_t* staging = AllocUploadStaging(batch, copy.layout.slicePitch, 512, copy.chunk, offset);
+    copy.layout.offset = offset;
+    for (uint32_t row = 0; row < rows; ++row)
+        memcpy(staging + (uint64_t)row * alignedRowPitch, (const uint8_t*)data + (uint64_t)row * rowPitch, rowPitch);
+    batch->textureCopies.push_back(copy);
+}
+
+uint64_t rfxSubmitUploads() {
+    std::lock_guard<std::mutex> lock(CORE.UploadMutex);
+    UploadBatch* batch = CORE.UploadRecording;
+    if (!batch || (batch->bufferCopies.empty() && batch->textureCopies.empty()))
+        return 0;
+
+    // textures go to copy dst. Copy queues can only leave undefined/common, so anything the frames left in another
+    // layout is transitioned by a graphics queue submission the copies wait for, behind the frames that used it.
+    // Buffers have no layout and need no barrier at all
+    RfxVector<nri::TextureBarrierDesc> copyBarriers;
+    RfxVector<nri::TextureBarrierDesc> graphicsBarriers;
+    for (const UploadBatch::TextureCopy& copy : batch->textureCopies) {
+        RfxTextureSharedState* shared = copy.dst->state;
+        RfxResourceState before = shared->Get(copy.region.mipOffset, copy.region.layerOffset);
+        if (before == RFX_STATE_COPY_DST)
+            continue;
+
+        nri::AccessBits access;
+        nri::Layout layout;
+        nri::StageBits stage;
+        GetNRIState(before, access, layout, stage);
+
+        bool onCopyQueue = before == RFX_STATE_UNDEFINED;
+        nri::TextureBarrierDesc& desc = (onCopyQueue ? copyBarriers : graphicsBarriers).emplace_back();
+        desc.texture = copy.dst->texture;
+        desc.before = { onCopyQueue ? nri::AccessBits::NONE : access, layout, onCopyQueue ? nri::StageBits::NONE : stage };
+        desc.after = { nri::AccessBits::COPY_DESTINATION, nri::Layout::COPY_DESTINATION, nri::StageBits::COPY };
+        desc.mipOffset = copy.region.mipOffset;
+        desc.mipNum = 1;
+        desc.layerOffset = copy.region.layerOffset;
+        desc.layerNum = 1;
+        desc.planes = nri::PlaneBits::ALL;
+
+        shared->Set(copy.region.mipOffset, copy.region.layerOffset, RFX_STATE_COPY_DST);
+    }
+
+    // the transition submission lands after every frame submitted so far, so waiting on it covers them too
+    nri::FenceSubmitDesc wait = { CORE.NRIFrameFence, CORE.FrameIndex, nri::StageBits::COPY };
+    if (!graphicsBarriers.empty()) {
+        if (!batch->transitionAllocator) {
+            NRI_CHECK(CORE.NRI.CreateCommandAllocator(*CORE.NRIGraphicsQueue, batch->transitionAllocator));
+            NRI_CHECK(CORE.NRI.CreateCommandBuffer(*batch->transitionAllocator, batch->transitionBuffer));
+        }
+        CORE.NRI.ResetCommandAllocator(*batch->transitionAllocator);
+        CORE.NRI.BeginCommandBuffer(*batch->transitionBuffer, nullptr);
+        nri::BarrierDesc bd = {};
+        bd.textures = graphicsBarriers.data();
+        bd.textureNum = (uint32_t)graphicsBarriers.size();
+        CORE.NRI.CmdBarrier(*batch->transitionBuffer, bd);
+        CORE.NRI.EndCommandBuffer(*batch->transitionBuffer);
+
+        wait = { CORE.UploadTransitionFence->fence, ++CORE.UploadTransitionFence->value, nri::StageBits::COPY };
+        nri::FenceSubmitDesc transitionSignal = { wait.fence, wait.value, nri::StageBits::ALL };
+        nri::QueueSubmitDesc transitionSubmit = {};
+        transitionSubmit.signalFences = &transitionSignal;
+        transitionSubmit.signalFenceNum = 1;
+        transitionSubmit.commandBuffers = &batch->transitionBuffer;
+        transitionSubmit.commandBufferNum = 1;
+        CORE.NRI.QueueSubmit(*CORE.NRIGraphicsQueue, transitionSubmit);
+    }
+
+    nri::CommandBuffer& cb = *batch->commandBuffer;
+    CORE.NRI.ResetCommandAllocator(*batch->allocator);
+    CORE.NRI.BeginCommandBuffer(cb, nullptr);
+
+    if (!copyBarriers.empty()) {
+        nri::BarrierDesc bd = {};
+        bd.textures = copyBarriers.data();
+        bd.textureNum = (uint32_t)copyBarriers.size();
+        CORE.NRI.CmdBarrier(cb, bd);
+    }
+
+    for (const UploadBatch::BufferCopy& copy : batch->bufferCopies) {
+        nri::Buffer* src = batch->staging[copy.chunk].buffer;
+        CORE.NRI.CmdCopyBuffer(cb, *copy.dst->buffer, copy.dstOffset, *src, copy.srcOffset, copy.size);
+    }
+    for (const UploadBatch::TextureCopy& copy : batch->textureCopies) {
+        nri::Buffer* src = batch->staging[copy.chunk].buffer;
+        CORE.NRI.CmdUploadBufferToTexture(cb, *copy.dst->texture, copy.region, *src, copy.layout);
+    }
+    CORE.NRI.EndCommandBuffer(cb);
+
+    // publish the copy dst states, the first list using these resolves them into its first use after waiting on the
+    // upload fence (see BarrierBatcher::Resolve)
+    batch->value = ++CORE.UploadFence->value;
+    for (const UploadBatch::BufferCopy& copy : batch->bufferCopies) {
+        copy.dst->currentState = RFX_STATE_COPY_DST;
+        copy.dst->currentAccess = nri::AccessBits::COPY_DESTINATION;
+        copy.dst->currentStage = nri::StageBits::COPY;
+        copy.dst->uploadValue = batch->value;
+    }
+    for (const UploadBatch::TextureCopy& copy : batch->textureCopies)
+        copy.dst->state->uploadValue = batch->value;
+
+    // don't overwrite anything the frames submitted so far still use
+    nri::FenceSubmitDesc signal = { CORE.UploadFence->fence, batch->value, nri::StageBits::COPY };
+    nri::QueueSubmitDesc submit = {};
+    if (wait.value > 0) {
+        submit.waitFences = &wait;
+        submit.waitFenceNum = 1;
+    }
+    submit.signalFences = &signal;
+    submit.signalFenceNum = 1;
+    submit.commandBuffers = &batch->commandBuffer;
+    submit.commandBufferNum = 1;
+    CORE.NRI.QueueSubmit(*CORE.NRICopyQueue, submit);
+
+    batch->bufferCopies.clear();
+    batch->textureCopies.clear();
+    CORE.UploadBatches.push_back(batch);
+    CORE.UploadRecording = nullptr;
+    return batch->value;
+}
+
+bool rfxIsUploadComplete(uint64_t value) {
+    return CORE.NRI.GetFenceValue(*CORE.UploadFence->fence) >= value;
+}
+
+RfxFence rfxGetUploadFence() {
+    return CORE.UploadFence;
+}
+
 RfxTexture rfxGetBackbufferTexture() {
     return &CORE.SwapChainWrapper;
 }
@@ -4279,21 +6827,21 @@ void rfxDestroyQueryPool(RfxQueryPool pool) {
 }
 
 void rfxCmdResetQueries(RfxCommandList cmd, RfxQueryPool pool, uint32_t offset, uint32_t count) {
-    CORE.NRI.CmdResetQueries(*cmd->nriCmd, *pool->pool, offset, count);
+    CORE.NRI.CmdResetQueries(cmd->Direct(), *pool->pool, offset, count);
 }
 
 void rfxCmdBeginQuery(RfxCommandList cmd, RfxQueryPool pool, uint32_t queryIndex) {
-    CORE.NRI.CmdBeginQuery(*cmd->nriCmd, *pool->pool, queryIndex);
+    CORE.NRI.CmdBeginQuery(cmd->Direct(), *pool->pool, queryIndex);
 }
 
 void rfxCmdEndQuery(RfxCommandList cmd, RfxQueryPool pool, uint32_t queryIndex) {
-    CORE.NRI.CmdEndQuery(*cmd->nriCmd, *pool->pool, queryIndex);
+    CORE.NRI.CmdEndQuery(cmd->Direct(), *pool->pool, queryIndex);
 }
 
 void rfxCmdCopyQueries(RfxCommandList cmd, RfxQueryPool pool, uint32_t offset, uint32_t count, RfxBuffer dstBuffer, uint64_t dstOffset) {
     rfxCmdTransitionBuffer(cmd, dstBuffer, RFX_STATE_COPY_DST);
     cmd->FlushBarriers();
-    CORE.NRI.CmdCopyQueries(*cmd->nriCmd, *pool->pool, offset, count, *dstBuffer->buffer, dstOffset);
+    CORE.NRI.CmdCopyQueries(cmd->Direct(), *pool->pool, offset, count, *dstBuffer->buffer, dstOffset);
 }
 
 void rfxCmdReadbackTextureToBuffer(RfxCommandList cmd, RfxTexture src, RfxBuffer dst, uint64_t dstOffset) {
@@ -4326,7 +6874,7 @@ void rfxCmdReadbackTextureToBuffer(RfxCommandList cmd, RfxTexture src, RfxBuffer
     region.depth = 1;
     region.planes = nri::PlaneBits::ALL;
 
-    CORE.NRI.CmdReadbackTextureToBuffer(*cmd->nriCmd, *dst->buffer, layout, *src->texture, region);
+    CORE.NRI.CmdReadbackTextureToBuffer(cmd->Direct(), *dst->buffer, layout, *src->texture, region);
 }
 
 void rfxSetBufferName(RfxBuffer buffer, const char* name) {
@@ -4415,7 +6963,7 @@ void rfxCmdZeroBuffer(RfxCommandList cmd, RfxBuffer buffer, size_t offset, size_
     rfxCmdTransitionBuffer(cmd, buffer, RFX_STATE_COPY_DST);
     cmd->FlushBarriers();
 
-    CORE.NRI.CmdZeroBuffer(*cmd->nriCmd, *buffer->buffer, offset, (size == 0) ? nri::WHOLE_SIZE : size);
+    CORE.NRI.CmdZeroBuffer(cmd->Direct(), *buffer->buffer, offset, (size == 0) ? nri::WHOLE_SIZE : size);
 }
 void rfxCmdResolveTexture(RfxCommandList cmd, RfxTexture dst, RfxTexture src, RfxResolveOp op) {
     if (!dst || !src)
@@ -4432,7 +6980,7 @@ void rfxCmdResolveTexture(RfxCommandList cmd, RfxTexture dst, RfxTexture src, Rf
     if (op == RFX_RESOLVE_OP_MAX)
         nriOp = nri::ResolveOp::MAX;
 
-    CORE.NRI.CmdResolveTexture(*cmd->nriCmd, *dst->texture, nullptr, *src->texture, nullptr, nriOp);
+    CORE.NRI.CmdResolveTexture(cmd->Direct(), *dst->texture, nullptr, *src->texture, nullptr, nriOp);
 }
 
 void rfxCmdCopyMicromap(RfxCommandList cmd, RfxMicromap dst, RfxMicromap src, RfxCopyMode mode) {
@@ -4469,7 +7017,7 @@ void rfxCmdCopyMicromap(RfxCommandList cmd, RfxMicromap dst, RfxMicromap src, Rf
 
     nri::CopyMode nriMode = (mode == RFX_COPY_MODE_COMPACT) ? nri::CopyMode::COMPACT : nri::CopyMode::CLONE;
 
-    CORE.NRI.CmdCopyMicromap(*cmd->nriCmd, *dstImpl->micromap, *srcImpl->micromap, nriMode);
+    CORE.NRI.CmdCopyMicromap(cmd->Direct(), *dstImpl->micromap, *srcImpl->micromap, nriMode);
 }
 
 void rfxCmdWriteAccelerationStructureSize(
@@ -4492,7 +7040,7 @@ void rfxCmdWriteAccelerationStructureSize(
         nriHandles[i] = ((RfxAccelerationStructureImpl*)asArray[i])->as;
     }
 
-    CORE.NRI.CmdWriteAccelerationStructuresSizes(*cmd->nriCmd, nriHandles.data(), count, *pool->pool, queryOffset);
+    CORE.NRI.CmdWriteAccelerationStructuresSizes(cmd->Direct(), nriHandles.data(), count, *pool->pool, queryOffset);
 }
 
 void rfxCmdCopyAccelerationStructure(RfxCommandList cmd, RfxAccelerationStructure dst, RfxAccelerationStructure src, RfxCopyMode mode) {
@@ -4513,7 +7061,7 @@ void rfxCmdCopyAccelerationStructure(RfxCommandList cmd, RfxAccelerationStructur
 
     nri::CopyMode nriMode = (mode == RFX_COPY_MODE_COMPACT) ? nri::CopyMode::COMPACT : nri::CopyMode::CLONE;
 
-    CORE.NRI.CmdCopyAccelerationStructure(*cmd->nriCmd, *dstImpl->as, *srcImpl->as, nriMode);
+    CORE.NRI.CmdCopyAccelerationStructure(cmd->Direct(), *dstImpl->as, *srcImpl->as, nriMode);
     // TODO: fix TraceRays state tracking from this point on
 }
 
@@ -4524,7 +7072,7 @@ void rfxCmdSetSampleLocations(RfxCommandList cmd, const RfxSampleLocation* locat
     static_assert(sizeof(RfxSampleLocation) == sizeof(nri::SampleLocation), "RfxSampleLocation size mismatch");
 
     CORE.NRI.CmdSetSampleLocations(
-        *cmd->nriCmd, (const nri::SampleLocation*)locations, (nri::Sample_t)locationCount, (nri::Sample_t)sampleCount
+        cmd->Direct(), (const nri::SampleLocation*)locations, (nri::Sample_t)locationCount, (nri::Sample_t)sampleCount
     );
 }
 
@@ -4688,7 +7236,7 @@ void rfxBeginFrame() {
     ProcessShaderReloads();
 
     // wait until swapchain is valid
-    while (true) {
+    while (!CORE.Headless) {
         bool hasExtent = (CORE.FramebufferWidth > 0 && CORE.FramebufferHeight > 0);
         bool active = !CORE.IsMinimized && (CORE.IsFocused || (CORE.WindowFlags & RFX_WINDOW_ALWAYS_ACTIVE));
 
@@ -4721,11 +7269,12 @@ void rfxBeginFrame() {
     int currentW = CORE.FramebufferWidth;
     int currentH = CORE.FramebufferHeight;
 
-    if (currentW > 0 && currentH > 0 && ((uint32_t)currentW != CORE.SwapChainWidth || (uint32_t)currentH != CORE.SwapChainHeight)) {
+    if (!CORE.Headless && currentW > 0 && currentH > 0 &&
+        ((uint32_t)currentW != CORE.SwapChainWidth || (uint32_t)currentH != CORE.SwapChainHeight)) {
         RecreateSwapChain(currentW, currentH);
     }
 
-    if (CORE.SwapChainWidth == 0 || CORE.SwapChainHeight == 0 || !CORE.NRISwapChain)
+    if (CORE.SwapChainWidth == 0 || CORE.SwapChainHeight == 0 || (!CORE.NRISwapChain && !CORE.Headless))
         return;
 
     if (CORE.FrameIndex >= GetQueuedFrameNum()) {
@@ -4760,9 +7309,13 @@ void rfxBeginFrame() {
     // process graveyard ...
     uint32_t frameIdx = CORE.FrameIndex % GetQueuedFrameNum();
     {
-        auto& q = CORE.Graveyard[frameIdx];
-        RfxVector<std::function<void()>> readyTasks = std::move(q.tasks);
-        q.tasks.clear();
+        RfxVector<std::function<void()>> readyTasks;
+        {
+            std::lock_guard<std::mutex> lock(CORE.GraveyardMutex);
+            auto& q = CORE.Graveyard[frameIdx];
+            readyTasks = std::move(q.tasks);
+            q.tasks.clear();
+        }
 
         for (auto& task : readyTasks)
             task();
@@ -4771,31 +7324,35 @@ void rfxBeginFrame() {
     // begin implicit commandbuffer
     QueuedFrame& qf = CORE.QueuedFrames[frameIdx];
     CORE.NRI.ResetCommandAllocator(*qf.commandAllocator);
+    BeginTransientFrame(qf, frameIdx);
 
     qf.queryCount = 0;
     qf.profileRegions.clear();
     qf.profileStack.clear();
 
     uint32_t semIdx = CORE.FrameIndex % (uint32_t)CORE.SwapChainTextures.size();
-    CORE.NRI.AcquireNextTexture(*CORE.NRISwapChain, *CORE.SwapChainTextures[semIdx].acquireSemaphore, CORE.CurrentSwapChainTextureIndex);
-
-    CORE.NRI.BeginCommandBuffer(*qf.commandBuffer, CORE.Bindless.descriptorPool);
-    CORE.NRI.CmdResetQueries(*qf.commandBuffer, *CORE.TimestampPool, frameIdx * RFX_MAX_TIMESTAMP_QUERIES, RFX_MAX_TIMESTAMP_QUERIES);
+    if (CORE.Headless)
+        CORE.CurrentSwapChainTextureIndex = semIdx; // nothing to acquire, just cycle
+    else
+        CORE.NRI.AcquireNextTexture(
+            *CORE.NRISwapChain, *CORE.SwapChainTextures[semIdx].acquireSemaphore, CORE.CurrentSwapChainTextureIndex
+        );
 
-    qf.wrapper.ResetCache();
+    // the prologue stays open until rfxEndFrame, which appends the main list's patch-up barriers
+    CORE.NRI.BeginCommandBuffer(*qf.prologueBuffer, nullptr);
+    CORE.NRI.CmdResetQueries(*qf.prologueBuffer, *CORE.TimestampPool, frameIdx * RFX_MAX_TIMESTAMP_QUERIES, RFX_MAX_TIMESTAMP_QUERIES);
 
-    // run init work ...
-    if (!CORE.PendingPreBarriers.empty() || !CORE.PendingPostBarriers.empty()) {
-        for (auto& work : CORE.PendingPreBarriers)
-            work(*qf.commandBuffer);
-        CORE.PendingPreBarriers.clear();
+    // run init work queued by any thread ...
+    {
+        std::lock_guard<std::mutex> lock(CORE.StreamerMutex);
+        if (!CORE.PendingUploads.empty())
+            CopyStreamedDataLocked(*qf.prologueBuffer);
+    }
 
-        CORE.NRI.CmdCopyStreamedData(*qf.commandBuffer, *CORE.NRIStreamer);
+    CORE.NRI.BeginCommandBuffer(*qf.commandBuffer, CORE.Bindless.descriptorPool);
 
-        for (auto& work : CORE.PendingPostBarriers)
-            work(*qf.commandBuffer);
-        CORE.PendingPostBarriers.clear();
-    }
+    qf.wrapper.ResetCache();
+    qf.wrapper.shadow.descriptorPool = CORE.Bindless.descriptorPool;
 
     qf.wrapper.isRendering = false;
     qf.wrapper.currentPipeline = nullptr;
@@ -4807,9 +7364,6 @@ void rfxBeginFrame() {
     qf.wrapper.activeColorTextures.clear();
     qf.wrapper.activeDepthTexture = nullptr;
     qf.wrapper.tempDescriptors.clear();
-    qf.wrapper.barriers.bufferBarriers.clear();
-    qf.wrapper.barriers.textureBarriers.clear();
-    qf.wrapper.barriers.globalBarriers.clear();
 
     CORE.SwapChainWrapper.texture = CORE.SwapChainTextures[CORE.CurrentSwapChainTextureIndex].texture;
     CORE.SwapChainWrapper.format = CORE.SwapChainTextures[CORE.CurrentSwapChainTextureIndex].attachmentFormat;
@@ -4821,17 +7375,25 @@ void rfxBeginFrame() {
     CORE.SwapChainWrapper.mipOffset = 0;
     CORE.SwapChainWrapper.layerOffset = 0;
 
-    if (!CORE.SwapChainWrapper.state) {
+    if (CORE.Headless) {
+        // alias the offscreen texture, its state persists across frames
+        RfxTexture bb = CORE.HeadlessBackbuffers[CORE.CurrentSwapChainTextureIndex];
+        CORE.SwapChainWrapper.state = bb->state;
+        CORE.SwapChainWrapper.descriptor = bb->descriptor;
+        CORE.SwapChainWrapper.descriptorAttachment = bb->descriptorAttachment;
+        CORE.SwapChainWrapper.bindlessIndex = bb->bindlessIndex;
+    } else if (!CORE.SwapChainWrapper.state) {
         CORE.SwapChainWrapper.state = RfxNew<RfxTextureSharedState>();
         CORE.SwapChainWrapper.state->totalMips = 1;
         CORE.SwapChainWrapper.state->totalLayers = 1;
-        CORE.SwapChainWrapper.state->subresourceStates.resize(1);
     }
 
-    if (CORE.SwapChainTextures[CORE.CurrentSwapChainTextureIndex].initialized) {
-        CORE.SwapChainWrapper.state->Set(0, 0, RFX_STATE_PRESENT);
+    if (CORE.Headless) {
+        // state is already tracked by the offscreen texture
+    } else if (CORE.SwapChainTextures[CORE.CurrentSwapChainTextureIndex].initialized) {
+        CORE.SwapChainWrapper.state->SetAll(RFX_STATE_PRESENT);
     } else {
-        CORE.SwapChainWrapper.state->Set(0, 0, RFX_STATE_UNDEFINED);
+        CORE.SwapChainWrapper.state->SetAll(RFX_STATE_UNDEFINED);
         CORE.SwapChainTextures[CORE.CurrentSwapChainTextureIndex].initialized = true;
     }
 
@@ -4839,9 +7401,8 @@ void rfxBeginFrame() {
 }
 
 void rfxEndFrame() {
-    if (!CORE.FrameStarted || !CORE.NRISwapChain)
+    if (!CORE.FrameStarted || (!CORE.NRISwapChain && !CORE.Headless))
         return;
-    CORE.FrameStarted = false;
 
     if (CORE.AllowLowLatency && CORE.LowLatencyEnabled && CORE.NRISwapChain) {
         CORE.NRI.SetLatencyMarker(*CORE.NRISwapChain, nri::LatencyMarker::SIMULATION_END);
@@ -4850,57 +7411,130 @@ void rfxEndFrame() {
     uint32_t frameIdx = CORE.FrameIndex % GetQueuedFrameNum();
     QueuedFrame& qf = CORE.QueuedFrames[frameIdx];
     RfxCommandList cmd = &qf.wrapper;
+    cmd->Direct(); // translate the deferred stream before closing the buffer
 
-    if (cmd->isRendering)
+    CORE.ElidedStateCalls += cmd->elidedCalls;
+    cmd->elidedCalls = 0;
+    CORE.RenderPassRestarts += cmd->passRestarts;
+    cmd->passRestarts = 0;
+    CORE.LastFrameStats.elidedStateCalls = CORE.ElidedStateCalls.exchange(0);
+    CORE.LastFrameStats.renderPassRestarts = CORE.RenderPassRestarts.exchange(0);
+
+    if (cmd->isRendering) {
         CORE.NRI.CmdEndRendering(*qf.commandBuffer);
+        cmd->isRendering = false;
+    }
+
+    RfxVector<RfxCommandList> queuedLists;
+    {
+        std::lock_guard<std::mutex> lock(CORE.QueuedListsMutex);
+        queuedLists = std::move(qf.queuedLists);
+        qf.queuedLists.clear();
+    }
 
-    // swapchain->present
-    cmd->barriers.RequireState(&CORE.SwapChainWrapper, RFX_STATE_PRESENT);
+    // lists are resolved in submission order, each one's first uses are patched in right before it runs
     cmd->barriers.Flush(*qf.commandBuffer);
+    uint64_t uploadValue = cmd->barriers.Resolve(*qf.prologueBuffer);
+    CORE.NRI.EndCommandBuffer(*qf.prologueBuffer);
+
+    for (RfxCommandList list : queuedLists) {
+        CORE.NRI.BeginCommandBuffer(*list->patchCmd, nullptr);
+        uploadValue = std::max(uploadValue, list->barriers.Resolve(*list->patchCmd));
+        CORE.NRI.EndCommandBuffer(*list->patchCmd);
+    }
+
+    // queued lists run after the main list, so present & timestamps move into an epilogue behind them
+    nri::CommandBuffer* tail = qf.commandBuffer;
+    if (!queuedLists.empty()) {
+        CORE.NRI.EndCommandBuffer(*qf.commandBuffer);
+        CORE.NRI.BeginCommandBuffer(*qf.epilogueBuffer, nullptr);
+        tail = qf.epilogueBuffer;
+    }
+
+    // swapchain->present (headless: ->copy src, ready for readback). As a first use, resolving it transitions from
+    // whatever the lists above left behind
+    cmd->barriers.RequireState(&CORE.SwapChainWrapper, CORE.Headless ? RFX_STATE_COPY_SRC : RFX_STATE_PRESENT);
+    cmd->barriers.Resolve(*tail);
+
+    // copy-queue uploads the frame touches must land before any of it runs
+    nri::FenceSubmitDesc uploadWait = {};
+    bool waitForUploads = GetUploadWait(uploadValue, uploadWait);
 
     if (qf.queryCount > 0) {
         CORE.NRI.CmdCopyQueries(
-            *qf.commandBuffer, *CORE.TimestampPool, frameIdx * RFX_MAX_TIMESTAMP_QUERIES, qf.queryCount, *CORE.TimestampBuffer,
+            *tail, *CORE.TimestampPool, frameIdx * RFX_MAX_TIMESTAMP_QUERIES, qf.queryCount, *CORE.TimestampBuffer,
             (frameIdx * RFX_MAX_TIMESTAMP_QUERIES) * sizeof(uint64_t)
         );
     }
 
-    CORE.NRI.EndCommandBuffer(*qf.commandBuffer);
+    CORE.NRI.EndCommandBuffer(*tail);
+
+    RfxVector<nri::CommandBuffer*> commandBuffers;
+    commandBuffers.push_back(qf.prologueBuffer);
+    commandBuffers.push_back(qf.commandBuffer);
+    for (RfxCommandList list : queuedLists) {
+        commandBuffers.push_back(list->patchCmd);
+        commandBuffers.push_back(list->nriCmd);
+    }
+    if (tail != qf.commandBuffer)
+        commandBuffers.push_back(tail);
 
     if (CORE.AllowLowLatency && CORE.LowLatencyEnabled && CORE.NRISwapChain) {
         CORE.NRI.SetLatencyMarker(*CORE.NRISwapChain, nri::LatencyMarker::RENDER_SUBMIT_START);
     }
 
-    SwapChainTexture& sc = CORE.SwapChainTextures[CORE.CurrentSwapChainTextureIndex];
-    nri::FenceSubmitDesc wait = { CORE.SwapChainTextures[CORE.FrameIndex % CORE.SwapChainTextures.size()].acquireSemaphore, 0,
-                                  nri::StageBits::COLOR_ATTACHMENT };
-    nri::FenceSubmitDesc signal = { sc.releaseSemaphore, 0, nri::StageBits::NONE };
-    nri::QueueSubmitDesc submit = {};
-    submit.waitFences = &wait;
-    submit.waitFenceNum = 1;
-    submit.signalFences = &signal;
-    submit.signalFenceNum = 1;
-    submit.commandBuffers = &qf.commandBuffer;
-    submit.commandBufferNum = 1;
+    if (CORE.Headless) {
+        // no acquire/present, the frame fence below is the only sync
+        nri::QueueSubmitDesc submit = {};
+        if (waitForUploads) {
+            submit.waitFences = &uploadWait;
+            submit.waitFenceNum = 1;
+        }
+        submit.commandBuffers = commandBuffers.data();
+        submit.commandBufferNum = (uint32_t)commandBuffers.size();
+        CORE.NRI.QueueSubmit(*CORE.NRIGraphicsQueue, submit);
+    } else {
+        SwapChainTexture& sc = CORE.SwapChainTextures[CORE.CurrentSwapChainTextureIndex];
+        nri::Fence* acquireSemaphore = CORE.SwapChainTextures[CORE.FrameIndex % CORE.SwapChainTextures.size()].acquireSemaphore;
+        nri::FenceSubmitDesc waits[2] = { { acquireSemaphore, 0, nri::StageBits::COLOR_ATTACHMENT }, uploadWait };
+        nri::FenceSubmitDesc signal = { sc.releaseSemaphore, 0, nri::StageBits::NONE };
+        nri::QueueSubmitDesc submit = {};
+        submit.waitFences = waits;
+        submit.waitFenceNum = waitForUploads ? 2 : 1;
+        submit.signalFences = &signal;
+        submit.signalFenceNum = 1;
+        submit.commandBuffers = commandBuffers.data();
+        submit.commandBufferNum = (uint32_t)commandBuffers.size();
+
+        if (CORE.AllowLowLatency && CORE.LowLatencyEnabled) {
+            submit.swapChain = CORE.NRISwapChain;
+        }
 
-    if (CORE.AllowLowLatency && CORE.LowLatencyEnabled) {
-        submit.swapChain = CORE.NRISwapChain;
-    }
+        CORE.NRI.QueueSubmit(*CORE.NRIGraphicsQueue, submit);
 
-    CORE.NRI.QueueSubmit(*CORE.NRIGraphicsQueue, submit);
+        if (CORE.AllowLowLatency && CORE.LowLatencyEnabled && CORE.NRISwapChain) {
+            CORE.NRI.SetLatencyMarker(*CORE.NRISwapChain, nri::LatencyMarker::RENDER_SUBMIT_END);
+        }
 
-    if (CORE.AllowLowLatency && CORE.LowLatencyEnabled && CORE.NRISwapChain) {
-        CORE.NRI.SetLatencyMarker(*CORE.NRISwapChain, nri::LatencyMarker::RENDER_SUBMIT_END);
+        CORE.NRI.QueuePresent(*CORE.NRISwapChain, *sc.releaseSemaphore);
     }
 
-    CORE.NRI.QueuePresent(*CORE.NRISwapChain, *sc.releaseSemaphore);
-
     nri::FenceSubmitDesc frameSig = { CORE.NRIFrameFence, 1 + CORE.FrameIndex, nri::StageBits::NONE };
     nri::QueueSubmitDesc frameSub = {};
     frameSub.signalFences = &frameSig;
     frameSub.signalFenceNum = 1;
     CORE.NRI.QueueSubmit(*CORE.NRIGraphicsQueue, frameSub);
 
-    CORE.NRI.EndStreamerFrame(*CORE.NRIStreamer);
-    CORE.FrameIndex++;
+    {
+        std::lock_guard<std::mutex> lock(CORE.StreamerMutex);
+        CORE.NRI.EndStreamerFrame(*CORE.NRIStreamer);
+        CORE.NRI.EndStreamerFrame(*CORE.NRIListStreamer);
+    }
+
+    // until now destroys from other threads still land in this frame's graveyard slot
+    {
+        std::lock_guard<std::mutex> lock(CORE.GraveyardMutex);
+        CORE.FrameIndex++;
+        CORE.FrameStarted = false;
+    }
 }
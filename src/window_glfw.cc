@@ -84,6 +84,22 @@ static void FramebufferSizeCallback(GLFWwindow* window, int width, int height) {
 //
 
 static GLFWcursor* g_Cursors[RFX_CURSOR_COUNT] = { nullptr };
+static uint32_t g_GlfwRefs = 0; // windows of all contexts, GLFW and the cursors are process-wide
+
+static void ReleaseGlfw() {
+    if (--g_GlfwRefs > 0)
+        return;
+
+    // cleanup cursors
+    for (int i = 0; i < RFX_CURSOR_COUNT; i++) {
+        if (g_Cursors[i]) {
+            glfwDestroyCursor(g_Cursors[i]);
+            g_Cursors[i] = nullptr;
+        }
+    }
+
+    glfwTerminate();
+}
 
 void Backend_EventSleep() {
     glfwWaitEvents();
@@ -136,17 +152,20 @@ static bool Win32_SystemIsDarkMode(void) {
 // clang-format on
 
 bool Backend_CreateWindow(const char* title, int width, int height) {
-    glfwSetErrorCallback(GLFW_ErrorCallback);
-
-    GLFWallocator allocator;
-    allocator.allocate = GlfwAllocWrapper;
-    allocator.reallocate = GlfwReallocWrapper;
-    allocator.deallocate = GlfwFreeWrapper;
-    allocator.user = nullptr;
-    glfwInitAllocator(&allocator);
-
-    if (!glfwInit())
-        return false;
+    if (g_GlfwRefs == 0) {
+        glfwSetErrorCallback(GLFW_ErrorCallback);
+
+        GLFWallocator allocator;
+        allocator.allocate = GlfwAllocWrapper;
+        allocator.reallocate = GlfwReallocWrapper;
+        allocator.deallocate = GlfwFreeWrapper;
+        allocator.user = nullptr;
+        glfwInitAllocator(&allocator);
+
+        if (!glfwInit())
+            return false;
+    }
+    g_GlfwRefs++;
 
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
 
@@ -159,7 +178,7 @@ bool Backend_CreateWindow(const char* title, int width, int height) {
 
     GLFWwindow* win = glfwCreateWindow(width, height, title, monitor, nullptr);
     if (!win) {
-        glfwTerminate();
+        ReleaseGlfw();
         return false;
     }
     CORE.WindowHandle = win;
@@ -230,20 +249,12 @@ bool Backend_CreateWindow(const char* title, int width, int height) {
 
 void Backend_DestroyWindow() {
     GLFWwindow* win = (GLFWwindow*)CORE.WindowHandle;
-    if (win) {
-        glfwDestroyWindow(win);
-        CORE.WindowHandle = nullptr;
-    }
-
-    // cleanup cursors
-    for (int i = 0; i < RFX_CURSOR_COUNT; i++) {
-        if (g_Cursors[i]) {
-            glfwDestroyCursor(g_Cursors[i]);
-            g_Cursors[i] = nullptr;
-        }
-    }
+    if (!win)
+        return;
 
-    glfwTerminate();
+    glfwDestroyWindow(win);
+    CORE.WindowHandle = nullptr;
+    ReleaseGlfw();
 }
 
 void Backend_SetWindowFlags(RfxWindowFlags flags) {
@@ -12,6 +12,7 @@
 static SDL_Cursor* g_Cursors[RFX_CURSOR_COUNT] = { nullptr };
 static bool g_ShouldClose = false;
 static uint64_t g_Frequency = 0;
+static uint32_t g_SdlRefs = 0; // windows of all contexts, SDL and the cursors are process-wide
 
 //
 // Utils
@@ -110,14 +111,32 @@ static void SDLCALL SdlFreeWrapper(void* mem) {
     RfxFree(mem);
 }
 
-bool Backend_CreateWindow(const char* title, int width, int height) {
-    SDL_SetMemoryFunctions(SdlAllocWrapper, SdlCallocWrapper, SdlReallocWrapper, SdlFreeWrapper);
-    if (!SDL_Init(SDL_INIT_VIDEO)) {
-        printf("[Rafx] SDL_Init Failed: %s\n", SDL_GetError());
-        return false;
+static void ReleaseSdl() {
+    if (--g_SdlRefs > 0)
+        return;
+
+    // cleanup cursors
+    for (int i = 0; i < RFX_CURSOR_COUNT; i++) {
+        if (g_Cursors[i]) {
+            SDL_DestroyCursor(g_Cursors[i]);
+            g_Cursors[i] = nullptr;
+        }
     }
 
-    g_Frequency = SDL_GetPerformanceFrequency();
+    SDL_Quit();
+}
+
+bool Backend_CreateWindow(const char* title, int width, int height) {
+    if (g_SdlRefs == 0) {
+        SDL_SetMemoryFunctions(SdlAllocWrapper, SdlCallocWrapper, SdlReallocWrapper, SdlFreeWrapper);
+        if (!SDL_Init(SDL_INIT_VIDEO)) {
+            printf("[Rafx] SDL_Init Failed: %s\n", SDL_GetError());
+            return false;
+        }
+
+        g_Frequency = SDL_GetPerformanceFrequency();
+    }
+    g_SdlRefs++;
 
     SDL_WindowFlags sdlFlags = 0;
 
@@ -142,7 +161,7 @@ bool Backend_CreateWindow(const char* title, int width, int height) {
     SDL_Window* win = SDL_CreateWindow(title, width, height, sdlFlags);
     if (!win) {
         printf("[Rafx] SDL3 SDL_CreateWindow Failed: %s\n", SDL_GetError());
-        SDL_Quit();
+        ReleaseSdl();
         return false;
     }
 
@@ -189,21 +208,13 @@ bool Backend_CreateWindow(const char* title, int width, int height) {
 
 void Backend_DestroyWindow() {
     SDL_Window* win = (SDL_Window*)CORE.WindowHandle;
-    if (win) {
-        SDL_StopTextInput(win);
-        SDL_DestroyWindow(win);
-        CORE.WindowHandle = nullptr;
-    }
-
-    // cleanup cursors
-    for (int i = 0; i < RFX_CURSOR_COUNT; i++) {
-        if (g_Cursors[i]) {
-            SDL_DestroyCursor(g_Cursors[i]);
-            g_Cursors[i] = nullptr;
-        }
-    }
+    if (!win)
+        return;
 
-    SDL_Quit();
+    SDL_StopTextInput(win);
+    SDL_DestroyWindow(win);
+    CORE.WindowHandle = nullptr;
+    ReleaseSdl();
 }
 
 void Backend_SetWindowFlags(RfxWindowFlags flags) {